@@ -0,0 +1,357 @@
+
+// CODESTYLE: v2.0
+
+// RenderBenchmark.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: Render Benchmark Program Entry Point
+
+/**
+ * @file RenderBenchmark.cpp
+ * @brief Render Benchmark Program Entry Point
+ * @author Richard Marks <ccpsceo@gmail.com>
+ *
+ * Walks a scripted route through maps of several sizes, renders every step
+ * headlessly and writes the frame statistics as JSON for regression tracking.
+ *
+ * Usage: BenchExe [--maps mockup,16,64,256] [--steps N] [--seed N] [--walk FBLR<>] [--output FILE]
+ */
+
+#include "lwc.h"
+#include <new>
+
+////////////////////////////////////////////////////////////////////////////////
+
+LOFI::Engine* LOFI::globalEngineInstance = 0;
+
+// the number of C++ heap allocations made so far by the whole program
+static unsigned long allocationCount = 0;
+
+// the results of benchmarking one map
+struct BenchmarkResult
+{
+	std::string mapName_;
+	int mapWidth_;
+	int mapHeight_;
+	int frames_;
+	double meanMicroseconds_;
+	double p50Microseconds_;
+	double p99Microseconds_;
+	double maxMicroseconds_;
+	double pixelsPerFrame_;
+	double allocationsPerFrame_;
+};
+
+bool ParseBenchmarkCommandLine(int argc, char* argv[]);
+bool RunBenchmark(LOFI::Engine* engine, const std::string& mapName, BenchmarkResult* result);
+char GetNextWalkStep(LOFI::GameState* gameState, int stepNumber, char previousStep);
+void TakeWalkStep(LOFI::Engine* engine, char step);
+void WriteResults(FILE* fp, const std::vector<BenchmarkResult>& results);
+
+// the benchmark configuration
+static std::vector<std::string> benchmarkMaps;
+static int benchmarkSteps = 500;
+static unsigned int benchmarkSeed = 1;
+static const char* benchmarkWalk = 0;
+static const char* benchmarkOutputPath = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if __cplusplus >= 201103L
+	#define BENCH_NOTHROW noexcept
+#else
+	#define BENCH_NOTHROW throw()
+#endif
+
+void* operator new(std::size_t size)
+#if __cplusplus < 201103L
+	throw(std::bad_alloc)
+#endif
+{
+	allocationCount++;
+
+	void* memory = malloc((size) ? size : 1);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void* memory) BENCH_NOTHROW
+{
+	free(memory);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+	atexit(SDL_Quit);
+
+	if (!ParseBenchmarkCommandLine(argc, argv))
+	{
+		WriteLog(stderr, "Usage: %s [--maps mockup,16,64,256] [--steps N] [--seed N] [--walk FBLR<>] [--output FILE]\n", argv[0]);
+		return 1;
+	}
+
+	// the benchmark always renders off-screen
+	char engineName[] = "BenchExe";
+	char headlessOption[] = "--headless";
+	char* engineArgv[] = { engineName, headlessOption, 0 };
+
+	LOFI::Engine engine;
+	LOFI::globalEngineInstance = &engine;
+
+	if (!engine.Initialize(2, engineArgv))
+	{
+		WriteLog(stderr, "Engine Initialization Failed!\n");
+		return 1;
+	}
+
+	std::vector<BenchmarkResult> results;
+	bool succeeded = true;
+
+	for (unsigned int index = 0; index < benchmarkMaps.size(); index++)
+	{
+		BenchmarkResult result;
+		if (!RunBenchmark(&engine, benchmarkMaps[index], &result))
+		{
+			succeeded = false;
+			break;
+		}
+		results.push_back(result);
+	}
+
+	engine.Destroy();
+
+	if (!succeeded)
+	{
+		return 1;
+	}
+
+	FILE* fp = (benchmarkOutputPath) ? fopen(benchmarkOutputPath, "w") : stdout;
+	if (!fp)
+	{
+		WriteLog(stderr, "Unable to open \"%s\" for writing!\n", benchmarkOutputPath);
+		return 1;
+	}
+
+	WriteResults(fp, results);
+
+	if (fp != stdout)
+	{
+		fclose(fp);
+	}
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ParseBenchmarkCommandLine(int argc, char* argv[])
+{
+	const char* mapList = "mockup,16,64,256";
+
+	for (int index = 1; index < argc; index++)
+	{
+		if (0 == strcmp(argv[index], "--maps") && index + 1 < argc)
+		{
+			mapList = argv[++index];
+		}
+		else if (0 == strcmp(argv[index], "--steps") && index + 1 < argc)
+		{
+			benchmarkSteps = atoi(argv[++index]);
+		}
+		else if (0 == strcmp(argv[index], "--seed") && index + 1 < argc)
+		{
+			benchmarkSeed = static_cast<unsigned int>(strtoul(argv[++index], 0, 10));
+		}
+		else if (0 == strcmp(argv[index], "--walk") && index + 1 < argc)
+		{
+			benchmarkWalk = argv[++index];
+		}
+		else if (0 == strcmp(argv[index], "--output") && index + 1 < argc)
+		{
+			benchmarkOutputPath = argv[++index];
+		}
+		else
+		{
+			WriteLog(stderr, "Unknown command line option \"%s\"!\n", argv[index]);
+			return false;
+		}
+	}
+
+	// split the comma separated map list
+	std::string maps(mapList);
+	std::string::size_type start = 0;
+	while (start <= maps.size())
+	{
+		std::string::size_type end = maps.find(',', start);
+		if (std::string::npos == end)
+		{
+			end = maps.size();
+		}
+
+		if (end > start)
+		{
+			benchmarkMaps.push_back(maps.substr(start, end - start));
+		}
+		start = end + 1;
+	}
+
+	return (benchmarkSteps > 0 && !benchmarkMaps.empty() && (!benchmarkWalk || *benchmarkWalk));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool RunBenchmark(LOFI::Engine* engine, const std::string& mapName, BenchmarkResult* result)
+{
+	LOFI::GameState* gameState = engine->GetGameState();
+
+	// "mockup" is the hand-built map, a number N is an N x N random maze
+	if ("mockup" == mapName)
+	{
+		gameState->StartNewGame();
+	}
+	else
+	{
+		int size = atoi(mapName.c_str());
+		if (size < 2)
+		{
+			WriteLog(stderr, "Invalid map \"%s\" - expected \"mockup\" or a size of at least 2!\n", mapName.c_str());
+			return false;
+		}
+		gameState->StartNewGame(size, size, benchmarkSeed);
+	}
+
+	// draw one frame up front so first-use costs don't skew the numbers
+	engine->RenderFrame();
+
+	std::vector<LOFI::Microseconds> frameTimes;
+	frameTimes.reserve(benchmarkSteps);
+
+	unsigned long totalPixels = 0;
+	unsigned long totalAllocations = 0;
+	char previousStep = 0;
+
+	for (int stepNumber = 0; stepNumber < benchmarkSteps; stepNumber++)
+	{
+		previousStep = GetNextWalkStep(gameState, stepNumber, previousStep);
+		TakeWalkStep(engine, previousStep);
+
+		LOFI::Engine::ResetPixelsWritten();
+		unsigned long allocationsBefore = allocationCount;
+		LOFI::Microseconds frameStart = LOFI::Clock::GetMicroseconds();
+
+		engine->RenderFrame();
+
+		frameTimes.push_back(LOFI::Clock::GetMicroseconds() - frameStart);
+		totalAllocations += allocationCount - allocationsBefore;
+		totalPixels += LOFI::Engine::GetPixelsWritten();
+	}
+
+	LOFI::Microseconds totalTime = 0;
+	for (unsigned int index = 0; index < frameTimes.size(); index++)
+	{
+		totalTime += frameTimes[index];
+	}
+
+	std::sort(frameTimes.begin(), frameTimes.end());
+
+	int frames = static_cast<int>(frameTimes.size());
+
+	result->mapName_ 				= mapName;
+	result->mapWidth_ 				= gameState->GetCurrentMap()->GetWidth();
+	result->mapHeight_ 				= gameState->GetCurrentMap()->GetHeight();
+	result->frames_ 				= frames;
+	result->meanMicroseconds_ 		= static_cast<double>(totalTime) / frames;
+	result->p50Microseconds_ 		= static_cast<double>(frameTimes[(frames * 50) / 100]);
+	result->p99Microseconds_ 		= static_cast<double>(frameTimes[(frames * 99) / 100]);
+	result->maxMicroseconds_ 		= static_cast<double>(frameTimes[frames - 1]);
+	result->pixelsPerFrame_ 		= static_cast<double>(totalPixels) / frames;
+	result->allocationsPerFrame_ 	= static_cast<double>(totalAllocations) / frames;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+char GetNextWalkStep(LOFI::GameState* gameState, int stepNumber, char previousStep)
+{
+	// replay the scripted walk if we were given one
+	if (benchmarkWalk)
+	{
+		return benchmarkWalk[stepNumber % strlen(benchmarkWalk)];
+	}
+
+	// otherwise follow the right hand wall, which eventually visits every cell of a maze
+	LOFI::Map* currentMap = gameState->GetCurrentMap();
+	LOFI::Position probe(0, 0, 0);
+
+	// having just turned right into an opening, step through it
+	if ('R' == previousStep)
+	{
+		return 'F';
+	}
+
+	probe.Copy(gameState->GetPlayerPosition());
+	probe.facing_ = (probe.facing_ + 1) % 4;
+	if (currentMap->CanPassWallForCoordinate(&probe))
+	{
+		return 'R';
+	}
+
+	probe.Copy(gameState->GetPlayerPosition());
+	if (currentMap->CanPassWallForCoordinate(&probe))
+	{
+		return 'F';
+	}
+
+	return 'L';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TakeWalkStep(LOFI::Engine* engine, char step)
+{
+	LOFI::GameState* gameState = engine->GetGameState();
+
+	switch(step)
+	{
+		case 'F': { engine->SetActionMessage(gameState->MovePlayerForward() ? "Moved Forward..." : "That way is blocked!"); } break;
+		case 'B': { engine->SetActionMessage(gameState->MovePlayerBack() ? "Moved Back..." : "That way is blocked!"); } break;
+		case '<': { engine->SetActionMessage(gameState->MovePlayerLeft() ? "Stepped Left..." : "That way is blocked!"); } break;
+		case '>': { engine->SetActionMessage(gameState->MovePlayerRight() ? "Stepped Right..." : "That way is blocked!"); } break;
+		case 'L': { gameState->TurnPlayerLeft(); engine->SetActionMessage("Turned Left..."); } break;
+		case 'R': { gameState->TurnPlayerRight(); engine->SetActionMessage("Turned Right..."); } break;
+		default: break;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WriteResults(FILE* fp, const std::vector<BenchmarkResult>& results)
+{
+	fprintf(fp, "{\n");
+	fprintf(fp, "\t\"benchmark\": \"render\",\n");
+	fprintf(fp, "\t\"steps\": %d,\n", benchmarkSteps);
+	fprintf(fp, "\t\"seed\": %u,\n", benchmarkSeed);
+	fprintf(fp, "\t\"results\": [\n");
+
+	for (unsigned int index = 0; index < results.size(); index++)
+	{
+		const BenchmarkResult& result = results[index];
+
+		fprintf(fp, "\t\t{ \"map\": \"%s\", \"width\": %d, \"height\": %d, \"frames\": %d, "
+			"\"mean_us\": %.1f, \"p50_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f, "
+			"\"pixels_per_frame\": %.1f, \"allocations_per_frame\": %.2f }%s\n",
+			result.mapName_.c_str(), result.mapWidth_, result.mapHeight_, result.frames_,
+			result.meanMicroseconds_, result.p50Microseconds_, result.p99Microseconds_, result.maxMicroseconds_,
+			result.pixelsPerFrame_, result.allocationsPerFrame_,
+			(index + 1 < results.size()) ? "," : "");
+	}
+
+	fprintf(fp, "\t]\n");
+	fprintf(fp, "}\n");
+}
@@ -0,0 +1,222 @@
+
+// CODESTYLE: v2.0
+
+// TextBenchmark.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: Text Benchmark Program Entry Point
+
+/**
+ * @file TextBenchmark.cpp
+ * @brief Text Benchmark Program Entry Point
+ * @author Richard Marks <ccpsceo@gmail.com>
+ *
+ * Times the HUD's lines of text built with printf-style formatting against the
+ * same lines built with a TextFormatter, both on their own and printed with the
+ * default font, and writes the time per set of lines as JSON.
+ *
+ * Usage: TextBenchExe [--iterations N] [--output FILE]
+ */
+
+#include "lwc.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+LOFI::Engine* LOFI::globalEngineInstance = 0;
+
+// the result of timing one way of building the HUD text
+struct TextBenchmarkResult
+{
+	const char* name_;
+	double nanosecondsPerIteration_;
+};
+
+// builds or prints one set of HUD lines for the iteration number
+typedef void (*TextBenchmarkCase)(LOFI::BitmapFont* font, SDL_Surface* screen, int iteration);
+
+bool ParseTextBenchmarkCommandLine(int argc, char* argv[]);
+TextBenchmarkResult RunTextBenchmark(const char* name, TextBenchmarkCase benchmarkCase, LOFI::BitmapFont* font, SDL_Surface* screen);
+void FormatWithPrintf(LOFI::BitmapFont* font, SDL_Surface* screen, int iteration);
+void FormatWithFormatter(LOFI::BitmapFont* font, SDL_Surface* screen, int iteration);
+void PrintWithPrintf(LOFI::BitmapFont* font, SDL_Surface* screen, int iteration);
+void PrintWithFormatter(LOFI::BitmapFont* font, SDL_Surface* screen, int iteration);
+
+// the benchmark configuration
+static int benchmarkIterations = 200000;
+static const char* benchmarkOutputPath = 0;
+
+// the lengths of the lines built, so the formatting cannot be optimized away
+static volatile unsigned int formattedLength = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+	atexit(SDL_Quit);
+
+	if (!ParseTextBenchmarkCommandLine(argc, argv))
+	{
+		WriteLog(stderr, "Usage: %s [--iterations N] [--output FILE]\n", argv[0]);
+		return 1;
+	}
+
+	// the benchmark always renders off-screen
+	char engineName[] = "TextBenchExe";
+	char headlessOption[] = "--headless";
+	char* engineArgv[] = { engineName, headlessOption, 0 };
+
+	LOFI::Engine engine;
+	LOFI::globalEngineInstance = &engine;
+
+	if (!engine.Initialize(2, engineArgv))
+	{
+		WriteLog(stderr, "Engine Initialization Failed!\n");
+		return 1;
+	}
+
+	LOFI::BitmapFont* font = engine.GetDefaultBitmapFont();
+	SDL_Surface* screen = engine.GetScreen();
+
+	std::vector<TextBenchmarkResult> results;
+	results.push_back(RunTextBenchmark("format printf", FormatWithPrintf, font, screen));
+	results.push_back(RunTextBenchmark("format formatter", FormatWithFormatter, font, screen));
+	results.push_back(RunTextBenchmark("print printf", PrintWithPrintf, font, screen));
+	results.push_back(RunTextBenchmark("print formatter", PrintWithFormatter, font, screen));
+
+	engine.Destroy();
+
+	FILE* fp = (benchmarkOutputPath) ? fopen(benchmarkOutputPath, "w") : stdout;
+	if (!fp)
+	{
+		WriteLog(stderr, "Unable to open \"%s\" for writing!\n", benchmarkOutputPath);
+		return 1;
+	}
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "\t\"benchmark\": \"text\",\n");
+	fprintf(fp, "\t\"iterations\": %d,\n", benchmarkIterations);
+	fprintf(fp, "\t\"results\": [\n");
+
+	for (unsigned int index = 0; index < results.size(); index++)
+	{
+		fprintf(fp, "\t\t{ \"case\": \"%s\", \"ns_per_iteration\": %.1f }%s\n",
+			results[index].name_,
+			results[index].nanosecondsPerIteration_,
+			(index + 1 < results.size()) ? "," : "");
+	}
+
+	fprintf(fp, "\t]\n");
+	fprintf(fp, "}\n");
+
+	if (fp != stdout)
+	{
+		fclose(fp);
+	}
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ParseTextBenchmarkCommandLine(int argc, char* argv[])
+{
+	for (int index = 1; index < argc; index++)
+	{
+		if (0 == strcmp(argv[index], "--iterations") && index + 1 < argc)
+		{
+			benchmarkIterations = atoi(argv[++index]);
+		}
+		else if (0 == strcmp(argv[index], "--output") && index + 1 < argc)
+		{
+			benchmarkOutputPath = argv[++index];
+		}
+		else
+		{
+			WriteLog(stderr, "Unknown command line option \"%s\"!\n", argv[index]);
+			return false;
+		}
+	}
+
+	return benchmarkIterations > 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TextBenchmarkResult RunTextBenchmark(const char* name, TextBenchmarkCase benchmarkCase, LOFI::BitmapFont* font, SDL_Surface* screen)
+{
+	// once through first, so every case starts warm
+	benchmarkCase(font, screen, 0);
+
+	LOFI::Microseconds start = LOFI::Clock::GetMicroseconds();
+
+	for (int iteration = 0; iteration < benchmarkIterations; iteration++)
+	{
+		benchmarkCase(font, screen, iteration);
+	}
+
+	LOFI::Microseconds elapsed = LOFI::Clock::GetMicroseconds() - start;
+
+	TextBenchmarkResult result;
+	result.name_ = name;
+	result.nanosecondsPerIteration_ = (static_cast<double>(elapsed) * 1000.0) / benchmarkIterations;
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FormatWithPrintf(LOFI::BitmapFont* font, SDL_Surface* screen, int iteration)
+{
+	// what BitmapFont::Print() does with its format before it prints anything
+	char textBuffer[LOFI::BITFNT_MAX_STRING_LENGTH];
+
+	snprintf(textBuffer, sizeof(textBuffer), "Player X: %2d", iteration & 0x3F);
+	formattedLength = formattedLength + strlen(textBuffer);
+
+	snprintf(textBuffer, sizeof(textBuffer), "Player Z: %2d", (iteration >> 6) & 0x3F);
+	formattedLength = formattedLength + strlen(textBuffer);
+
+	snprintf(textBuffer, sizeof(textBuffer), "You are facing %s.", LOFI::TextFormatter::GetDirectionName(iteration & 0x3));
+	formattedLength = formattedLength + strlen(textBuffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FormatWithFormatter(LOFI::BitmapFont* font, SDL_Surface* screen, int iteration)
+{
+	LOFI::TextFormatter line;
+
+	line.Clear() << "Player X: " << LOFI::Padded(iteration & 0x3F, 2);
+	formattedLength = formattedLength + line.GetLength();
+
+	line.Clear() << "Player Z: " << LOFI::Padded((iteration >> 6) & 0x3F, 2);
+	formattedLength = formattedLength + line.GetLength();
+
+	line.Clear() << "You are facing " << LOFI::Direction(iteration & 0x3) << '.';
+	formattedLength = formattedLength + line.GetLength();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PrintWithPrintf(LOFI::BitmapFont* font, SDL_Surface* screen, int iteration)
+{
+	font->Print(screen, 8, screen->h - 34, "Player X: %2d", iteration & 0x3F);
+	font->Print(screen, 8, screen->h - 25, "Player Z: %2d", (iteration >> 6) & 0x3F);
+	font->Print(screen, 8, screen->h - 16, "You are facing %s.", LOFI::TextFormatter::GetDirectionName(iteration & 0x3));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PrintWithFormatter(LOFI::BitmapFont* font, SDL_Surface* screen, int iteration)
+{
+	LOFI::TextFormatter line;
+
+	line.Clear() << "Player X: " << LOFI::Padded(iteration & 0x3F, 2);
+	font->PrintText(screen, 8, screen->h - 34, line.GetText(), line.GetLength());
+
+	line.Clear() << "Player Z: " << LOFI::Padded((iteration >> 6) & 0x3F, 2);
+	font->PrintText(screen, 8, screen->h - 25, line.GetText(), line.GetLength());
+
+	line.Clear() << "You are facing " << LOFI::Direction(iteration & 0x3) << '.';
+	font->PrintText(screen, 8, screen->h - 16, line.GetText(), line.GetLength());
+}
+
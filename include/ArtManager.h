@@ -15,24 +15,62 @@
 #ifndef __ARTMANAGER_H__
 #define __ARTMANAGER_H__
 
+#include <string>
 #include <vector>
 
+// the manifest that lists the wall sets
+#define ART_DEFAULT_MANIFEST_PATH "resources/walls.txt"
+
 namespace LOFI
 {
+	class AssetLoader;
+	class ThreadPool;
+	class Map;
+	class Position;
+
+	/// the most memory the loaded wall sets may use before the least recently used are unloaded
+	const unsigned long ART_DEFAULT_MEMORY_BUDGET = 32 * 1024 * 1024;
+
+	/// how many cells around the player Prefetch() looks for walls in
+	const int ART_PREFETCH_RADIUS = 4;
+
+	/// the size of the view the wall images are drawn into, see MapView
+	const int ART_VIEW_WIDTH = 300;
+	const int ART_VIEW_HEIGHT = 400;
+
+	/// the number of ranges the view has a place for the walls of
+	const int ART_VIEW_DEPTH = 3;
+
+	/// the highest wall id a manifest may use, so a typo cannot make the table huge
+	const unsigned int ART_MAX_WALL_ID = 0xFFFF;
+
+	/// the most ranges a wall set may have images for
+	const int ART_MAX_VISIBLE_DEPTH = 0x10;
+
 	/**
 	 * @class ArtManager
 	 * @brief C++ port of Java public class com.scrimisms.LofiWanderings.ArtManager
+	 *
+	 * The wall sets are listed by id in a manifest, see LoadManifest().
+	 * They are registered up front but only loaded the first time they
+	 * are asked for, or in the background by Prefetch() when they show up near the
+	 * player. The loaded sets are kept on a least recently used list, and once they
+	 * use more memory than the budget the oldest are unloaded again, except for any
+	 * set drawn in the current frame. A loaded set whose art is edited is rebuilt
+	 * in the background too, and drawn as it was until the new one is ready.
 	 */
 	class ArtManager
 	{
 	public:
 		
-		ArtManager();
+		/// constructor - prefetched wall sets are decoded on @a threadPool, if there is one
+		ArtManager(ThreadPool* threadPool = 0);
 		
 		~ArtManager();
 		
 		bool DidArtLoadSuccessfully() const;
 		
+		/// gets wall set @a which, loading it if it is not loaded; null if there is no such set
 		WallSpriteSet* GetWallSetNumber(unsigned int which);
 		
 		float GetXOffsetCenter(int range, int offset);
@@ -47,17 +85,137 @@ namespace LOFI
 		
 		float GetYOffsetRight(int range, int offset);
 		
+		/// registers the wall sets listed in the default manifest; nothing is loaded until it is needed
 		bool LoadArt();
 		
+		/**
+		 * @brief registers the wall sets listed in the manifest at @a manifestPath
+		 *
+		 * Each line of the manifest is one of:
+		 *   wall <id> <depth> <directory>   - a set of f<range>.png, l<range>.png and r<range>.png files
+		 *   atlas <id> <depth> <sheet>      - a set cut from one sheet image, followed by
+		 *   <f|l|r><range> <x> <y> <w> <h>  - the rectangle of each of its images on the sheet
+		 *   texture <id> <depth> <image>    - a set generated from one square texture
+		 * Everything after a # is a comment.
+		 * @return true if the whole manifest was read without errors
+		 */
+		bool LoadManifest(const char* manifestPath);
+		
+		/// registers wall set @a which to be loaded as @a definition describes when it is needed
+		void RegisterWallSet(unsigned int which, const WallSetDefinition& definition);
+		
+		/// marks the start of a frame; wall sets used during the frame are safe from eviction until the next one
+		void BeginFrame();
+		
+		/**
+		 * @brief starts loading, in the background, the wall sets within @a radius cells of @a position
+		 * @note call once in a while from the main thread; it also installs any sets that have finished decoding
+		 */
+		void Prefetch(Map* currentMap, Position* position, int radius = ART_PREFETCH_RADIUS);
+		
+		/// sets the most memory in bytes the loaded wall sets may use, zero for no limit
+		void SetMemoryBudget(unsigned long bytes);
+		
+		/// gets the number of bytes of pixel data used by the loaded wall sets
+		unsigned long GetResidentBytes() const;
+		
+		/// gets the number of wall sets that are loaded
+		unsigned int GetLoadedWallSetCount() const;
+		
+		/// adds the directories the registered wall sets load their images from to @a directories
+		void GetArtDirectories(std::vector<std::string>* directories) const;
+		
+		/**
+		 * @brief queues the loaded wall sets that use the image at @a filePath to be rebuilt in the background
+		 * @note the changed image must already be in the ResourceCache, see Engine::ReloadChangedArt()
+		 * @return the number of wall sets queued
+		 */
+		unsigned int ReloadImage(const char* filePath);
+		
+		/**
+		 * @brief swaps in the wall sets that have finished rebuilding, and starts rebuilding any that are queued
+		 * @note call once a frame from the main thread; it never waits on the rebuilding
+		 * @return the number of wall sets that were replaced
+		 */
+		unsigned int InstallReloadedSets();
+		
 	private:
 		
+		/// a registered wall set
+		struct WallSetSlot
+		{
+			WallSetDefinition definition_;
+			bool registered_;
+			WallSpriteSet* set_;
+			WallSpriteSet* reloadedSet_;
+			unsigned long bytes_;
+			unsigned int lastUsedFrame_;
+			bool prefetching_;
+		
+			// the neighbours on the least recently used list, -1 at either end or when not listed
+			int olderSlot_;
+			int newerSlot_;
+		};
+		
+		/// loads the wall set in @a slot right now
+		void LoadWallSet(int slot);
+		
+		/// installs the wall sets of the finished prefetch, waiting for the decoding if need be
+		void FinishPrefetch();
+		
+		/// starts rebuilding the queued wall sets that are loaded, unless a rebuild is already in flight
+		void StartReloading();
+		
+		/// unloads the least recently used wall sets until the loaded ones fit the budget
+		void EvictToBudget();
+		
+		/// unloads the least recently used wall set that was not drawn this frame; false if there is none
+		bool EvictOldestSet();
+		
+		/// the SurfaceEvictor that unloads a wall set when all of the surfaces are over their budget
+		static bool EvictForSurfaceBudget(void* userData);
+		
+		/// moves @a slot to the most recently used end of the list
+		void TouchSlot(int slot);
+		
+		/// takes @a slot off the list
+		void UnlinkSlot(int slot);
+		
+		/// lays out the images of a generated set on its sheet, sized to where the view draws them
+		void LayoutGeneratedSet(WallSetDefinition* definition);
+		
 		bool allArtLoadedSuccessfully_;
 		
-		std::vector<WallSpriteSet*> allWallSprites_;
+		/// the wall sets, indexed by wall id minus one
+		std::vector<WallSetSlot> allWallSprites_;
+		
+		/// the ends of the least recently used list
+		int oldestSlot_;
+		int newestSlot_;
+		
+		unsigned long residentBytes_;
+		unsigned long memoryBudget_;
+		unsigned int loadedCount_;
+		unsigned int frameNumber_;
+		
+		/// the pool that prefetched sets decode on
+		ThreadPool* threadPool_;
+		
+		/// the prefetch batch in flight, or null
+		AssetLoader* prefetchLoader_;
+		
+		/// the slots being prefetched
+		std::vector<int> prefetchSlots_;
+		
+		/// the rebuild in flight, or null
+		AssetLoader* reloadLoader_;
+		
+		/// the slots being rebuilt, and the slots waiting to be
+		std::vector<int> reloadSlots_;
+		std::vector<int> staleSlots_;
 		
 	}; // end class
 
 } // end namespace
 #endif
 
-
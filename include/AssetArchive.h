@@ -0,0 +1,131 @@
+
+// CODESTYLE: v2.0
+
+// AssetArchive.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: reads resource files out of a single memory-mapped archive
+
+/**
+ * @file AssetArchive.h
+ * @brief Asset Archive - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __ASSETARCHIVE_H__
+#define __ASSETARCHIVE_H__
+
+struct SDL_Surface;
+
+// the archive the engine mounts at start-up when it exists and no other archive is given
+#define ASSETARCHIVE_DEFAULT_PATH "resources.lwca"
+
+// the first four bytes of every archive
+#define ASSETARCHIVE_MAGIC "LWCA"
+
+namespace LOFI
+{
+	/// the version of the archive layout; bumped whenever the layout changes
+	const unsigned int ASSETARCHIVE_VERSION = 1;
+
+	/// the size in bytes of the header and of one index entry in the file
+	const unsigned int ASSETARCHIVE_HEADER_SIZE = 16;
+	const unsigned int ASSETARCHIVE_ENTRY_SIZE = 48;
+
+	/// every blob in the archive starts on a multiple of this many bytes
+	const unsigned int ASSETARCHIVE_ALIGNMENT = 16;
+
+	/// how the bytes of an archive entry are stored
+	enum AssetArchiveEncoding
+	{
+		/// the bytes of the original file, as is
+		ASSETARCHIVE_ENCODING_FILE = 0,
+
+		/// an image already decoded to pixels, described by the entry's width, height, depth and masks
+		ASSETARCHIVE_ENCODING_PIXELS = 1
+	};
+
+	/**
+	 * @brief one index entry, as returned by AssetArchive::Find()
+	 *
+	 * The file starts with a header of the magic, the version, the entry count and the offset
+	 * of the index. The index is an array of these entries in this field order, sorted by path
+	 * so it can be binary searched. Every field of the header and the index is a little-endian
+	 * 32-bit integer, and every offset is from the start of the file.
+	 */
+	struct AssetArchiveEntry
+	{
+		unsigned int pathOffset_;
+		unsigned int pathLength_;
+		unsigned int dataOffset_;
+		unsigned int dataSize_;
+		unsigned int encoding_;
+		unsigned int width_;
+		unsigned int height_;
+		unsigned int bitsPerPixel_;
+		unsigned int redMask_;
+		unsigned int greenMask_;
+		unsigned int blueMask_;
+		unsigned int alphaMask_;
+	};
+
+	/**
+	 * @class AssetArchive
+	 * @brief reads resource files out of a single memory-mapped archive
+	 *
+	 * The archive is an index of paths followed by the files' bytes, built from the
+	 * resources directory by the PackAssets tool. Mounting maps the whole file into
+	 * memory once, so loading a resource from it is a binary search and a read of
+	 * memory instead of an open, a handful of reads and a close per file.
+	 * Images may be stored already decoded, which skips the PNG decoder as well.
+	 * A mounted archive is read-only, so it can be read from any thread. A file
+	 * that is edited on disk while the game runs is overridden, and read from its
+	 * loose file from then on.
+	 */
+	class AssetArchive
+	{
+	public:
+		/**
+		 * @brief maps the archive at @a filePath into memory and makes its files available
+		 * @return true on success, and false if it could not be opened or is not a valid archive
+		 */
+		static bool Mount(const char* filePath);
+
+		/// unmaps the archive; anything loaded from it must already have been copied out
+		static void Unmount();
+
+		/// is an archive mounted
+		static bool IsMounted();
+
+		/**
+		 * @brief looks up @a filePath in the mounted archive
+		 * @return the entry with its fields in native byte order, or false if it is not in the archive or is overridden
+		 */
+		static bool Find(const char* filePath, AssetArchiveEntry* entry);
+
+		/**
+		 * @brief makes Find() pass over @a filePath from now on, so it is read from its loose file
+		 * @note used once the file has been edited on disk, see Engine::ReloadChangedArt(); call from the main thread
+		 */
+		static void Override(const char* filePath);
+
+		/// gets the bytes of a found @a entry
+		static const unsigned char* GetData(const AssetArchiveEntry& entry);
+
+		/**
+		 * @brief decodes the image at @a filePath from the mounted archive into a new memory surface
+		 * @return the surface, or null if it is not in the archive or could not be decoded
+		 */
+		static SDL_Surface* LoadImage(const char* filePath);
+
+	private:
+		/// reads a little-endian 32-bit integer from the archive
+		static unsigned int ReadUint32(const unsigned char* bytes);
+
+		/// hidden constructor
+		AssetArchive();
+	}; // end class
+
+} // end namespace
+#endif
+
@@ -0,0 +1,148 @@
+
+// CODESTYLE: v2.0
+
+// AssetLoader.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: loads a batch of image resources, decoding them in parallel on a thread pool
+
+/**
+ * @file AssetLoader.h
+ * @brief Asset Loader - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __ASSETLOADER_H__
+#define __ASSETLOADER_H__
+
+#include <string>
+#include <vector>
+
+struct SDL_Surface;
+
+namespace LOFI
+{
+	class ThreadPool;
+	class ImageHandle;
+
+	/**
+	 * @class AssetLoader
+	 * @brief loads a batch of image resources, decoding them in parallel on a thread pool
+	 *
+	 * Images are requested up front, each with the place its surface should end up.
+	 * Finish() decodes every PNG into a memory surface on the pool's workers, then
+	 * converts them all to the display format in one pass on the calling thread,
+	 * since SDL_DisplayFormat() has to run on the thread that owns the screen.
+	 * Every image goes through the ResourceCache, so an image that is already
+	 * loaded is handed out straight away and never decoded again, and through the
+	 * PixelCache, so an image converted on a previous run is just read back in.
+	 * Newly converted images are written to the pixel cache from copies on the
+	 * pool, and nothing waits for them, so Finish() never stalls on the disk.
+	 */
+	class AssetLoader
+	{
+	public:
+		/**
+		 * @brief constructor
+		 * @param threadPool is the pool to decode on, or null to decode on the calling thread
+		 * @param logTimings is true to log how long each batch took to load
+		 */
+		explicit AssetLoader(ThreadPool* threadPool, bool logTimings = true);
+
+		/// destructor - frees any decoded surface that Finish() did not hand out
+		~AssetLoader();
+
+		/**
+		 * @brief queues the image at @a filePath; *@a destination is cleared now and set by Finish()
+		 * @note the destination holds a cache reference that is let go with Engine::UnloadImageResource()
+		 */
+		void Request(const char* filePath, SDL_Surface** destination);
+
+		/**
+		 * @brief queues the image at @a filePath; @a destination is emptied now and set by Finish()
+		 * @param decoder makes the image on a worker instead of decoding the file, when given
+		 */
+		void Request(const char* filePath, ImageHandle* destination, ImageDecoder decoder = 0, const void* decoderData = 0);
+
+		/**
+		 * @brief starts decoding the queued images in the background and returns straight away
+		 * @note no more images can be requested once the loader has started
+		 */
+		void Start();
+
+		/// has every queued image been decoded, so that Finish() will not wait on the workers
+		bool IsDecoded() const;
+
+		/**
+		 * @brief loads every queued image and stores it at its destination, starting first if need be
+		 * @return true if every image loaded, false if any failed (their destinations stay null)
+		 */
+		bool Finish();
+
+		/// gets the number of images waiting for Finish()
+		unsigned int GetRequestCount() const;
+
+	private:
+
+		/// a queued image
+		struct ImageRequest
+		{
+			std::string filePath_;
+			SDL_Surface** destination_;
+			ImageHandle* handle_;
+			SDL_Surface* decoded_;
+			bool converted_;
+			ImageDecoder decoder_;
+			const void* decoderData_;
+			AssetLoader* loader_;
+		};
+
+		/// queues a request for either kind of destination, or fills it straight from the cache
+		void QueueRequest(const char* filePath, SDL_Surface** destination, ImageHandle* handle,
+			ImageDecoder decoder, const void* decoderData);
+
+		/// stores a loaded @a surface at the request's destination
+		static void Deliver(ImageRequest& request, SDL_Surface* surface);
+
+		/// the pool job that decodes one ImageRequest, or reads it from the pixel cache
+		static void DecodeJob(void* userData);
+
+		/// a newly converted image to write to the pixel cache; the job that writes it owns it, and frees it
+		struct StoreRequest
+		{
+			std::string filePath_;
+			SDL_Surface* pixels_;
+		};
+
+		/// queues a copy of @a converted to be written to the pixel cache, without waiting for it
+		void QueueStore(const std::string& filePath, SDL_Surface* converted);
+
+		/// the pool job that writes one StoreRequest to the pixel cache, then frees it
+		static void StoreJob(void* userData);
+
+		/// the pool to decode on
+		ThreadPool* threadPool_;
+
+		/// the queued images
+		std::vector<ImageRequest> requests_;
+
+		/// the number of images still being decoded in the background
+		volatile int pendingDecodes_;
+
+		/// when the decoding was started
+		Microseconds startTime_;
+
+		/// has Start() been called
+		bool started_;
+
+		/// should each batch's timings be logged
+		bool logTimings_;
+
+		/// not copyable
+		AssetLoader(const AssetLoader&);
+		AssetLoader& operator=(const AssetLoader&);
+	}; // end class
+
+} // end namespace
+#endif
+
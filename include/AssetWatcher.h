@@ -0,0 +1,117 @@
+
+// CODESTYLE: v2.0
+
+// AssetWatcher.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: watches the art directories and decodes images as they change on disk
+
+/**
+ * @file AssetWatcher.h
+ * @brief Asset Watcher - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __ASSETWATCHER_H__
+#define __ASSETWATCHER_H__
+
+#include <map>
+#include <string>
+#include <vector>
+
+struct SDL_Surface;
+struct SDL_Thread;
+struct SDL_mutex;
+
+namespace LOFI
+{
+	/// how long in milliseconds the watcher thread waits for a change before checking if it should stop
+	const int ASSETWATCHER_POLL_INTERVAL = 100;
+
+	/**
+	 * @class AssetWatcher
+	 * @brief watches the art directories and decodes images as they change on disk
+	 *
+	 * A thread of its own waits on inotify for PNG files in the watched directories
+	 * to be written or moved into place, and decodes each one straight away, so the
+	 * main thread only has to pick up the decoded images with TakeReloadedImage()
+	 * between frames and convert them. Images are always read from the loose file,
+	 * never from the asset archive, since that is what the artist is editing.
+	 * Only Linux has inotify; elsewhere Start() fails and nothing is ever reloaded.
+	 */
+	class AssetWatcher
+	{
+	public:
+		/// constructor - nothing is watched until Start()
+		AssetWatcher();
+
+		/// destructor - stops the thread and frees any image that was never taken
+		~AssetWatcher();
+
+		/// adds @a directory, ending in a slash, to the directories to watch; call before Start()
+		void Watch(const std::string& directory);
+
+		/**
+		 * @brief starts watching the directories on the watcher thread
+		 * @return false if file watching is not supported or could not be set up
+		 */
+		bool Start();
+
+		/// stops the watcher thread
+		void Stop();
+
+		/**
+		 * @brief takes the next changed image
+		 * @param filePath receives the path of the image, as the engine loads it
+		 * @param decoded receives the decoded image, still to be converted with Engine::ConvertImageResource()
+		 * @return false if nothing has changed since the last call
+		 */
+		bool TakeReloadedImage(std::string* filePath, SDL_Surface** decoded);
+
+	private:
+
+		/// a changed image waiting for the main thread
+		struct ReloadedImage
+		{
+			std::string filePath_;
+			SDL_Surface* decoded_;
+		};
+
+		/// the watcher thread - decodes the changed images until the watcher stops
+		static int WatcherThread(void* userData);
+
+		/// decodes the image at @a filePath and queues it for the main thread
+		void ReloadImage(const std::string& filePath);
+
+		/// the directories to watch
+		std::vector<std::string> directories_;
+
+		/// the directories by inotify watch descriptor
+		std::map<int, std::string> watches_;
+
+		/// the inotify instance, or -1
+		int inotifyFd_;
+
+		/// the watcher thread
+		SDL_Thread* thread_;
+
+		/// guards readyImages_
+		SDL_mutex* lock_;
+
+		/// the decoded images waiting for the main thread
+		std::vector<ReloadedImage> readyImages_;
+
+		/// the number of images in readyImages_, so the main thread can check without locking
+		volatile int readyCount_;
+
+		/// should the watcher thread stop
+		volatile bool stopping_;
+
+		/// not copyable
+		AssetWatcher(const AssetWatcher&);
+		AssetWatcher& operator=(const AssetWatcher&);
+	}; // end class
+
+} // end namespace
+#endif
+
@@ -15,13 +15,23 @@
 #ifndef __BITMAPFONT_H__
 #define __BITMAPFONT_H__
 
+#include <vector>
+
 struct SDL_Surface;
 
 namespace LOFI
 {
+	class AssetLoader;
+
 	/// the maximum length for a string to be printed is 1024 characters
 	const unsigned int BITFNT_MAX_STRING_LENGTH = 0x400;
 	
+	/// the number of letters in a font image, 16 columns of 16
+	const int BITFNT_LETTER_COUNT = 0x100;
+	
+	/// the widest letter that can be compiled into row masks
+	const int BITFNT_MAX_COMPILED_WIDTH = 32;
+	
 	/**
 	 * @class BitmapFont
 	 * @brief a direct SDL port of my ged101 BitmapFont class
@@ -47,9 +57,10 @@ namespace LOFI
 		 * @param letterWidth is the width of a single letter in pixels
 		 * @param letterHeight is the height of a single letter in pixels
 		 * @param spacing is the spacing between the letters in pixels
-		 * @return true on success, false on failure
+		 * @param assetLoader if given, the image is queued on it and arrives when it finishes
+		 * @return true on success (or once queued), false on failure
 		 */
-		bool Load(const char* filePath, int letterWidth = 8, int letterHeight = 8, int spacing = 2);
+		bool Load(const char* filePath, int letterWidth = 8, int letterHeight = 8, int spacing = 2, AssetLoader* assetLoader = 0);
 		
 		/**
 		 * Initializes the font structure using a pre-loaded SDL_Surface.
@@ -62,6 +73,8 @@ namespace LOFI
 		
 		/**
 		 * Prints @a text on the @a destination SDL_Surface at the position @a x, @a y.
+		 * The letters are written straight into the locked destination from their compiled row masks when the
+		 * destination has the font image's pixel format, and blitted one by one from the font image otherwise.
 		 * @param destination is the SDL_Surface to print the text on to.
 		 * @param x is the X coordinate of the upper-left corner of the first letter of the string to be printed in pixels.
 		 * @param y is the Y coordinate of the upper-left corner of the first letter of the string to be printed in pixels.
@@ -69,6 +82,17 @@ namespace LOFI
 		 */
 		void Print(SDL_Surface* destination, int x, int y, const char* text, ...);
 		
+		/**
+		 * Prints the first @a length letters of @a text as they are, without formatting them first,
+		 * for text already built with a TextFormatter.
+		 * @param destination is the SDL_Surface to print the text on to.
+		 * @param x is the X coordinate of the upper-left corner of the first letter of the string to be printed in pixels.
+		 * @param y is the Y coordinate of the upper-left corner of the first letter of the string to be printed in pixels.
+		 * @param text is the text to be printed; '\n' and '\t' still move the cursor.
+		 * @param length is the number of letters of @a text to print.
+		 */
+		void PrintText(SDL_Surface* destination, int x, int y, const char* text, unsigned int length);
+		
 		/**
 		 * @return the width of a single letter in pixels
 		 */
@@ -84,17 +108,41 @@ namespace LOFI
 		 */
 		int GetLetterSpacing() const;
 		
+		/**
+		 * @return the amount of pixels a tab moves the cursor, the width of 8 letters
+		 */
+		int GetTabWidth() const;
+		
+		/**
+		 * Measures the first @a length letters of @a text as PrintText() would print them.
+		 * @param width receives the width in pixels from the left of the first letter to the right of the last.
+		 * @param height receives the height in pixels from the top of the first line to the bottom of the last.
+		 */
+		void MeasureText(const char* text, unsigned int length, int* width, int* height) const;
+		
 		/**
 		 * @return a pointer to the SDL_Surface structure that holds the font image data
 		 */
 		SDL_Surface* GetFontImage() const;
 		
+		/**
+		 * @return a number that no other font and no other image of this font has, for caches to key on;
+		 * it changes whenever the font image does, so it never matches a destroyed font that was at the same address
+		 */
+		unsigned int GetGeneration() const;
+		
 	private:
 		/**
 		 * De-allocates any allocated memory
 		 */
 		void Destroy();
 		
+		/**
+		 * Builds a mask of the opaque pixels of each row of each letter, and their colors, from the font image.
+		 * @return true if the letters are compiled, false if the font cannot be compiled and has to be blitted
+		 */
+		bool CompileGlyphs();
+		
 		/**
 		 * @var fontImage_
 		 * @brief the SDL_Surface structure that holds the font image data
@@ -118,6 +166,36 @@ namespace LOFI
 		 * @brief the amount of pixels of spacing between letters
 		 */
 		int spacing_;
+		
+		/**
+		 * @var glyphRows_
+		 * @brief the opaque pixels of each row of each letter, bit 0 being the leftmost pixel
+		 */
+		std::vector<unsigned int> glyphRows_;
+		
+		/**
+		 * @var glyphColors_
+		 * @brief the color of each pixel of each letter in the font image's format, or empty if every pixel is glyphColor_
+		 */
+		std::vector<unsigned int> glyphColors_;
+		
+		/**
+		 * @var glyphColor_
+		 * @brief the color of every opaque pixel, when the font is all one color
+		 */
+		unsigned int glyphColor_;
+		
+		/**
+		 * @var compiledImage_
+		 * @brief the font image the letters were compiled from, or null if they are not compiled
+		 */
+		SDL_Surface* compiledImage_;
+		
+		/**
+		 * @var generation_
+		 * @brief the font's current generation, see GetGeneration()
+		 */
+		unsigned int generation_;
 	}; // end class
 
 } // end namespace
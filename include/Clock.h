@@ -0,0 +1,54 @@
+
+// CODESTYLE: v2.0
+
+// Clock.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: monotonic wall-clock time source and precise sleeping for the main loop
+
+/**
+ * @file Clock.h
+ * @brief Monotonic Clock - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __CLOCK_H__
+#define __CLOCK_H__
+
+namespace LOFI
+{
+	/// a span of time or a point on the monotonic clock, in microseconds
+	typedef long long Microseconds;
+
+	/**
+	 * @class Clock
+	 * @brief monotonic wall-clock time source and precise sleeping for the main loop
+	 *
+	 * Unlike SDL_GetTicks() the readings have microsecond resolution, and unlike
+	 * the calendar clock they never jump backwards when the system time is changed.
+	 */
+	class Clock
+	{
+	public:
+		/**
+		 * @brief reads the monotonic clock
+		 * @return the number of microseconds elapsed since an arbitrary fixed point
+		 */
+		static Microseconds GetMicroseconds();
+
+		/**
+		 * @brief blocks the calling thread until the monotonic clock reaches @a deadline
+		 *
+		 * The bulk of the wait is given back to the OS with SDL_Delay(), and the
+		 * last stretch is spun out so the wake-up jitter stays well under a millisecond.
+		 */
+		static void SleepUntil(Microseconds deadline);
+
+	private:
+		/// hidden constructor
+		Clock();
+	}; // end class
+
+} // end namespace
+#endif
+
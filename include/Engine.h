@@ -16,16 +16,77 @@
 #define __ENGINE_H__
 
 struct SDL_Surface;
+struct SDL_Rect;
+struct SDL_Thread;
 
 namespace LOFI
 {
+	/// the default number of fixed simulation steps per second
+	const int ENGINE_DEFAULT_SIMULATION_RATE = 50;
+
+	/// the default number of frames presented per second
+	const int ENGINE_DEFAULT_FRAME_RATE = 60;
+
+	/// the most simulation steps and frames per second, so a step never rounds down to no time at all
+	const int ENGINE_MAX_SIMULATION_RATE = 1000;
+	const int ENGINE_MAX_FRAME_RATE = 1000;
+
+	/// the most key presses that can be waiting for the simulation to pick them up
+	const unsigned int ENGINE_INPUT_QUEUE_SIZE = 64;
+
+	/// what a key press asks of the simulation
+	enum InputCommand
+	{
+		/// a motion button was pressed down
+		INPUT_MOTION_PRESSED,
+
+		/// a motion button was let go
+		INPUT_MOTION_RELEASED,
+
+		/// turn the player to the left
+		INPUT_TURN_LEFT,
+
+		/// turn the player to the right
+		INPUT_TURN_RIGHT
+	};
 
 	class Map;
+
+	/**
+	 * @struct SimulationSnapshot
+	 * @brief the state the simulation hands over to be drawn, after each step that changed it
+	 *
+	 * The map itself is not copied. Its walls never change once it is made, and the
+	 * simulation only ever adds visited cells to it, each published before it is
+	 * counted (see Map::MarkVisited()), so the views read those straight from the
+	 * map. At worst a cell shows as visited a frame before the player is drawn in it.
+	 */
+	struct SimulationSnapshot
+	{
+		/// the map being played; only replaced by a new game while the simulation is not running
+		Map* map_;
+
+		/// where the player is and which way they face
+		Position player_;
+
+		/// the HUD action message
+		char actionMessage_[0x100];
+
+		/// counts up each time the HUD action message is set, so a new one is only laid out once
+		unsigned int actionMessageSerial_;
+	};
+
 	class MapView;
 	class MiniMap;
+	class MapPyramid;
 	class BitmapFont;
+	class TextCache;
 	class ArtManager;
 	class GameState;
+	class TimerQueue;
+	class ThreadPool;
+	class Presenter;
+	class AssetWatcher;
 
 	/**
 	 * @class Engine
@@ -63,6 +124,12 @@ namespace LOFI
 
 		/// gets a pointer to the screen surface
 		SDL_Surface* GetScreen() const;
+
+		/// gets a pointer to the display surface that the frames are presented on
+		SDL_Surface* GetMainScreen() const;
+
+		/// is the engine rendering off-screen without a window
+		bool IsHeadless() const;
 		
 		/// gets the bitmap font
 		BitmapFont* GetDefaultBitmapFont() const;
@@ -70,16 +137,38 @@ namespace LOFI
 		/// gets the game state
 		GameState* GetGameState() const;
 
-		/// clears the screen to a color
+		/// clears the back buffer the next frame is drawn into to a color
 		void ClearScreen(unsigned int color = 0);
 
-		/// flips the screen surface
+		/// hands the frame drawn since the last call to the presenter, if anything was drawn
 		void FlipScreen();
+
+		/// redraws the game screen, the HUD and the overlays into the back buffer of the next frame
+		void RenderFrame();
+
+		/**
+		 * @brief saves the main screen to a BMP file, once the frames drawn so far are on it
+		 * @return true on success, and false if the file could not be written
+		 */
+		bool SaveScreenshot(const char* filePath);
 		
-		/// loads an image file
+		/// loads an image file, or shares it if it is already loaded
 		static SDL_Surface* LoadImageResource(const char* filePath);
 		
-		/// unloads (frees) an image
+		/**
+		 * @brief decodes an image file into a memory surface with the transparent color key set
+		 * @param useArchive is false to always read the loose file, even when the asset archive has it
+		 * @note safe to call from any thread; the result still needs ConvertImageResource()
+		 */
+		static SDL_Surface* DecodeImageResource(const char* filePath, bool useArchive = true);
+		
+		/**
+		 * @brief converts a decoded image to the display format and frees the decoded surface
+		 * @note must be called on the main thread; returns null if @a preLoad is null
+		 */
+		static SDL_Surface* ConvertImageResource(SDL_Surface* preLoad);
+		
+		/// unloads an image - a cached image is freed once nothing else is using it
 		static void UnloadImageResource(SDL_Surface* image);
 		
 		/// blits a portion of the source surface to the target surface
@@ -87,9 +176,95 @@ namespace LOFI
 		
 		/// blits the entire source surface to the target surface
 		static void BlitSprite(SDL_Surface* source, SDL_Surface* target, int destX, int destY);
+		
+		/// fills a rectangle of the target surface with a color, or all of it if @a rect is null
+		static void FillRect(SDL_Surface* target, SDL_Rect* rect, unsigned int color);
+		
+		/// gets the number of pixels written by Blit(), BlitSprite() and FillRect() since the last reset
+		static unsigned long GetPixelsWritten();
+		
+		/// resets the count of pixels written
+		static void ResetPixelsWritten();
+
+		/**
+		 * @brief sets the frame rate the main loop paces itself to
+		 * @param framesPerSecond is the target frame rate, or zero to run uncapped; at most 1000
+		 */
+		void SetTargetFrameRate(int framesPerSecond);
+
+		/**
+		 * @brief sets the rate of the fixed simulation step
+		 * @param ticksPerSecond is the number of simulation steps per second of wall-clock time, from 1 to 1000
+		 */
+		void SetSimulationRate(int ticksPerSecond);
+
+		/// gets the timer queue that is driven by the simulation clock
+		TimerQueue* GetTimerQueue() const;
+
+		/// gets the worker threads used for loading and other background work
+		ThreadPool* GetThreadPool() const;
+
+		/**
+		 * @brief sets the HUD action message
+		 * @param message is the text to display
+		 * @param expires is true if the message should revert to "Waiting..." after a while
+		 * @note part of the simulation; call it from the simulation thread once Execute() has started it
+		 */
+		void SetActionMessage(const char* message, bool expires = true);
 
 	private:
 
+		/// the number of pixels written by the drawing helpers
+		static unsigned long pixelsWritten_;
+
+		/**
+		 * @brief parses the command line options
+		 * @return true on success, and false if an option was not understood
+		 */
+		bool ParseCommandLine(int args, char* argv[]);
+
+		/// processes the pending SDL events
+		void HandleEvents();
+
+		/// advances the game by one fixed simulation step, and publishes the state if the step changed it
+		void UpdateSimulation();
+
+		/**
+		 * @brief starts the simulation running on a thread of its own
+		 * @return true on success, false if the thread could not be started and the simulation has to run on the main thread
+		 */
+		bool StartSimulationThread();
+
+		/// stops the simulation thread and waits for it to finish, if it is running
+		void StopSimulationThread();
+
+		/// the simulation thread - steps the simulation at its fixed rate until it is stopped
+		static int SimulationThread(void* userData);
+
+		/// queues a key press for the simulation; called on the main thread
+		void QueueInput(InputCommand command, int button = 0);
+
+		/**
+		 * @brief takes the oldest queued key press; called by the simulation
+		 * @return false if there are none
+		 */
+		bool TakeInput(InputCommand* command, int* button);
+
+		/// publishes the state of the simulation for the renderer; called by the simulation
+		void PublishSnapshot();
+
+		/**
+		 * @brief takes the latest state the simulation published, for drawing; called on the main thread
+		 * @return true if it is new since the last call
+		 */
+		bool ConsumeSnapshot();
+
+		/// converts the art the watcher has reloaded, and swaps in the wall sets the art manager has rebuilt from it
+		void ReloadChangedArt();
+
+		/// timer callback that clears the HUD action message
+		static void OnActionMessageExpired(void* userData);
+
 		/**
 		 * @brief initializes the external libraries that the engine depends on
 		 * @return true on success, and false on failure of intialization of the libraries
@@ -102,6 +277,12 @@ namespace LOFI
 		 */
 		bool InitializeScreen();
 
+		/**
+		 * @brief starts the libraries and the screen, loads the art and starts a new game
+		 * @return true on success, and false on failure of any part of it
+		 */
+		bool InitializeGame();
+
 		/// hidden copy constructor
 		Engine(const Engine& rhs);
 
@@ -119,6 +300,12 @@ namespace LOFI
 		/// the small SDL surface that serves as the main screen
 		SDL_Surface* mainScreen_;
 		
+		/// presents the frames on the main screen, from back buffers of its own when threaded
+		Presenter* presenter_;
+		
+		/// are the frames presented on a thread of their own rather than the main thread
+		bool presentThread_;
+		
 		/// the SDL event data
 		SDL_Event* event_;
 		
@@ -133,6 +320,130 @@ namespace LOFI
 		
 		// the default font
 		BitmapFont* defaultFont_;
+		
+		/// the rendered HUD text
+		TextCache* textCache_;
+
+		/// is the engine rendering off-screen without a window
+		bool headless_;
+
+		/// the number of frames to run before stopping, or zero to run until quit
+		int frameLimit_;
+
+		/// where to save the last frame when the engine stops, or null
+		const char* screenshotPath_;
+
+		/// the number of worker threads to start, or -1 to size the pool to the machine
+		int workerThreads_;
+
+		/// the asset archive to load resources from, or null for the default one
+		const char* archivePath_;
+
+		/// the file to record a trace to, or null to not record one
+		const char* tracePath_;
+
+		/// the directory of the pixel cache, or null to turn it off
+		const char* pixelCachePath_;
+
+		/// the most memory in bytes the loaded wall sets may use, or zero for no limit
+		unsigned long artMemoryBudget_;
+
+		/// the most memory in bytes all of the surfaces should use, or zero for no limit
+		unsigned long surfaceMemoryBudget_;
+
+		/// should the art be reloaded when it changes on disk
+		bool hotReload_;
+
+		/// watches the art for changes, or null
+		AssetWatcher* assetWatcher_;
+
+		/// the timers that are driven by the simulation clock
+		TimerQueue* timers_;
+
+		/// the worker threads
+		ThreadPool* threadPool_;
+
+		/// the length of one simulation step
+		Microseconds simulationStep_;
+
+		/// the time between presented frames, or zero to run uncapped
+		Microseconds framePeriod_;
+
+		/// the main screen overlay image
+		ImageHandle mainScreenOverlay_;
+
+		/// the small compass overlay images, indexed by facing
+		ImageHandle smallCompassOverlay_[4];
+
+		/// the mini-map
+		MiniMap* miniMap_;
+
+		/// does the mini-map show the walls of the visited cells
+		bool showAutomap_;
+
+		/// the explored map at every zoom level, for the world overview
+		MapPyramid* mapPyramid_;
+
+		/// is the world overview shown over the game screen
+		bool showWorldOverview_;
+
+		/// the level of the map pyramid the world overview shows
+		int worldOverviewLevel_;
+
+		/// the HUD action message
+		char hudActionMessage_[0x100];
+
+		/// counts up each time the HUD action message is set
+		unsigned int actionMessageSerial_;
+
+		/// the HUD action message the layout was made from
+		unsigned int laidOutMessageSerial_;
+		
+		/// the HUD action message laid out for drawing
+		TextLayout actionMessageLayout_;
+
+		/// the timer that will clear the HUD action message
+		TimerID actionMessageTimer_;
+
+		/// should the display be redrawn
+		bool requestUpdateDisplay_;
+
+		/// is the profiler overlay shown
+		bool showProfilerOverlay_;
+
+		/// which motion buttons are held down
+		bool motionButtonDown_[4];
+
+		/// the simulation time left until a held motion button moves the player again
+		Microseconds playerMotionCooldown_;
+
+		/// the thread the simulation runs on, or null when it runs on the main thread
+		SDL_Thread* simulationThread_;
+
+		/// is the simulation thread to keep running
+		volatile bool simulationRunning_;
+
+		/// has the simulation changed anything since it last published its state
+		bool simulationChanged_;
+
+		/// the state the simulation publishes and the main thread draws
+		TripleBuffer<SimulationSnapshot> snapshots_;
+
+		/// a key press waiting for the simulation
+		struct QueuedInput
+		{
+			InputCommand command_;
+			int button_;
+		};
+
+		/// the key presses waiting for the simulation, a ring written by the main thread and read by the simulation
+		QueuedInput inputQueue_[ENGINE_INPUT_QUEUE_SIZE];
+
+		/// the number of key presses ever queued, written only by the main thread
+		volatile unsigned int inputQueueHead_;
+
+		/// the number of key presses ever taken, written only by the simulation
+		volatile unsigned int inputQueueTail_;
 
 	}; // end class
 	
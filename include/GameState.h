@@ -33,6 +33,9 @@ namespace LOFI
 		~GameState();
 		void StartNewGame();
 		
+		/// starts a new game on a random maze - see Map::MakeMaze()
+		void StartNewGame(int mapWidth, int mapHeight, unsigned int seed);
+		
 		bool MovePlayerForward();
 		bool MovePlayerBack();
 		
@@ -27,6 +27,7 @@ namespace LOFI
 	const int WALL_FACING_NORTH 	= 4;
 	const int WALL_FACING_SOUTH 	= 2;
 	
+	// the ids of the wall sets in resources/walls.txt that the generated maps use
 	const int WALL_TYPE_BRICK 		= 1;
 	const int WALL_TYPE_STONE 		= 2;
 	const int WALL_TYPE_WOOD 		= 3;
@@ -46,6 +47,14 @@ namespace LOFI
 		~Map();
 		
 		void MakeMockup();
+		
+		/**
+		 * @brief builds a random maze of the given size
+		 * @param width is the number of columns of the map
+		 * @param height is the number of rows of the map
+		 * @param seed selects the maze; the same seed always builds the same maze
+		 */
+		void MakeMaze(int width, int height, unsigned int seed);
 		int GetWallForCoordinate(Position* position);
 		bool CanPassWallForCoordinate(Position* position);
 		Position* GetStartingPoint(int which);
@@ -53,7 +62,41 @@ namespace LOFI
 		int GetWidth() const;
 		int GetHeight() const;
 		
+		/**
+		 * @brief gets whether the cell at @a column, @a row has been visited
+		 * @note read from another thread it can be true a little before the cell is in GetVisitedCount()
+		 */
 		bool IsVisited(int column, int row) const;
+		
+		/**
+		 * @brief gets which edges of the cell at @a column, @a row cannot be passed
+		 * @return a bit for each blocked edge, 1 << PLAYER_FACING_NORTH and so on; every edge is blocked outside the map
+		 */
+		int GetWallMask(int column, int row) const;
+		
+		/// gets the id of the wall on the @a facing edge of the cell at @a column, @a row, zero for none
+		int GetWall(int column, int row, int facing) const;
+		
+		/**
+		 * @brief marks the cell at @a column, @a row as visited
+		 * @return true if it had not been visited before
+		 * @note only one thread may mark cells, but any can read the visited cells while it does
+		 */
+		bool MarkVisited(int column, int row);
+		
+		/**
+		 * @brief gets the number of the last time the map was cleared
+		 *
+		 * Every clear of every map gets a new number, so whatever was drawn from
+		 * the map can tell that everything may have changed since.
+		 */
+		unsigned int GetGeneration() const;
+		
+		/// gets the number of cells visited since the map was cleared
+		unsigned int GetVisitedCount() const;
+		
+		/// gets the cell visited @a index th since the map was cleared, as row * width + column
+		int GetVisitedCell(unsigned int index) const;
 	private:
 		void MakeFirstMockup();
 		void MakeNormalWall(Position* position, int wallID);
@@ -75,9 +118,20 @@ namespace LOFI
 		#if 1
 		int*** walls_;
 		bool*** passibility_;
-		bool*** visited_;
 		#endif
 		
+		/// a flag for each cell, row by row
+		bool* visited_;
+		
+		/// the cells visited since the map was cleared, in the order they were visited; room for every cell
+		int* visitedOrder_;
+		
+		/// the number of cells in visitedOrder_
+		volatile unsigned int visitedCount_;
+		
+		/// the number of the last time the map was cleared
+		unsigned int generation_;
+		
 		Position** startingPoints_;
 	}; // end class 
 
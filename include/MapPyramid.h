@@ -0,0 +1,118 @@
+
+// CODESTYLE: v2.0
+
+// MapPyramid.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: keeps the explored map as images at every zoom level, from a pixel per cell to the whole map in one
+
+/**
+ * @file MapPyramid.h
+ * @brief Map Pyramid - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __MAPPYRAMID_H__
+#define __MAPPYRAMID_H__
+
+#include <vector>
+
+struct SDL_Surface;
+
+namespace LOFI
+{
+	class Map;
+
+	/**
+	 * @class MapPyramid
+	 * @brief keeps the explored map as images at every zoom level, from a pixel per cell to the whole map in one
+	 *
+	 * Level 0 has a pixel for each cell of the map. Each level after it is half the
+	 * size of the one before, rounded up, with each pixel standing for a block of
+	 * 2x2 pixels of the level before, down to a single pixel. A pixel is colored by
+	 * how much of its block has been visited, between the mini-map's colors for a
+	 * cell that has not been visited and one that has.
+	 * Each level keeps the number of visited cells in each of its blocks, so a cell
+	 * being visited repaints one pixel on each level and nothing is read back from
+	 * the images. Drawing any level is then a single blit.
+	 */
+	class MapPyramid
+	{
+	public:
+		/// constructor - an empty pyramid, until it is given a map
+		MapPyramid();
+
+		/// destructor - frees the images
+		~MapPyramid();
+
+		/// sets the map the pyramid is of; it is rebuilt on the next Update()
+		void SetMap(Map* sourceMap);
+
+		/// brings the images up to date with the cells visited since the last update, or rebuilds them if the map was cleared
+		void Update();
+
+		/// gets the number of levels, zero when there is no map
+		int GetLevelCount() const;
+
+		/// gets the image of @a level, or null if there is no such level
+		SDL_Surface* GetLevel(int level) const;
+
+		/// gets the most detailed level whose image fits within @a width x @a height pixels
+		int GetLevelToFit(int width, int height) const;
+
+		/**
+		 * @brief draws @a level into the @a width x @a height box at @a x, @a y of @a target
+		 *
+		 * A level smaller than the box is centered in it. A bigger one is scrolled
+		 * to keep the cell at @a column, @a row in view, as near the middle as the
+		 * edges of the map allow. That cell is marked in the player's color.
+		 */
+		void Draw(SDL_Surface* target, int x, int y, int width, int height, int level, int column, int row) const;
+
+	private:
+		/// one zoom level
+		struct PyramidLevel
+		{
+			/// the image, a pixel for each block
+			SDL_Surface* image_;
+
+			/// the size of the image
+			int width_;
+			int height_;
+
+			/// the number of visited cells in each block, row by row
+			std::vector<unsigned int> visitedCounts_;
+		};
+
+		/// frees the images and builds them again from every cell of the map
+		void Rebuild();
+
+		/// counts the cell at @a column, @a row as visited on every level, and repaints the blocks it is in
+		void AddVisitedCell(int column, int row);
+
+		/// paints the pixel of the block at @a blockColumn, @a blockRow of @a level for how much of it is visited
+		void PaintBlock(int level, int blockColumn, int blockRow);
+
+		/// frees the images
+		void DestroyLevels();
+
+		/// the map the pyramid is of
+		Map* currentMap_;
+
+		/// the generation of the map the levels were built from
+		unsigned int builtGeneration_;
+
+		/// the number of its visited cells that are counted
+		unsigned int builtVisitedCount_;
+
+		/// the levels, most detailed first
+		std::vector<PyramidLevel> levels_;
+
+		/// not copyable
+		MapPyramid(const MapPyramid&);
+		MapPyramid& operator=(const MapPyramid&);
+	}; // end class
+
+} // end namespace
+#endif
+
@@ -15,17 +15,50 @@
 #ifndef __MINIMAP_H__
 #define __MINIMAP_H__
 
+#include <map>
+#include <vector>
+
 struct SDL_Surface;
 
 namespace LOFI
 {
 	class Map;
+	class Position;
+	
+	/// the smallest a cell is drawn, in pixels; a map that would need smaller cells scrolls instead
+	const int MINIMAP_MIN_CELL_SIZE = 4;
+	
+	/// the number of cells across and down each pre-rendered chunk of a scrolling mini-map
+	const int MINIMAP_CHUNK_CELLS = 16;
+	
+	/// the most chunks kept rendered before the farthest from the player are freed
+	const unsigned int MINIMAP_MAX_CHUNKS = 32;
+	
+	/// the number of wall masks, a bit for each edge of a cell, and so the number of stamps in each row of the automap's stamp table
+	const int MINIMAP_WALL_MASKS = 16;
+	
+	/// the number of wall types the automap has a color for, the walls with no type (0) and the WALL_TYPE_ ids
+	const int MINIMAP_WALL_TYPES = 5;
 	
 	/**
 	 * @class MiniMap
 	 * @brief takes a pointer to a Map instance and has a rendering method to display a mini-top-down version of it
 	 *
 	 * The mini-map will display only the map-cells that have been marked as visited.
+	 * Update() only repaints the cells that changed since the last update, the cell
+	 * the player left, the cell the player is in and the cells newly visited; the
+	 * whole mini-map is repainted when the map is changed or cleared.
+	 *
+	 * A map too big for the cells to fit at MINIMAP_MIN_CELL_SIZE scrolls, with the
+	 * player in the middle. Its cells are rendered into chunks of
+	 * MINIMAP_CHUNK_CELLS x MINIMAP_CHUNK_CELLS cells the first time they come into
+	 * view and are kept, so the view is put together from a handful of blits and
+	 * costs the same however big the map is.
+	 *
+	 * In automap mode the visited cells also show their walls. Every cell looks
+	 * like one of a few stamps, by which of its edges are walls, the type of those
+	 * walls and whether the player is in it, so the stamps are all rendered into a
+	 * table when the cell size is known and painting a cell is a single blit.
 	 */
 	class MiniMap
 	{
@@ -34,14 +67,99 @@ namespace LOFI
 		~MiniMap();
 		void SetMap(Map* sourceMap);
 		void Render(SDL_Surface* target, int x, int y);
-		void Update();
+		
+		/// repaints what changed since the last update, with the player at @a playerPosition
+		void Update(const Position* playerPosition);
+		
+		/// shows the walls of the visited cells as well, or only which cells are visited
+		void SetAutomap(bool automap);
+		
+		/// gets whether the walls of the visited cells are shown
+		bool IsAutomap() const;
 	private:
 		void RecreateMiniMapSurface();
 		void DestroyMiniMapSurface();
+		
+		/// repaints only the cells that changed since the last update
+		void RepaintChangedCells();
+		
+		/// paints the cell at @a column, @a row of the current map in the color for its state, at @a x, @a y of @a target
+		void PaintCell(SDL_Surface* target, int column, int row, int x, int y);
+		
+		/// paints the cell at @a column, @a row wherever it is drawn; into its chunk when it has one
+		void RepaintCell(int column, int row);
+		
+		/// puts the view of a scrolling mini-map together from the chunks around the player
+		void ComposeView();
+		
+		/// gets the chunk at @a chunkColumn, @a chunkRow, rendering it if it is not kept; null if it cannot be created
+		SDL_Surface* GetChunk(int chunkColumn, int chunkRow);
+		
+		/// frees the kept chunk farthest from the player; false if there are none
+		bool EvictFarthestChunk();
+		
+		/// frees every kept chunk
+		void DestroyChunks();
+		
+		/// renders the automap's stamp table at the current cell size, if it is not already
+		void CreateStamps();
+		
+		/// frees the automap's stamp table
+		void DestroyStamps();
+		
+		/// gets the type of most of the walls of the cell at @a column, @a row with the walls in @a wallMask, for its stamp
+		int GetCellWallType(int column, int row, int wallMask) const;
+		
+		/// the SurfaceEvictor that frees a chunk when all of the surfaces are over their budget
+		static bool EvictForSurfaceBudget(void* userData);
+		
 		Map* currentMap_;
 		SDL_Surface* miniMapSurface_;
 		int width_;
 		int height_;
+		
+		/// whether every cell must be repainted on the next update
+		bool repaintAll_;
+		
+		/// the generation of the map that was painted, and how many of its visited cells
+		unsigned int paintedGeneration_;
+		unsigned int paintedVisitedCount_;
+		
+		/// the cell the player was painted in
+		int paintedPlayerX_;
+		int paintedPlayerZ_;
+		
+		/// the cell the player is in, as of the last update
+		int playerX_;
+		int playerZ_;
+		
+		/// the cells to repaint, as row * map width + column, kept to reuse its memory
+		std::vector<int> dirtyCells_;
+		
+		/// the size each cell is drawn at
+		int cellWidth_;
+		int cellHeight_;
+		
+		/// whether the map is too big to fit, so the view follows the player
+		bool scrolling_;
+		
+		/// the rendered chunks of a scrolling mini-map, by chunk row * chunks across + chunk column
+		std::map<int, SDL_Surface*> chunks_;
+		
+		/// whether the walls of the visited cells are shown
+		bool automap_;
+		
+		/**
+		 * @brief the automap's stamp table, a stamp for each wall mask across and each cell state down
+		 *
+		 * The first row is a cell that has not been visited, then a row for each wall
+		 * type of a visited cell, each followed by the same with the player in it.
+		 */
+		SDL_Surface* stamps_;
+		
+		/// not copyable
+		MiniMap(const MiniMap&);
+		MiniMap& operator=(const MiniMap&);
 	}; // end class 
 
 } // end namespace
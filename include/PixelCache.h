@@ -0,0 +1,78 @@
+
+// CODESTYLE: v2.0
+
+// PixelCache.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: keeps images already converted to the display format on disk between runs
+
+/**
+ * @file PixelCache.h
+ * @brief Display Format Pixel Cache - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __PIXELCACHE_H__
+#define __PIXELCACHE_H__
+
+struct SDL_Surface;
+struct SDL_PixelFormat;
+
+// the directory the engine keeps its converted images in unless told otherwise
+#define PIXELCACHE_DEFAULT_DIRECTORY "pixelcache"
+
+namespace LOFI
+{
+	/// the version of the cache file layout and of the way images are decoded; bumped when either changes
+	const unsigned int PIXELCACHE_VERSION = 1;
+
+	/**
+	 * @class PixelCache
+	 * @brief keeps images already converted to the display format on disk between runs
+	 *
+	 * After an image is decoded and converted, its pixels are written to a file named
+	 * after a hash of the source file's bytes and a hash of the display's pixel format.
+	 * On the next run the same image on the same display finds that file and is read
+	 * straight into a surface, skipping both the PNG decoder and SDL_DisplayFormat().
+	 * An edited image hashes differently, so the cache never hands out stale pixels;
+	 * files from old versions of an image are just never read again.
+	 * Load() and Store() touch no shared state, so they can run on any thread.
+	 */
+	class PixelCache
+	{
+	public:
+		/// sets the directory to keep the converted images in, creating it if need be; null turns the cache off
+		static void SetDirectory(const char* directoryPath);
+
+		/// is the cache turned on
+		static bool IsEnabled();
+
+		/**
+		 * @brief reads the converted image for @a filePath, if the cache has one for the current display format
+		 * @return a surface in the display format with the transparent color key set, or null on a miss
+		 */
+		static SDL_Surface* Load(const char* filePath);
+
+		/**
+		 * @brief writes @a converted, the display format image of @a filePath, to the cache
+		 * @return true if it was written
+		 */
+		static bool Store(const char* filePath, SDL_Surface* converted);
+
+		/// gets the number of images found in the cache since start-up
+		static unsigned long GetHitCount();
+
+		/// gets the number of images that were not in the cache since start-up
+		static unsigned long GetMissCount();
+
+	private:
+		/// builds the name of the cache file for @a filePath in the current display format
+		static bool GetCacheFilePath(const char* filePath, const SDL_PixelFormat* format, char* cacheFilePath, unsigned int size);
+
+		/// hidden constructor
+		PixelCache();
+	}; // end class
+
+} // end namespace
+#endif
+
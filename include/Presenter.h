@@ -0,0 +1,147 @@
+
+// CODESTYLE: v2.0
+
+// Presenter.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: presents finished frames from a pool of back buffers, optionally on a thread of its own
+
+/**
+ * @file Presenter.h
+ * @brief Frame Presenter - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __PRESENTER_H__
+#define __PRESENTER_H__
+
+#include <cstdio>
+
+struct SDL_Surface;
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+
+namespace LOFI
+{
+	/// the number of back buffers; one being drawn, one waiting and one being presented
+	const int PRESENTER_BACK_BUFFERS = 3;
+
+	/**
+	 * @class Presenter
+	 * @brief presents finished frames from a pool of back buffers, optionally on a thread of its own
+	 *
+	 * By default the frames are drawn straight onto the display, and Submit()
+	 * only flips it, as SDL_Flip was called before. When threaded, frames are
+	 * drawn into a back buffer instead, and Submit() hands the finished buffer
+	 * to the presentation thread, which copies it to the display and flips,
+	 * while the next frame is drawn into another buffer. A frame that is still waiting when a newer one
+	 * is submitted is dropped, so the display always gets the newest frame and
+	 * drawing never waits on it.
+	 * @note SDL 1.2 only supports the video calls on the thread that set the
+	 * video mode and pumps the events; with X11 the thread can corrupt Xlib's
+	 * state, so it is only for drivers known to cope, such as the dummy one.
+	 * The time from each frame being submitted to it being on the display is
+	 * kept, for the report.
+	 */
+	class Presenter
+	{
+	public:
+		/**
+		 * @brief constructor - starts the thread if asked to, with back buffers in the format of @a display
+		 * @param flip is false to never flip @a display, when there is nothing to flip it to
+		 * @param threaded is true to present on a thread of its own rather than the thread that submits the frames
+		 */
+		Presenter(SDL_Surface* display, bool flip, bool threaded);
+
+		/// destructor - presents the frame that is waiting, stops the thread and frees the back buffers
+		~Presenter();
+
+		/**
+		 * @brief gets the back buffer to draw the next frame into, which is the display itself when not threaded
+		 * @note the buffer holds whatever frame was drawn into it before, so the frame has to be drawn over all of it
+		 */
+		SDL_Surface* GetBackBuffer();
+
+		/// hands the back buffer to be presented; the next GetBackBuffer() gives another one
+		void Submit();
+
+		/// blocks until every submitted frame has been presented or dropped
+		void Flush();
+
+		/// gets whether the frames are presented on a thread of their own
+		bool IsThreaded() const;
+
+		/// writes the number of frames presented and dropped, and how long they took to be presented
+		void WriteReport(FILE* fp) const;
+
+	private:
+		/// the presentation thread - presents each frame as it is submitted until the presenter is destroyed
+		static int PresentThread(void* userData);
+
+		/// copies the back buffer @a buffer to the display and flips it
+		void Present(int buffer);
+
+		/// creates the back buffers the thread presents from; false if any of them could not be created
+		bool CreateBackBuffers();
+
+		/// frees whichever back buffers were created
+		void FreeBackBuffers();
+
+		/// keeps the time a frame submitted at @a submitTime took to be presented; called with the lock held
+		void RecordLatency(Microseconds submitTime);
+
+		/// the display surface
+		SDL_Surface* display_;
+
+		/// is the display flipped after each frame is copied to it
+		bool flip_;
+
+		/// the back buffers, only when threaded
+		SDL_Surface* buffers_[PRESENTER_BACK_BUFFERS];
+
+		/// when each back buffer was last submitted
+		Microseconds submitTimes_[PRESENTER_BACK_BUFFERS];
+
+		/// the back buffer being drawn, or -1 until GetBackBuffer() picks one
+		int drawingBuffer_;
+
+		/// the back buffer waiting to be presented, or -1 for none
+		int waitingBuffer_;
+
+		/// the back buffer being presented, or -1 for none
+		int presentingBuffer_;
+
+		/// the number of frames presented
+		unsigned int framesPresented_;
+
+		/// the number of frames dropped for a newer one before they were presented
+		unsigned int framesDropped_;
+
+		/// the total and the longest time frames took from being submitted to being presented
+		Microseconds totalLatency_;
+		Microseconds maxLatency_;
+
+		/// the presentation thread, or null when frames are presented by Submit()
+		SDL_Thread* thread_;
+
+		/// is the presenter shutting down
+		bool stopping_;
+
+		/// guards the buffer indices, the counts and stopping_
+		SDL_mutex* lock_;
+
+		/// signalled when a frame is submitted or the presenter is shutting down
+		SDL_cond* frameWaiting_;
+
+		/// signalled when a frame has been presented
+		SDL_cond* framePresented_;
+
+		/// not copyable
+		Presenter(const Presenter&);
+		Presenter& operator=(const Presenter&);
+	}; // end class
+
+} // end namespace
+#endif
+
@@ -0,0 +1,143 @@
+
+// CODESTYLE: v2.0
+
+// Profiler.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: lightweight scoped timers for the engine's hot paths, with an on-screen overlay
+
+/**
+ * @file Profiler.h
+ * @brief Hot Path Profiler - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+struct SDL_Surface;
+
+namespace LOFI
+{
+	class BitmapFont;
+
+	/// the hot paths that the profiler keeps track of
+	enum ProfileZone
+	{
+		// the per-frame zones, shown on the overlay
+		PROFILE_ZONE_FRAME = 0,
+		PROFILE_ZONE_INPUT,
+		PROFILE_ZONE_SIMULATION,
+		PROFILE_ZONE_RENDERMAP,
+		PROFILE_ZONE_FONTPRINT,
+		PROFILE_ZONE_MINIMAP,
+		PROFILE_ZONE_OVERLAYS,
+		PROFILE_ZONE_FLIPSCREEN,
+
+		// the start-up zones, which only matter to traces
+		PROFILE_ZONE_LOADING,
+		PROFILE_ZONE_LOADART,
+		PROFILE_ZONE_DECODE,
+		PROFILE_ZONE_CONVERT,
+
+		PROFILE_ZONE_COUNT
+	};
+
+	/// a raw reading of the profiler's timestamp counter
+	typedef unsigned long long ProfileTicks;
+
+	/**
+	 * @class Profiler
+	 * @brief lightweight scoped timers for the engine's hot paths, with an on-screen overlay
+	 *
+	 * Every thread that records a timing gets its own buffer of running totals, which
+	 * only that thread ever writes to. EndFrame() reads the totals of all the buffers
+	 * and keeps the difference from the previous frame, so recording never takes a lock
+	 * or a locked instruction. When the profiler is disabled a scope costs one branch.
+	 */
+	class Profiler
+	{
+	public:
+		/// turns the recording of timings for the overlay on or off
+		static void SetEnabled(bool enabled);
+
+		/// turns the forwarding of every timed scope to the TraceRecorder on or off
+		static void SetTracing(bool tracing);
+
+		/// is the profiler recording timings, for the overlay or for a trace
+		static bool IsEnabled();
+
+		/// reads the timestamp counter (RDTSC where available, otherwise the monotonic clock)
+		static ProfileTicks ReadTimestamp();
+
+		/// adds the time from @a start to @a end to the calling thread's total for @a zone
+		static void Record(ProfileZone zone, ProfileTicks start, ProfileTicks end);
+
+		/// collects the totals from every thread into the per-frame figures; called once per frame
+		static void EndFrame();
+
+		/// gets the time spent in @a zone during the last frame in microseconds
+		static double GetFrameMicroseconds(ProfileZone zone);
+
+		/// gets the time spent in @a zone per frame in microseconds, smoothed over recent frames
+		static double GetAverageMicroseconds(ProfileZone zone);
+
+		/// gets the number of times @a zone was entered during the last frame
+		static unsigned int GetFrameCalls(ProfileZone zone);
+
+		/// gets the display name of @a zone
+		static const char* GetZoneName(ProfileZone zone);
+
+		/// draws the per-zone figures with @a font onto @a target at @a x, @a y
+		static void DrawOverlay(BitmapFont* font, SDL_Surface* target, int x, int y);
+
+	private:
+		/// measures how many timestamp ticks there are in a microsecond
+		static void Calibrate();
+
+		/// turns a timestamp into microseconds of the monotonic clock
+		static Microseconds ToMicroseconds(ProfileTicks timestamp);
+
+		/// hidden constructor
+		Profiler();
+	}; // end class
+
+	/**
+	 * @class ScopedProfile
+	 * @brief times the enclosing scope into a profile zone - use the PROFILE_SCOPE() macro
+	 */
+	class ScopedProfile
+	{
+	public:
+		explicit ScopedProfile(ProfileZone zone) :
+			zone_(zone),
+			start_((Profiler::IsEnabled()) ? Profiler::ReadTimestamp() : 0)
+		{
+		}
+
+		~ScopedProfile()
+		{
+			if (start_)
+			{
+				Profiler::Record(zone_, start_, Profiler::ReadTimestamp());
+			}
+		}
+
+	private:
+		ProfileZone zone_;
+		ProfileTicks start_;
+	}; // end class
+
+} // end namespace
+
+// time the rest of the enclosing scope into a profile zone
+#if !defined(CONFIG_DISABLE_PROFILER)
+	#define PROFILE_SCOPE_NAME2(line) profileScope##line
+	#define PROFILE_SCOPE_NAME(line) PROFILE_SCOPE_NAME2(line)
+	#define PROFILE_SCOPE(zone) LOFI::ScopedProfile PROFILE_SCOPE_NAME(__LINE__)(zone)
+#else
+	#define PROFILE_SCOPE(zone)
+#endif
+
+#endif
+
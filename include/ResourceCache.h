@@ -0,0 +1,136 @@
+
+// CODESTYLE: v2.0
+
+// ResourceCache.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: shares loaded image resources by path and frees them when the last user lets go
+
+/**
+ * @file ResourceCache.h
+ * @brief Resource Cache - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __RESOURCECACHE_H__
+#define __RESOURCECACHE_H__
+
+#include <cstdio>
+
+struct SDL_Surface;
+
+namespace LOFI
+{
+	/**
+	 * @brief makes the image cached as @a filePath some other way than decoding that file
+	 * @return a memory surface with the transparent color key set, like Engine::DecodeImageResource()
+	 * @note runs on the loader's worker threads, so it must not touch the screen or the cache
+	 */
+	typedef SDL_Surface* (*ImageDecoder)(const char* filePath, const void* userData);
+
+	/**
+	 * @class ResourceCache
+	 * @brief shares loaded image resources by path and frees them when the last user lets go
+	 *
+	 * Every image loaded through Engine::LoadImageResource() or an AssetLoader is kept
+	 * here against its file path with a count of its users, so loading the same path
+	 * twice hands back the same surface without touching the disk, and the surface is
+	 * freed the moment its last reference is released.
+	 * The cache is only ever used from the main thread.
+	 */
+	class ResourceCache
+	{
+	public:
+		/**
+		 * @brief gets a reference to the image at @a filePath, loading it if it is not cached
+		 * @param decoder makes the image instead of decoding the file, when given; its images skip the pixel cache
+		 * @return the surface, or null if it could not be loaded
+		 */
+		static SDL_Surface* Acquire(const char* filePath, ImageDecoder decoder = 0, const void* decoderData = 0);
+
+		/**
+		 * @brief gets a reference to the image at @a filePath only if it is already cached
+		 * @return the surface, or null if it is not cached
+		 */
+		static SDL_Surface* AcquireCached(const char* filePath);
+
+		/**
+		 * @brief adds a freshly loaded @a surface to the cache under @a filePath with one reference
+		 * @return the cached surface; if the path was already cached, @a surface is freed and
+		 * a reference to the existing surface is returned instead
+		 */
+		static SDL_Surface* Insert(const char* filePath, SDL_Surface* surface);
+
+		/// adds a reference to a cached @a surface; does nothing for a surface the cache doesn't own
+		static void AddReference(SDL_Surface* surface);
+
+		/**
+		 * @brief drops a reference to @a surface, and frees it if that was the last one
+		 * @return true if the cache owns @a surface, false if it is not a cached surface
+		 */
+		static bool Release(SDL_Surface* surface);
+
+		/**
+		 * @brief forgets which file the cached image of @a filePath came from, and any image cut from it
+		 *
+		 * The next Acquire() of the path loads the file again, while everything still holding
+		 * the old surface keeps it until it lets go; used when a file changes on disk.
+		 * @return the number of images detached
+		 */
+		static unsigned int Detach(const char* filePath);
+
+		/// gets the number of images in the cache
+		static unsigned int GetImageCount();
+
+		/// gets the number of bytes of pixel data held by the cached images
+		static unsigned long GetResidentBytes();
+
+		/// writes the cache's size and hit rate to @a fp, and each cached image too if @a listImages
+		static void WriteReport(FILE* fp, bool listImages = false);
+
+		/// frees every cached image, logging the ones that still had references
+		static void ReleaseAll();
+
+	private:
+		/// hidden constructor
+		ResourceCache();
+	}; // end class
+
+	/**
+	 * @class ImageHandle
+	 * @brief holds one reference to a cached image for as long as the handle lives
+	 */
+	class ImageHandle
+	{
+	public:
+		/// constructor - an empty handle
+		ImageHandle();
+
+		/// constructor - acquires the image at @a filePath through the cache
+		explicit ImageHandle(const char* filePath);
+
+		/// copy constructor - shares the image, adding a reference
+		ImageHandle(const ImageHandle& rhs);
+
+		/// assignment operator - shares the image, adding a reference
+		ImageHandle& operator=(const ImageHandle& rhs);
+
+		/// destructor - releases the reference
+		~ImageHandle();
+
+		/// releases the current image and takes over a reference to @a surface that the caller already holds
+		void Reset(SDL_Surface* surface = 0);
+
+		/// gets the image, or null if the handle is empty
+		SDL_Surface* Get() const;
+
+		/// lets the handle be passed wherever a surface is expected
+		operator SDL_Surface*() const;
+
+	private:
+		SDL_Surface* surface_;
+	}; // end class
+
+} // end namespace
+#endif
+
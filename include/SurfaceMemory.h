@@ -0,0 +1,114 @@
+
+// CODESTYLE: v2.0
+
+// SurfaceMemory.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: accounts for the memory held by every surface the engine creates
+
+/**
+ * @file SurfaceMemory.h
+ * @brief Surface Memory Accounting - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __SURFACEMEMORY_H__
+#define __SURFACEMEMORY_H__
+
+#include <cstdio>
+
+struct SDL_Surface;
+
+namespace LOFI
+{
+	/// what a surface is used for
+	enum SurfaceCategory
+	{
+		/// images loaded through the ResourceCache: walls, overlays and font sheets
+		SURFACE_CATEGORY_IMAGES,
+
+		/// the glyph images fonts draw from
+		SURFACE_CATEGORY_FONTS,
+
+		/// the mini-map
+		SURFACE_CATEGORY_MINIMAP,
+
+		/// the video surface and the screens drawn into before it
+		SURFACE_CATEGORY_SCREENS,
+
+		/// the rendered runs of text kept by a TextCache
+		SURFACE_CATEGORY_TEXT,
+
+		SURFACE_CATEGORY_COUNT
+	};
+
+	/**
+	 * @brief asks a cache to free some of its surfaces because the budget is exceeded
+	 * @return true if anything was freed, false if there was nothing it could let go of
+	 */
+	typedef bool (*SurfaceEvictor)(void* userData);
+
+	/**
+	 * @class SurfaceMemory
+	 * @brief accounts for the memory held by every surface the engine creates
+	 *
+	 * Each surface is tracked from the moment it is created until it is freed, with
+	 * the bytes of its pixels counted against its category. The totals and their
+	 * high-water marks show where the memory goes. When a budget is set,
+	 * EnforceBudget() asks the registered caches to evict until the total fits again.
+	 * Only ever used from the main thread.
+	 */
+	class SurfaceMemory
+	{
+	public:
+		/// starts counting @a surface against @a category; does nothing for null
+		static void Track(SDL_Surface* surface, SurfaceCategory category);
+
+		/// stops counting @a surface, just before it is freed; does nothing for a surface that is not tracked
+		static void Untrack(SDL_Surface* surface);
+
+		/// gets the bytes held by the surfaces of @a category
+		static unsigned long GetBytes(SurfaceCategory category);
+
+		/// gets the most bytes the surfaces of @a category have held at once
+		static unsigned long GetHighWaterBytes(SurfaceCategory category);
+
+		/// gets the bytes held by every tracked surface
+		static unsigned long GetTotalBytes();
+
+		/// gets the most bytes every tracked surface has held at once
+		static unsigned long GetTotalHighWaterBytes();
+
+		/// sets the most bytes the tracked surfaces should hold, zero for no limit
+		static void SetBudget(unsigned long bytes);
+
+		/// gets the budget, zero for no limit
+		static unsigned long GetBudget();
+
+		/// registers @a evictor to be called with @a userData when the budget is exceeded; evictors are asked in the order they were added
+		static void AddEvictor(SurfaceEvictor evictor, void* userData);
+
+		/// unregisters an evictor added with the same @a evictor and @a userData
+		static void RemoveEvictor(SurfaceEvictor evictor, void* userData);
+
+		/**
+		 * @brief asks the evictors to free surfaces until the total is within the budget
+		 * @note call between frames, when no surface is in the middle of being drawn
+		 * @return true if the total is within the budget
+		 */
+		static bool EnforceBudget();
+
+		/// writes the totals and high-water marks of every category to @a fp
+		static void WriteReport(FILE* fp);
+
+		/// gets the name of @a category for reports
+		static const char* GetCategoryName(SurfaceCategory category);
+
+	private:
+		/// hidden constructor
+		SurfaceMemory();
+	}; // end class
+
+} // end namespace
+#endif
+
@@ -0,0 +1,131 @@
+
+// CODESTYLE: v2.0
+
+// TextCache.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: keeps rendered runs of text so unchanged lines are drawn with one blit
+
+/**
+ * @file TextCache.h
+ * @brief Text Run Cache - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __TEXTCACHE_H__
+#define __TEXTCACHE_H__
+
+#include <cstdio>
+#include <list>
+#include <map>
+#include <string>
+
+struct SDL_Surface;
+
+namespace LOFI
+{
+	class BitmapFont;
+
+	/// the most runs of text kept rendered before the least recently drawn are freed
+	const unsigned int TEXTCACHE_DEFAULT_CAPACITY = 32;
+
+	/**
+	 * @class TextCache
+	 * @brief keeps rendered runs of text so unchanged lines are drawn with one blit
+	 *
+	 * Each run is a string printed with a font onto a surface of its own, keyed on
+	 * the font's generation and a hash of the string, so looking a run up
+	 * allocates nothing, and a font destroyed and replaced by another at the same
+	 * address never finds the old one's runs. Printing a run that is cached blits that surface; anything
+	 * else is printed into a new surface once and cached.
+	 * The runs are kept on a least recently used list, and the oldest are freed when
+	 * there are more than the capacity or the surfaces are over their memory budget.
+	 * The color of the text is the color of the font image, so it is part of the key
+	 * through the generation, which changes with the font image.
+	 */
+	class TextCache
+	{
+	public:
+		/// constructor - keeps at most @a capacity runs
+		explicit TextCache(unsigned int capacity = TEXTCACHE_DEFAULT_CAPACITY);
+
+		/// destructor - frees every run
+		~TextCache();
+
+		/**
+		 * @brief prints @a text with @a font on @a destination at @a x, @a y, the same as BitmapFont::Print() would
+		 * @note the text is printed as it is, it is not a format string
+		 */
+		void Print(BitmapFont* font, SDL_Surface* destination, int x, int y, const char* text);
+
+		/// prints the first @a length letters of @a text, see Print(); for text built with a TextFormatter
+		void Print(BitmapFont* font, SDL_Surface* destination, int x, int y, const char* text, unsigned int length);
+
+		/// frees every run; the runs of a font that was destroyed or reloaded are never drawn again, and age out without this
+		void Clear();
+
+		/// gets the number of runs that are rendered
+		unsigned int GetRunCount() const;
+
+		/// writes the number of runs and the hit rate to @a fp
+		void WriteReport(FILE* fp) const;
+
+	private:
+		/// what a run is looked up by
+		struct TextRunKey
+		{
+			unsigned int fontGeneration_;
+			unsigned int hash_;
+			unsigned int length_;
+
+			bool operator<(const TextRunKey& rhs) const;
+		};
+
+		/// a rendered run of text
+		struct TextRun
+		{
+			TextRunKey key_;
+			std::string text_;
+			SDL_Surface* surface_;
+		};
+
+		typedef std::list<TextRun> TextRunList;
+
+		/**
+		 * @brief prints @a text with @a font onto a new surface in the format of @a destination
+		 * @return the surface, or null if it could not be created or nothing of the text is visible
+		 */
+		static SDL_Surface* RenderRun(BitmapFont* font, SDL_Surface* destination, const char* text, unsigned int length);
+
+		/// hashes the first @a length letters of @a text
+		static unsigned int HashText(const char* text, unsigned int length);
+
+		/// frees the least recently drawn run; false if there are none
+		bool EvictOldestRun();
+
+		/// the SurfaceEvictor that frees a run when all of the surfaces are over their budget
+		static bool EvictForSurfaceBudget(void* userData);
+
+		/// the runs, the most recently drawn first
+		TextRunList runs_;
+
+		/// the runs by key
+		std::map<TextRunKey, TextRunList::iterator> runsByKey_;
+
+		/// the most runs to keep
+		unsigned int capacity_;
+
+		/// the number of prints that found their run cached
+		unsigned int hits_;
+
+		/// the number of prints that had to render their run
+		unsigned int misses_;
+
+		/// not copyable
+		TextCache(const TextCache&);
+		TextCache& operator=(const TextCache&);
+	}; // end class
+
+} // end namespace
+#endif
+
@@ -0,0 +1,111 @@
+
+// CODESTYLE: v2.0
+
+// TextFormatter.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: builds short lines of text in a fixed buffer without a format string
+
+/**
+ * @file TextFormatter.h
+ * @brief Text Formatter - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __TEXTFORMATTER_H__
+#define __TEXTFORMATTER_H__
+
+namespace LOFI
+{
+	/// the longest line a TextFormatter holds, less one for the terminator; anything longer is cut off
+	const unsigned int TEXTFORMATTER_CAPACITY = 0x100;
+
+	/// a number to be written right aligned in at least @a width_ letters, the same as "%*d"
+	struct PaddedNumber
+	{
+		int value_;
+		int width_;
+	};
+
+	/// makes a PaddedNumber, so a formatter can be written to like: formatter << Padded(playerX, 2)
+	inline PaddedNumber Padded(int value, int width)
+	{
+		PaddedNumber padded;
+		padded.value_ = value;
+		padded.width_ = width;
+		return padded;
+	}
+
+	/// the facing to be written by name, see Position::facing_
+	struct DirectionName
+	{
+		int facing_;
+	};
+
+	/// makes a DirectionName, so a formatter can be written to like: formatter << Direction(facing)
+	inline DirectionName Direction(int facing)
+	{
+		DirectionName direction;
+		direction.facing_ = facing;
+		return direction;
+	}
+
+	/**
+	 * @class TextFormatter
+	 * @brief builds short lines of text in a fixed buffer without a format string
+	 *
+	 * Each piece of the line is written with the overload for its type, so there is
+	 * no format string for the compiler to miss a mismatch in, no locale, and nothing
+	 * allocated; the line is kept terminated as it grows and can be handed straight to
+	 * BitmapFont::PrintText() with its length.
+	 */
+	class TextFormatter
+	{
+	public:
+		/// constructor - an empty line
+		TextFormatter();
+
+		/// empties the line
+		TextFormatter& Clear();
+
+		/// writes @a text
+		TextFormatter& operator<<(const char* text);
+
+		/// writes @a letter
+		TextFormatter& operator<<(char letter);
+
+		/// writes @a value in decimal
+		TextFormatter& operator<<(int value);
+
+		/// writes @a value in decimal
+		TextFormatter& operator<<(unsigned int value);
+
+		/// writes a number right aligned, padded with spaces
+		TextFormatter& operator<<(const PaddedNumber& number);
+
+		/// writes the name of a facing: North, East, South or West
+		TextFormatter& operator<<(const DirectionName& direction);
+
+		/// gets the line, always terminated
+		const char* GetText() const;
+
+		/// gets the number of letters in the line
+		unsigned int GetLength() const;
+
+		/// gets the name of @a facing, or "<Invalid Direction>"
+		static const char* GetDirectionName(int facing);
+
+	private:
+		/// writes @a magnitude in decimal with a minus sign if @a negative, padded to @a width letters
+		void AppendNumber(unsigned int magnitude, bool negative, int width);
+
+		/// the line and its terminator
+		char text_[TEXTFORMATTER_CAPACITY];
+
+		/// the number of letters in the line
+		unsigned int length_;
+	}; // end class
+
+} // end namespace
+#endif
+
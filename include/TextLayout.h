@@ -0,0 +1,112 @@
+
+// CODESTYLE: v2.0
+
+// TextLayout.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: measures, wraps and aligns text once so it can be drawn again cheaply
+
+/**
+ * @file TextLayout.h
+ * @brief Text Layout - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __TEXTLAYOUT_H__
+#define __TEXTLAYOUT_H__
+
+#include <string>
+#include <vector>
+
+struct SDL_Surface;
+struct SDL_Rect;
+
+namespace LOFI
+{
+	class BitmapFont;
+	class TextCache;
+
+	/// where each line of a TextLayout sits across the width of its box
+	enum TextAlignment
+	{
+		TEXT_ALIGN_LEFT,
+		TEXT_ALIGN_CENTER,
+		TEXT_ALIGN_RIGHT
+	};
+
+	/**
+	 * @class TextLayout
+	 * @brief measures, wraps and aligns text once so it can be drawn again cheaply
+	 *
+	 * Layout() breaks the text into lines at each '\\n', and at the last space that
+	 * keeps a line within the wrap width, or between letters when a word is wider
+	 * than the box on its own. Each line is measured with the font and placed by the
+	 * alignment, and the result is kept until the next Layout(), so drawing it is
+	 * only printing the lines where they already are.
+	 */
+	class TextLayout
+	{
+	public:
+		/// constructor - an empty layout
+		TextLayout();
+
+		/**
+		 * @brief lays @a text out with @a font
+		 * @param wrapWidth is the width of the box in pixels the lines are wrapped to and aligned in,
+		 * or zero to only break lines at '\\n' and align them within the widest
+		 * @param alignment is where each line sits across the box
+		 */
+		void Layout(BitmapFont* font, const char* text, int wrapWidth = 0, TextAlignment alignment = TEXT_ALIGN_LEFT);
+
+		/**
+		 * @brief draws the lines with the top left of the box at @a x, @a y
+		 * @param textCache draws each line from the cache when given, otherwise they are printed
+		 * @param clip limits the drawing to this rectangle of @a destination when given, as well as its clip rect
+		 */
+		void Draw(SDL_Surface* destination, int x, int y, TextCache* textCache = 0, const SDL_Rect* clip = 0) const;
+
+		/// gets the width of the widest line in pixels
+		int GetWidth() const;
+
+		/// gets the height of all of the lines in pixels
+		int GetHeight() const;
+
+		/// gets the number of lines
+		unsigned int GetLineCount() const;
+
+		/// gets the text that was laid out
+		const char* GetText() const;
+
+	private:
+		/// one laid out line, a range of the text
+		struct TextLine
+		{
+			unsigned int start_;
+			unsigned int length_;
+			int x_;
+			int y_;
+			int width_;
+		};
+
+		/// adds the line from @a start to @a end of the text, @a width pixels wide
+		void AddLine(unsigned int start, unsigned int end, int width);
+
+		/// the font the text was laid out with
+		BitmapFont* font_;
+
+		/// the text
+		std::string text_;
+
+		/// the lines, top to bottom
+		std::vector<TextLine> lines_;
+
+		/// the width of the widest line
+		int width_;
+
+		/// the height of all of the lines
+		int height_;
+	}; // end class
+
+} // end namespace
+#endif
+
@@ -0,0 +1,108 @@
+
+// CODESTYLE: v2.0
+
+// ThreadPool.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: a fixed set of worker threads that run queued jobs
+
+/**
+ * @file ThreadPool.h
+ * @brief Thread Pool - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#include <deque>
+#include <vector>
+
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+
+namespace LOFI
+{
+	/// the function signature of a job run by the pool
+	typedef void (*ThreadPoolJob)(void* userData);
+
+	/**
+	 * @class ThreadPool
+	 * @brief a fixed set of worker threads that run queued jobs
+	 *
+	 * Jobs are taken off a single queue in the order they were submitted.
+	 * A pool with no worker threads runs each job on the submitting thread
+	 * inside Submit(), so callers never need a separate serial code path.
+	 */
+	class ThreadPool
+	{
+	public:
+		/// constructor - starts @a threadCount workers, or one less than the number of processors if negative
+		explicit ThreadPool(int threadCount = -1);
+
+		/// destructor - finishes the queued jobs and stops the workers
+		~ThreadPool();
+
+		/// queues @a job to be called with @a userData on one of the workers
+		void Submit(ThreadPoolJob job, void* userData = 0);
+
+		/// blocks until every submitted job has finished
+		void WaitAll();
+
+		/**
+		 * @brief blocks until *@a pendingCount drops to zero, leaving the pool's other jobs running
+		 * @note the jobs being waited on must each decrement the count when they finish
+		 */
+		void WaitFor(volatile int* pendingCount);
+
+		/// gets the number of worker threads
+		int GetThreadCount() const;
+
+		/// gets the number of processors that are online, or 1 if that can't be found out
+		static int GetProcessorCount();
+
+	private:
+
+		/// a queued job
+		struct Job
+		{
+			ThreadPoolJob job_;
+			void* userData_;
+		};
+
+		/// the worker thread - runs jobs until the pool is destroyed
+		static int WorkerThread(void* userData);
+
+		/// the worker threads
+		std::vector<SDL_Thread*> workers_;
+
+		/// the jobs that have not been picked up yet
+		std::deque<Job> jobs_;
+
+		/// the number of jobs that have been submitted and have not finished
+		int pendingJobs_;
+
+		/// is the pool shutting down
+		bool stopping_;
+
+		/// guards jobs_, pendingJobs_ and stopping_
+		SDL_mutex* lock_;
+
+		/// signalled when a job is queued or the pool is shutting down
+		SDL_cond* jobAvailable_;
+
+		/// signalled when pendingJobs_ drops to zero
+		SDL_cond* allJobsDone_;
+
+		/// signalled each time a job finishes
+		SDL_cond* jobDone_;
+
+		/// not copyable
+		ThreadPool(const ThreadPool&);
+		ThreadPool& operator=(const ThreadPool&);
+	}; // end class
+
+} // end namespace
+#endif
+
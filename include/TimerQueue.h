@@ -0,0 +1,93 @@
+
+// CODESTYLE: v2.0
+
+// TimerQueue.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: schedules delayed actions against the engine's simulation clock
+
+/**
+ * @file TimerQueue.h
+ * @brief Timer Queue - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __TIMERQUEUE_H__
+#define __TIMERQUEUE_H__
+
+#include <vector>
+
+namespace LOFI
+{
+	/// the function signature of a timer callback
+	typedef void (*TimerCallback)(void* userData);
+
+	/// identifies a scheduled timer; zero is never a valid timer
+	typedef unsigned int TimerID;
+
+	/**
+	 * @class TimerQueue
+	 * @brief schedules delayed actions against the engine's simulation clock
+	 *
+	 * Timers are kept in a binary min-heap ordered by their due time, so scheduling
+	 * and firing are O(log n), and checking for nothing-to-do is O(1).
+	 * The queue has no clock of its own; it is driven by Advance() from the fixed
+	 * simulation step, so timers fire at the same simulated time on every machine.
+	 */
+	class TimerQueue
+	{
+	public:
+		/// constructor
+		TimerQueue();
+
+		/// destructor
+		~TimerQueue();
+
+		/**
+		 * @brief schedules @a callback to be called once @a delay microseconds from now
+		 * @return the id of the timer, which can be passed to Cancel()
+		 */
+		TimerID Schedule(Microseconds delay, TimerCallback callback, void* userData = 0);
+
+		/**
+		 * @brief cancels a pending timer
+		 * @return true if the timer was pending, false if it already fired or never existed
+		 */
+		bool Cancel(TimerID timerID);
+
+		/// moves the queue's notion of "now" forward by @a elapsed and fires every timer that came due
+		void Advance(Microseconds elapsed);
+
+		/// cancels every pending timer
+		void Clear();
+
+		/// gets the current time of the queue in microseconds
+		Microseconds GetTime() const;
+
+	private:
+
+		/// a scheduled timer
+		struct Timer
+		{
+			Microseconds due_;
+			TimerID id_;
+			TimerCallback callback_;
+			void* userData_;
+		};
+
+		/// heap ordering - the soonest timer sorts to the top, ties fire in scheduling order
+		static bool FiresLater(const Timer& lhs, const Timer& rhs);
+
+		/// the pending timers, kept as a heap
+		std::vector<Timer> timers_;
+
+		/// the current time of the queue
+		Microseconds now_;
+
+		/// the id handed out to the next scheduled timer
+		TimerID nextID_;
+	}; // end class
+
+} // end namespace
+#endif
+
@@ -0,0 +1,72 @@
+
+// CODESTYLE: v2.0
+
+// TraceRecorder.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: records the profiler's timed scopes to a Chrome trace_event JSON file
+
+/**
+ * @file TraceRecorder.h
+ * @brief Trace Recorder - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __TRACERECORDER_H__
+#define __TRACERECORDER_H__
+
+namespace LOFI
+{
+	/// the number of events the ring buffer holds before new events are dropped
+	const unsigned int TRACE_RING_CAPACITY = 0x10000;
+
+	/**
+	 * @class TraceRecorder
+	 * @brief records the profiler's timed scopes to a Chrome trace_event JSON file
+	 *
+	 * Events are pushed into a fixed ring buffer without taking a lock, and a background
+	 * thread drains the ring and does all of the formatting and file I/O, so a long
+	 * trace does not cost the frame loop anything beyond the push. If the writer falls
+	 * a whole ring behind, new events are dropped and counted rather than waited on.
+	 * The file can be opened in chrome://tracing or the Perfetto UI.
+	 */
+	class TraceRecorder
+	{
+	public:
+		/**
+		 * @brief starts recording to @a filePath, replacing any existing file
+		 * @return true on success, and false if the file or the writer thread could not be created
+		 */
+		static bool Start(const char* filePath);
+
+		/// stops recording, writes out every pending event and closes the file
+		static void Stop();
+
+		/// is a trace being recorded
+		static bool IsRecording();
+
+		/**
+		 * @brief records a complete event
+		 * @param name is the event name; it must be a string that outlives the trace, like a literal
+		 * @param start is the start of the event in microseconds of the monotonic clock
+		 * @param duration is the length of the event in microseconds
+		 */
+		static void Record(const char* name, Microseconds start, Microseconds duration);
+
+		/// gets the number of events dropped because the ring buffer was full
+		static unsigned long GetDroppedEventCount();
+
+	private:
+		/// the writer thread - drains the ring buffer to the file until recording stops
+		static int WriterThread(void* userData);
+
+		/// writes every event that is ready in the ring buffer to the file
+		static void Drain();
+
+		/// hidden constructor
+		TraceRecorder();
+	}; // end class
+
+} // end namespace
+#endif
+
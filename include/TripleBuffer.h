@@ -0,0 +1,119 @@
+
+// CODESTYLE: v2.0
+
+// TripleBuffer.h
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: hands the latest copy of some state from one thread to another without either waiting on a lock
+
+/**
+ * @file TripleBuffer.h
+ * @brief Lock-Free Triple Buffer - Header
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#ifndef __TRIPLEBUFFER_H__
+#define __TRIPLEBUFFER_H__
+
+namespace LOFI
+{
+	/**
+	 * @class TripleBuffer
+	 * @brief hands the latest copy of some state from one thread to another without either waiting on a lock
+	 *
+	 * There are three copies of the state: the one the writer is filling in, the
+	 * one the reader is using, and the one that was published last. Publishing
+	 * swaps the writer's copy with the published one, and taking the latest swaps
+	 * the reader's copy with it, each with a single compare-and-swap, so neither
+	 * thread ever waits on the other. The reader always gets the newest state
+	 * published; states published in between are skipped.
+	 * There must be only one writer thread and one reader thread.
+	 */
+	template <typename T>
+	class TripleBuffer
+	{
+	public:
+		/// constructor - each thread starts with a copy of its own
+		TripleBuffer() :
+			writeIndex_(0),
+			publishedIndex_(1),
+			readIndex_(2)
+		{
+		}
+
+		/**
+		 * @brief gets the copy the writer fills in before it calls Publish()
+		 * @note the copy holds whatever was published some time before, so every field has to be written
+		 */
+		T& GetWriteBuffer()
+		{
+			return buffers_[writeIndex_];
+		}
+
+		/// publishes the writer's copy, so the reader gets it on its next TakeLatest()
+		void Publish()
+		{
+			writeIndex_ = this->ExchangePublished(writeIndex_ | TRIPLEBUFFER_FRESH) & TRIPLEBUFFER_INDEX;
+		}
+
+		/**
+		 * @brief swaps the reader's copy for the latest one published
+		 * @return true if anything was published since the last time, false if the reader's copy is still the latest
+		 */
+		bool TakeLatest()
+		{
+			if (!(publishedIndex_ & TRIPLEBUFFER_FRESH))
+			{
+				return false;
+			}
+
+			readIndex_ = this->ExchangePublished(readIndex_) & TRIPLEBUFFER_INDEX;
+			return true;
+		}
+
+		/// gets the reader's copy, the latest taken with TakeLatest()
+		const T& GetReadBuffer() const
+		{
+			return buffers_[readIndex_];
+		}
+
+	private:
+		/// the bits of publishedIndex_ that are the index of the published copy
+		static const int TRIPLEBUFFER_INDEX = 0x3;
+
+		/// the bit of publishedIndex_ that is set when the reader has not taken the published copy yet
+		static const int TRIPLEBUFFER_FRESH = 0x4;
+
+		/// puts @a value in publishedIndex_, and gives back what was there
+		int ExchangePublished(int value)
+		{
+			int previous = 0;
+
+			do
+			{
+				previous = publishedIndex_;
+			} while (!__sync_bool_compare_and_swap(&publishedIndex_, previous, value));
+
+			return previous;
+		}
+
+		/// the three copies
+		T buffers_[3];
+
+		/// the copy the writer owns
+		int writeIndex_;
+
+		/// the copy published last, and whether it has been taken
+		volatile int publishedIndex_;
+
+		/// the copy the reader owns
+		int readIndex_;
+
+		/// not copyable
+		TripleBuffer(const TripleBuffer&);
+		TripleBuffer& operator=(const TripleBuffer&);
+	}; // end class
+
+} // end namespace
+#endif
+
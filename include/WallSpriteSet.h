@@ -15,10 +15,66 @@
 #ifndef __WALLSPRITESET_H__
 #define __WALLSPRITESET_H__
 
+#include <string>
+#include <vector>
+
 struct SDL_Surface;
 
 namespace LOFI
 {
+	class AssetLoader;
+
+	/// where one image of a wall set lies on its sheet
+	struct WallImageRect
+	{
+		int x_;
+		int y_;
+		int w_;
+		int h_;
+	};
+
+	/**
+	 * @struct WallSetDefinition
+	 * @brief describes where a wall set's images come from
+	 *
+	 * A set is either a directory holding f0.png, l0.png, r0.png and so on for
+	 * each range, a single atlas sheet with a rectangle for each of those images,
+	 * or a single square texture that the images are generated from when the set
+	 * loads. A generated set is laid out on a sheet of its own too, which the
+	 * rectangles describe, and the size of each rectangle is the size of the image
+	 * that is warped into it.
+	 */
+	struct WallSetDefinition
+	{
+		/// the directory of the images, ending in a slash, or empty for an atlas
+		std::string rootPath_;
+
+		/// the atlas sheet, or empty for a directory
+		std::string atlasPath_;
+
+		/// the texture the images are generated from, or empty
+		std::string texturePath_;
+
+		/// the number of ranges the set has images for
+		int visibleDepth_;
+
+		/// the rectangles of the front, left and right images on the sheet, one per range
+		std::vector<WallImageRect> frontRects_;
+		std::vector<WallImageRect> leftRects_;
+		std::vector<WallImageRect> rightRects_;
+
+		WallSetDefinition() : visibleDepth_(0) {}
+
+		/// is the set cut from an atlas sheet
+		bool IsAtlas() const { return !atlasPath_.empty(); }
+
+		/// is the set generated from a texture
+		bool IsGenerated() const { return !texturePath_.empty(); }
+
+		/// gets the path the set's sheet is cached under; a generated sheet is cached next to its texture, so reloading the texture detaches it too
+		std::string GetSheetPath() const { return (this->IsGenerated()) ? texturePath_ + "#perspective" : atlasPath_; }
+	};
+
 	/**
 	 * @class WallSpriteSet
 	 * @brief C++ port of Java public class com.scrimisms.LofiWanderings.WallSpriteSet
@@ -26,15 +82,34 @@ namespace LOFI
 	class WallSpriteSet
 	{
 	public:
-		WallSpriteSet(const char* rootPath);
+		/**
+		 * @brief loads the set's images now, or queues them on @a assetLoader to arrive when it finishes
+		 * @note a set cut from a sheet queued on @a assetLoader also needs FinishLoading() once the loader is done
+		 */
+		WallSpriteSet(const WallSetDefinition& definition, AssetLoader* assetLoader = 0);
+
+		/// cuts the images out of the set's sheet once it has loaded; does nothing for a directory set
+		void FinishLoading();
+
 		SDL_Surface* GetFrontImage(int range);
 		SDL_Surface* GetLeftImage(int range);
 		SDL_Surface* GetRightImage(int range);
+		
+		/// gets the number of bytes of pixel data in the set's images
+		unsigned long GetMemoryBytes() const;
 		~WallSpriteSet();
 	private:
-		SDL_Surface** frontImages_;
-		SDL_Surface** leftImages_;
-		SDL_Surface** rightImages_;
+		/// gets a reference to the part @a rect of the converted @a sheet, shared through the ResourceCache
+		static SDL_Surface* CutImage(SDL_Surface* sheet, const std::string& sheetPath, const WallImageRect& rect);
+
+		/// the ImageDecoder that warps a generated set's texture into its sheet
+		static SDL_Surface* GenerateSheet(const char* sheetPath, const void* userData);
+
+		WallSetDefinition definition_;
+		ImageHandle sheet_;
+		ImageHandle* frontImages_;
+		ImageHandle* leftImages_;
+		ImageHandle* rightImages_;
 		int visibleDepth_;
 	}; // end class
 
@@ -28,6 +28,9 @@
 	#include <vector>
 	#include <string>
 	#include <map>
+	#include <set>
+	#include <list>
+	#include <sstream>
 	#include <algorithm>
 
 	// SDL
@@ -46,14 +49,31 @@
 
 
 	// GAME
+	#include "Clock.h"
+	#include "TimerQueue.h"
+	#include "Profiler.h"
+	#include "TraceRecorder.h"
+	#include "ThreadPool.h"
+	#include "AssetArchive.h"
+	#include "PixelCache.h"
+	#include "SurfaceMemory.h"
+	#include "Presenter.h"
+	#include "ResourceCache.h"
+	#include "AssetLoader.h"
+	#include "AssetWatcher.h"
 	#include "Map.h"
 	#include "MapView.h"
 	#include "MiniMap.h"
+	#include "MapPyramid.h"
 	#include "Position.h"
 	#include "WallSpriteSet.h"
 	#include "ArtManager.h"
 	#include "BitmapFont.h"
+	#include "TextFormatter.h"
+	#include "TextCache.h"
+	#include "TextLayout.h"
 	#include "GameState.h"
+	#include "TripleBuffer.h"
 	#include "Engine.h"
 		
 	
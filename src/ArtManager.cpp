@@ -18,15 +18,38 @@
 
 namespace LOFI
 {
-	ArtManager::ArtManager()
+	ArtManager::ArtManager(ThreadPool* threadPool) :
+		oldestSlot_(-1),
+		newestSlot_(-1),
+		residentBytes_(0),
+		memoryBudget_(ART_DEFAULT_MEMORY_BUDGET),
+		loadedCount_(0),
+		frameNumber_(0),
+		threadPool_(threadPool),
+		prefetchLoader_(0),
+		reloadLoader_(0)
 	{
 		allArtLoadedSuccessfully_ = this->LoadArt();
+		
+		// the wall sets are the first thing to go when the surfaces are over their budget
+		SurfaceMemory::AddEvictor(ArtManager::EvictForSurfaceBudget, this);
 	}
 	
 	////////////////////////////////////////////////////////////////////////////
 	
 	ArtManager::~ArtManager()
 	{
+		SurfaceMemory::RemoveEvictor(ArtManager::EvictForSurfaceBudget, this);
+		
+		// the workers may still be writing into the sets being prefetched or rebuilt
+		this->FinishPrefetch();
+		delete reloadLoader_;
+		
+		for (unsigned int index = 0; index < allWallSprites_.size(); index++)
+		{
+			delete allWallSprites_[index].set_;
+			delete allWallSprites_[index].reloadedSet_;
+		}
 		allWallSprites_.clear();
 	}
 	
@@ -41,7 +64,35 @@ namespace LOFI
 	
 	WallSpriteSet* ArtManager::GetWallSetNumber(unsigned int which)
 	{
-		return (which > 0 && which <= allWallSprites_.size()) ? allWallSprites_.at(which - 1) : 0 ;
+		if (which < 1 || which > allWallSprites_.size())
+		{
+			return 0;
+		}
+		
+		int slot = static_cast<int>(which - 1);
+		WallSetSlot& wallSet = allWallSprites_[slot];
+		
+		if (!wallSet.registered_)
+		{
+			return 0;
+		}
+		
+		if (wallSet.prefetching_)
+		{
+			// it is already on its way, so just wait for the rest of the batch
+			this->FinishPrefetch();
+		}
+		
+		if (!wallSet.set_)
+		{
+			this->LoadWallSet(slot);
+		}
+		
+		wallSet.lastUsedFrame_ = frameNumber_;
+		this->TouchSlot(slot);
+		this->EvictToBudget();
+		
+		return wallSet.set_;
 	}
 
 	////////////////////////////////////////////////////////////////////////////
@@ -108,12 +159,651 @@ namespace LOFI
 	
 	bool ArtManager::LoadArt()
 	{
-		allWallSprites_.push_back(new WallSpriteSet("resources/first_wall/"));
-		allWallSprites_.push_back(new WallSpriteSet("resources/stone_wall/"));
-		allWallSprites_.push_back(new WallSpriteSet("resources/wood_wall/"));
-		allWallSprites_.push_back(new WallSpriteSet("resources/metal_wall/"));
+		return this->LoadManifest(ART_DEFAULT_MANIFEST_PATH);
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	bool ArtManager::LoadManifest(const char* manifestPath)
+	{
+		std::string text;
+		
+		// the manifest is packed into the asset archive along with the art
+		AssetArchiveEntry entry;
+		if (AssetArchive::Find(manifestPath, &entry))
+		{
+			text.assign(reinterpret_cast<const char*>(AssetArchive::GetData(entry)), entry.dataSize_);
+		}
+		else
+		{
+			FILE* fp = fopen(manifestPath, "rb");
+			if (!fp)
+			{
+				// log the error
+				WriteLog(stderr, "Unable to open the wall manifest \"%s\"!\n", manifestPath);
+				
+				// return failure
+				return false;
+			}
+			
+			char buffer[0x1000];
+			size_t bytesRead;
+			while ((bytesRead = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+			{
+				text.append(buffer, bytesRead);
+			}
+			fclose(fp);
+		}
+		
+		bool succeeded = true;
+		unsigned int setCount = 0;
+		
+		// the atlas set whose rectangles are being read, and the ranges it still needs
+		WallSetDefinition atlas;
+		unsigned int atlasId = 0;
+		
+		std::istringstream lines(text);
+		std::string line;
+		
+		for (int lineNumber = 1; std::getline(lines, line); lineNumber++)
+		{
+			std::string::size_type comment = line.find('#');
+			if (std::string::npos != comment)
+			{
+				line.erase(comment);
+			}
+			
+			std::istringstream fields(line);
+			std::string keyword;
+			if (!(fields >> keyword))
+			{
+				// a blank line
+				continue;
+			}
+			
+			if ("wall" == keyword || "atlas" == keyword || "texture" == keyword)
+			{
+				if (atlasId)
+				{
+					this->RegisterWallSet(atlasId, atlas);
+					atlasId = 0;
+				}
+				
+				unsigned int which = 0;
+				WallSetDefinition definition;
+				std::string path;
+				
+				if (!(fields >> which >> definition.visibleDepth_ >> path) ||
+					which < 1 || which > ART_MAX_WALL_ID ||
+					definition.visibleDepth_ < 1 || definition.visibleDepth_ > ART_MAX_VISIBLE_DEPTH)
+				{
+					// log the error
+					WriteLog(stderr, "%s:%d: expected \"%s <id> <depth> <path>\"!\n", manifestPath, lineNumber, keyword.c_str());
+					succeeded = false;
+					continue;
+				}
+				
+				if ("texture" == keyword)
+				{
+					if (definition.visibleDepth_ > ART_VIEW_DEPTH)
+					{
+						// log the error
+						WriteLog(stderr, "%s:%d: the view only has room for %d ranges of walls!\n", manifestPath, lineNumber, ART_VIEW_DEPTH);
+						succeeded = false;
+						continue;
+					}
+					
+					definition.texturePath_ = path;
+					this->LayoutGeneratedSet(&definition);
+					
+					this->RegisterWallSet(which, definition);
+				}
+				else if ("wall" == keyword)
+				{
+					if ('/' != path[path.size() - 1])
+					{
+						path += '/';
+					}
+					definition.rootPath_ = path;
+					
+					this->RegisterWallSet(which, definition);
+				}
+				else
+				{
+					// every rectangle starts out empty, so a missing one is caught when the set is cut
+					WallImageRect emptyRect = { 0, 0, 0, 0 };
+					definition.atlasPath_ = path;
+					definition.frontRects_.assign(definition.visibleDepth_, emptyRect);
+					definition.leftRects_.assign(definition.visibleDepth_, emptyRect);
+					definition.rightRects_.assign(definition.visibleDepth_, emptyRect);
+					
+					atlas = definition;
+					atlasId = which;
+				}
+				
+				setCount++;
+			}
+			else if (atlasId && 2 <= keyword.size() && ('f' == keyword[0] || 'l' == keyword[0] || 'r' == keyword[0]))
+			{
+				int range = atoi(keyword.c_str() + 1);
+				WallImageRect rect;
+				
+				if (!(fields >> rect.x_ >> rect.y_ >> rect.w_ >> rect.h_) || range < 0 || range >= atlas.visibleDepth_)
+				{
+					// log the error
+					WriteLog(stderr, "%s:%d: expected \"<f|l|r><range> <x> <y> <w> <h>\"!\n", manifestPath, lineNumber);
+					succeeded = false;
+					continue;
+				}
+				
+				std::vector<WallImageRect>& rects =
+					('f' == keyword[0]) ? atlas.frontRects_ :
+					('l' == keyword[0]) ? atlas.leftRects_ : atlas.rightRects_;
+				
+				rects[range] = rect;
+			}
+			else
+			{
+				// log the error
+				WriteLog(stderr, "%s:%d: unknown entry \"%s\"!\n", manifestPath, lineNumber, keyword.c_str());
+				succeeded = false;
+			}
+		}
+		
+		if (atlasId)
+		{
+			this->RegisterWallSet(atlasId, atlas);
+		}
+		
+		if (!setCount)
+		{
+			// log the error
+			WriteLog(stderr, "The wall manifest \"%s\" lists no wall sets!\n", manifestPath);
+			succeeded = false;
+		}
+		
+		return succeeded;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void ArtManager::RegisterWallSet(unsigned int which, const WallSetDefinition& definition)
+	{
+		if (which < 1 || which > ART_MAX_WALL_ID)
+		{
+			return;
+		}
+		
+		if (which > allWallSprites_.size())
+		{
+			WallSetSlot emptySlot;
+			emptySlot.registered_ 		= false;
+			emptySlot.set_ 				= 0;
+			emptySlot.reloadedSet_ 		= 0;
+			emptySlot.bytes_ 			= 0;
+			emptySlot.lastUsedFrame_ 	= 0;
+			emptySlot.prefetching_ 		= false;
+			emptySlot.olderSlot_ 		= -1;
+			emptySlot.newerSlot_ 		= -1;
+			
+			allWallSprites_.resize(which, emptySlot);
+		}
+		
+		WallSetSlot& wallSet = allWallSprites_[which - 1];
+		
+		if (wallSet.set_ || wallSet.prefetching_)
+		{
+			// log the error
+			WriteLog(stderr, "Wall set %u is already loaded and cannot be registered again!\n", which);
+			return;
+		}
+		
+		wallSet.definition_ = definition;
+		wallSet.registered_ = true;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void ArtManager::BeginFrame()
+	{
+		frameNumber_++;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void ArtManager::Prefetch(Map* currentMap, Position* position, int radius)
+	{
+		if (prefetchLoader_)
+		{
+			// only one batch at a time, and never wait on it here
+			if (!prefetchLoader_->IsDecoded())
+			{
+				return;
+			}
+			
+			this->FinishPrefetch();
+		}
+		
+		if (!currentMap || !position)
+		{
+			return;
+		}
+		
+		Position cell(0, 0, 0);
+		
+		for (cell.y_ = position->y_ - radius; cell.y_ <= position->y_ + radius; cell.y_++)
+		{
+			for (cell.x_ = position->x_ - radius; cell.x_ <= position->x_ + radius; cell.x_++)
+			{
+				for (cell.facing_ = 0; cell.facing_ < 4; cell.facing_++)
+				{
+					int which = currentMap->GetWallForCoordinate(&cell);
+					if (which < 1 || which > static_cast<int>(allWallSprites_.size()))
+					{
+						continue;
+					}
+					
+					WallSetSlot& wallSet = allWallSprites_[which - 1];
+					if (wallSet.set_ || wallSet.prefetching_ || !wallSet.registered_)
+					{
+						continue;
+					}
+					
+					if (!prefetchLoader_)
+					{
+						prefetchLoader_ = new AssetLoader(threadPool_, false);
+					}
+					
+					wallSet.set_ = new WallSpriteSet(wallSet.definition_, prefetchLoader_);
+					wallSet.prefetching_ = true;
+					prefetchSlots_.push_back(which - 1);
+				}
+			}
+		}
+		
+		if (prefetchLoader_)
+		{
+			prefetchLoader_->Start();
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void ArtManager::SetMemoryBudget(unsigned long bytes)
+	{
+		memoryBudget_ = bytes;
+		this->EvictToBudget();
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	unsigned long ArtManager::GetResidentBytes() const
+	{
+		return residentBytes_;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	unsigned int ArtManager::GetLoadedWallSetCount() const
+	{
+		return loadedCount_;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void ArtManager::GetArtDirectories(std::vector<std::string>* directories) const
+	{
+		for (unsigned int index = 0; index < allWallSprites_.size(); index++)
+		{
+			const WallSetDefinition& definition = allWallSprites_[index].definition_;
+			
+			std::string directory =
+				(definition.IsAtlas()) ? definition.atlasPath_.substr(0, definition.atlasPath_.rfind('/') + 1) :
+				(definition.IsGenerated()) ? definition.texturePath_.substr(0, definition.texturePath_.rfind('/') + 1) :
+				definition.rootPath_;
+			
+			if (allWallSprites_[index].registered_ && !directory.empty() &&
+				directories->end() == std::find(directories->begin(), directories->end(), directory))
+			{
+				directories->push_back(directory);
+			}
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	unsigned int ArtManager::ReloadImage(const char* filePath)
+	{
+		std::string path(filePath);
+		unsigned int queued = 0;
+		
+		for (unsigned int slot = 0; slot < allWallSprites_.size(); slot++)
+		{
+			WallSetSlot& wallSet = allWallSprites_[slot];
+			const WallSetDefinition& definition = wallSet.definition_;
+			
+			bool usesImage =
+				(definition.IsAtlas()) ? (definition.atlasPath_ == path) :
+				(definition.IsGenerated()) ? (definition.texturePath_ == path) :
+				(path.size() > definition.rootPath_.size() &&
+				0 == path.compare(0, definition.rootPath_.size(), definition.rootPath_) &&
+				std::string::npos == path.find('/', definition.rootPath_.size()));
+			
+			if (!wallSet.set_ || !usesImage)
+			{
+				continue;
+			}
+			
+			// a batch in flight shares the changed image once it lands, except for a sheet generated from the old texture
+			if (wallSet.prefetching_ && !definition.IsGenerated())
+			{
+				continue;
+			}
+			
+			if (staleSlots_.end() == std::find(staleSlots_.begin(), staleSlots_.end(), static_cast<int>(slot)))
+			{
+				staleSlots_.push_back(static_cast<int>(slot));
+			}
+			
+			queued++;
+		}
+		
+		return queued;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	unsigned int ArtManager::InstallReloadedSets()
+	{
+		unsigned int replaced = 0;
+		
+		if (reloadLoader_)
+		{
+			// the old sets are drawn until the new ones are ready, so never wait on them here
+			if (!reloadLoader_->IsDecoded())
+			{
+				return 0;
+			}
+			
+			PROFILE_SCOPE(PROFILE_ZONE_LOADART);
+			
+			reloadLoader_->Finish();
+			delete reloadLoader_;
+			reloadLoader_ = 0;
+			
+			for (unsigned int index = 0; index < reloadSlots_.size(); index++)
+			{
+				WallSetSlot& wallSet = allWallSprites_[reloadSlots_[index]];
+				
+				WallSpriteSet* reloadedSet = wallSet.reloadedSet_;
+				wallSet.reloadedSet_ = 0;
+				reloadedSet->FinishLoading();
+				
+				// it was unloaded while it was being rebuilt, and loads from the new art next time
+				if (!wallSet.set_)
+				{
+					delete reloadedSet;
+					continue;
+				}
+				
+				delete wallSet.set_;
+				wallSet.set_ = reloadedSet;
+				
+				residentBytes_ -= wallSet.bytes_;
+				wallSet.bytes_ = wallSet.set_->GetMemoryBytes();
+				residentBytes_ += wallSet.bytes_;
+				
+				replaced++;
+			}
+			reloadSlots_.clear();
+			
+			if (replaced)
+			{
+				this->EvictToBudget();
+			}
+		}
+		
+		this->StartReloading();
+		
+		return replaced;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void ArtManager::StartReloading()
+	{
+		if (reloadLoader_ || staleSlots_.empty())
+		{
+			return;
+		}
+		
+		std::vector<int> waitingSlots;
+		
+		for (unsigned int index = 0; index < staleSlots_.size(); index++)
+		{
+			int slot = staleSlots_[index];
+			WallSetSlot& wallSet = allWallSprites_[slot];
+			
+			// rebuilt once its prefetch has landed; one that has been unloaded since loads from the new art anyway
+			if (wallSet.prefetching_)
+			{
+				waitingSlots.push_back(slot);
+				continue;
+			}
+			
+			if (!wallSet.set_)
+			{
+				continue;
+			}
+			
+			// a prefetch may have cached a sheet generated from the old texture
+			if (wallSet.definition_.IsGenerated())
+			{
+				ResourceCache::Detach(wallSet.definition_.GetSheetPath().c_str());
+			}
+			
+			if (!reloadLoader_)
+			{
+				reloadLoader_ = new AssetLoader(threadPool_, false);
+			}
+			
+			// every image of the set that did not change comes straight back out of the cache
+			wallSet.reloadedSet_ = new WallSpriteSet(wallSet.definition_, reloadLoader_);
+			reloadSlots_.push_back(slot);
+		}
+		
+		staleSlots_.swap(waitingSlots);
+		
+		if (reloadLoader_)
+		{
+			reloadLoader_->Start();
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void ArtManager::LoadWallSet(int slot)
+	{
+		PROFILE_SCOPE(PROFILE_ZONE_LOADART);
+		
+		WallSetSlot& wallSet = allWallSprites_[slot];
+		
+		wallSet.set_ = new WallSpriteSet(wallSet.definition_);
+		wallSet.bytes_ = wallSet.set_->GetMemoryBytes();
+		
+		residentBytes_ += wallSet.bytes_;
+		loadedCount_++;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void ArtManager::FinishPrefetch()
+	{
+		if (!prefetchLoader_)
+		{
+			return;
+		}
+		
+		PROFILE_SCOPE(PROFILE_ZONE_LOADART);
+		
+		prefetchLoader_->Finish();
+		delete prefetchLoader_;
+		prefetchLoader_ = 0;
+		
+		for (unsigned int index = 0; index < prefetchSlots_.size(); index++)
+		{
+			int slot = prefetchSlots_[index];
+			WallSetSlot& wallSet = allWallSprites_[slot];
+			
+			wallSet.prefetching_ = false;
+			wallSet.set_->FinishLoading();
+			wallSet.bytes_ = wallSet.set_->GetMemoryBytes();
+			
+			residentBytes_ += wallSet.bytes_;
+			loadedCount_++;
+			
+			this->TouchSlot(slot);
+		}
+		prefetchSlots_.clear();
+		
+		this->EvictToBudget();
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void ArtManager::EvictToBudget()
+	{
+		while (memoryBudget_ && residentBytes_ > memoryBudget_ && this->EvictOldestSet())
+		{
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	bool ArtManager::EvictOldestSet()
+	{
+		for (int slot = oldestSlot_; -1 != slot; slot = allWallSprites_[slot].newerSlot_)
+		{
+			WallSetSlot& wallSet = allWallSprites_[slot];
+			
+			// a set drawn this frame may still be in use by the view
+			if (wallSet.lastUsedFrame_ != frameNumber_ && !wallSet.prefetching_)
+			{
+				this->UnlinkSlot(slot);
+				
+				delete wallSet.set_;
+				wallSet.set_ = 0;
+				
+				residentBytes_ -= wallSet.bytes_;
+				wallSet.bytes_ = 0;
+				loadedCount_--;
+				
+				return true;
+			}
+		}
+		
+		return false;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	bool ArtManager::EvictForSurfaceBudget(void* userData)
+	{
+		return static_cast<ArtManager*>(userData)->EvictOldestSet();
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void ArtManager::TouchSlot(int slot)
+	{
+		if (newestSlot_ == slot)
+		{
+			return;
+		}
+		
+		this->UnlinkSlot(slot);
+		
+		WallSetSlot& wallSet = allWallSprites_[slot];
+		wallSet.olderSlot_ = newestSlot_;
+		wallSet.newerSlot_ = -1;
+		
+		if (-1 != newestSlot_)
+		{
+			allWallSprites_[newestSlot_].newerSlot_ = slot;
+		}
+		else
+		{
+			oldestSlot_ = slot;
+		}
+		
+		newestSlot_ = slot;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void ArtManager::UnlinkSlot(int slot)
+	{
+		WallSetSlot& wallSet = allWallSprites_[slot];
+		
+		if (-1 != wallSet.olderSlot_)
+		{
+			allWallSprites_[wallSet.olderSlot_].newerSlot_ = wallSet.newerSlot_;
+		}
+		else if (oldestSlot_ == slot)
+		{
+			oldestSlot_ = wallSet.newerSlot_;
+		}
+		
+		if (-1 != wallSet.newerSlot_)
+		{
+			allWallSprites_[wallSet.newerSlot_].olderSlot_ = wallSet.olderSlot_;
+		}
+		else if (newestSlot_ == slot)
+		{
+			newestSlot_ = wallSet.olderSlot_;
+		}
+		
+		wallSet.olderSlot_ = -1;
+		wallSet.newerSlot_ = -1;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void ArtManager::LayoutGeneratedSet(WallSetDefinition* definition)
+	{
+		definition->frontRects_.resize(definition->visibleDepth_);
+		definition->leftRects_.resize(definition->visibleDepth_);
+		definition->rightRects_.resize(definition->visibleDepth_);
+		
+		// the images go side by side, each as big as the spot the view blits it to
+		int sheetX = 0;
+		
+		// the side walls of the nearest range start at the edges of the view
+		int nearX = 0;
+		int nearHeight = ART_VIEW_HEIGHT;
 		
-		return true;
+		for (int range = 0; range < definition->visibleDepth_; range++)
+		{
+			int frontX = static_cast<int>(this->GetXOffsetCenter(range, 0));
+			int frontY = static_cast<int>(this->GetYOffsetCenter(range, 0));
+			
+			WallImageRect front = { sheetX, 0, ART_VIEW_WIDTH - 2 * frontX, ART_VIEW_HEIGHT - 2 * frontY };
+			sheetX += front.w_;
+			
+			WallImageRect left = { sheetX, 0, frontX - nearX, nearHeight };
+			sheetX += left.w_;
+			
+			WallImageRect right = { sheetX, 0, frontX - nearX, nearHeight };
+			sheetX += right.w_;
+			
+			definition->frontRects_[range] = front;
+			definition->leftRects_[range] = left;
+			definition->rightRects_[range] = right;
+			
+			// the next range's side walls start where this range's front wall is
+			nearX = frontX;
+			nearHeight = front.h_;
+		}
 	}
 } // end namespace
 
@@ -0,0 +1,356 @@
+
+// CODESTYLE: v2.0
+
+// AssetArchive.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: reads resource files out of a single memory-mapped archive
+
+/**
+ * @file AssetArchive.cpp
+ * @brief Asset Archive - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	// the mapped archive
+	static const unsigned char* archiveData = 0;
+	static unsigned long archiveSize = 0;
+	static unsigned int archiveEntryCount = 0;
+	static unsigned int archiveIndexOffset = 0;
+
+	// the files edited since the archive was packed, which are read from disk instead
+	static std::set<std::string> archiveOverrides;
+	static volatile unsigned int archiveOverrideCount = 0;
+	static SDL_mutex* archiveOverrideLock = 0;
+
+	#if defined(_WIN32)
+	static HANDLE archiveFile = INVALID_HANDLE_VALUE;
+	static HANDLE archiveMapping = 0;
+	#endif
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool AssetArchive::Mount(const char* filePath)
+	{
+		AssetArchive::Unmount();
+
+		#if defined(_WIN32)
+
+		archiveFile = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+		if (INVALID_HANDLE_VALUE == archiveFile)
+		{
+			return false;
+		}
+
+		archiveSize = static_cast<unsigned long>(GetFileSize(archiveFile, 0));
+		archiveMapping = CreateFileMappingA(archiveFile, 0, PAGE_READONLY, 0, 0, 0);
+		if (archiveMapping)
+		{
+			archiveData = static_cast<const unsigned char*>(MapViewOfFile(archiveMapping, FILE_MAP_READ, 0, 0, 0));
+		}
+
+		#else
+
+		int fd = open(filePath, O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct stat fileInfo;
+		if (0 == fstat(fd, &fileInfo) && fileInfo.st_size > 0)
+		{
+			archiveSize = static_cast<unsigned long>(fileInfo.st_size);
+
+			void* mapping = mmap(0, archiveSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (MAP_FAILED != mapping)
+			{
+				archiveData = static_cast<const unsigned char*>(mapping);
+			}
+		}
+
+		// the mapping keeps the file alive on its own
+		close(fd);
+
+		#endif
+
+		if (!archiveData)
+		{
+			// log the error
+			WriteLog(stderr, "Unable to map the asset archive \"%s\"!\n", filePath);
+
+			AssetArchive::Unmount();
+
+			// return failure
+			return false;
+		}
+
+		// check the header and that the whole index lies inside the file
+		bool valid = archiveSize >= ASSETARCHIVE_HEADER_SIZE &&
+			0 == memcmp(archiveData, ASSETARCHIVE_MAGIC, 4) &&
+			ASSETARCHIVE_VERSION == AssetArchive::ReadUint32(archiveData + 4);
+
+		if (valid)
+		{
+			archiveEntryCount 	= AssetArchive::ReadUint32(archiveData + 8);
+			archiveIndexOffset 	= AssetArchive::ReadUint32(archiveData + 12);
+
+			valid = archiveIndexOffset <= archiveSize &&
+				archiveEntryCount <= (archiveSize - archiveIndexOffset) / ASSETARCHIVE_ENTRY_SIZE;
+		}
+
+		if (!valid)
+		{
+			// log the error
+			WriteLog(stderr, "\"%s\" is not a version %u asset archive!\n", filePath, ASSETARCHIVE_VERSION);
+
+			AssetArchive::Unmount();
+
+			// return failure
+			return false;
+		}
+
+		WriteLog(stderr, "Mounted asset archive \"%s\" (%u files, %lu bytes).\n", filePath, archiveEntryCount, archiveSize);
+
+		// return success
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetArchive::Unmount()
+	{
+		#if defined(_WIN32)
+
+		if (archiveData)
+		{
+			UnmapViewOfFile(archiveData);
+		}
+
+		if (archiveMapping)
+		{
+			CloseHandle(archiveMapping);
+			archiveMapping = 0;
+		}
+
+		if (INVALID_HANDLE_VALUE != archiveFile)
+		{
+			CloseHandle(archiveFile);
+			archiveFile = INVALID_HANDLE_VALUE;
+		}
+
+		#else
+
+		if (archiveData)
+		{
+			munmap(const_cast<unsigned char*>(archiveData), archiveSize);
+		}
+
+		#endif
+
+		archiveData 		= 0;
+		archiveSize 		= 0;
+		archiveEntryCount 	= 0;
+		archiveIndexOffset 	= 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool AssetArchive::IsMounted()
+	{
+		return 0 != archiveData;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool AssetArchive::Find(const char* filePath, AssetArchiveEntry* entry)
+	{
+		if (!archiveData || !filePath || !entry)
+		{
+			return false;
+		}
+
+		// the lock is only taken once something has been overridden
+		if (archiveOverrideCount)
+		{
+			SDL_LockMutex(archiveOverrideLock);
+			bool overridden = archiveOverrides.end() != archiveOverrides.find(filePath);
+			SDL_UnlockMutex(archiveOverrideLock);
+
+			if (overridden)
+			{
+				return false;
+			}
+		}
+
+		unsigned int pathLength = static_cast<unsigned int>(strlen(filePath));
+
+		// binary search the sorted index
+		unsigned int low = 0;
+		unsigned int high = archiveEntryCount;
+
+		while (low < high)
+		{
+			unsigned int middle = low + (high - low) / 2;
+			const unsigned char* record = archiveData + archiveIndexOffset + middle * ASSETARCHIVE_ENTRY_SIZE;
+
+			unsigned int entryPathOffset = AssetArchive::ReadUint32(record);
+			unsigned int entryPathLength = AssetArchive::ReadUint32(record + 4);
+
+			if (entryPathOffset > archiveSize || entryPathLength > archiveSize - entryPathOffset)
+			{
+				// a damaged index
+				return false;
+			}
+
+			int order = memcmp(archiveData + entryPathOffset, filePath,
+				(entryPathLength < pathLength) ? entryPathLength : pathLength);
+
+			if (0 == order)
+			{
+				order = (entryPathLength < pathLength) ? -1 : (entryPathLength > pathLength) ? 1 : 0;
+			}
+
+			if (order < 0)
+			{
+				low = middle + 1;
+			}
+			else if (order > 0)
+			{
+				high = middle;
+			}
+			else
+			{
+				entry->pathOffset_ 		= entryPathOffset;
+				entry->pathLength_ 		= entryPathLength;
+				entry->dataOffset_ 		= AssetArchive::ReadUint32(record + 8);
+				entry->dataSize_ 		= AssetArchive::ReadUint32(record + 12);
+				entry->encoding_ 		= AssetArchive::ReadUint32(record + 16);
+				entry->width_ 			= AssetArchive::ReadUint32(record + 20);
+				entry->height_ 			= AssetArchive::ReadUint32(record + 24);
+				entry->bitsPerPixel_ 	= AssetArchive::ReadUint32(record + 28);
+				entry->redMask_ 		= AssetArchive::ReadUint32(record + 32);
+				entry->greenMask_ 		= AssetArchive::ReadUint32(record + 36);
+				entry->blueMask_ 		= AssetArchive::ReadUint32(record + 40);
+				entry->alphaMask_ 		= AssetArchive::ReadUint32(record + 44);
+
+				// never hand out bytes past the end of the file
+				return entry->dataOffset_ <= archiveSize && entry->dataSize_ <= archiveSize - entry->dataOffset_;
+			}
+		}
+
+		return false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	const unsigned char* AssetArchive::GetData(const AssetArchiveEntry& entry)
+	{
+		return archiveData + entry.dataOffset_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetArchive::Override(const char* filePath)
+	{
+		if (!filePath)
+		{
+			return;
+		}
+
+		// created on the first override and kept, so a worker never locks a destroyed mutex
+		if (!archiveOverrideLock)
+		{
+			archiveOverrideLock = SDL_CreateMutex();
+		}
+
+		SDL_LockMutex(archiveOverrideLock);
+		archiveOverrides.insert(filePath);
+		SDL_UnlockMutex(archiveOverrideLock);
+
+		// publish the set before the count says there is something in it
+		__sync_synchronize();
+		archiveOverrideCount = static_cast<unsigned int>(archiveOverrides.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* AssetArchive::LoadImage(const char* filePath)
+	{
+		AssetArchiveEntry entry;
+		if (!AssetArchive::Find(filePath, &entry))
+		{
+			return 0;
+		}
+
+		const unsigned char* data = AssetArchive::GetData(entry);
+
+		if (ASSETARCHIVE_ENCODING_FILE == entry.encoding_)
+		{
+			// decode the PNG straight out of the mapped memory
+			return IMG_Load_RW(SDL_RWFromConstMem(data, static_cast<int>(entry.dataSize_)), 1);
+		}
+
+		if (ASSETARCHIVE_ENCODING_PIXELS != entry.encoding_)
+		{
+			// log the error
+			WriteLog(stderr, "\"%s\" has an unknown encoding in the asset archive!\n", filePath);
+			return 0;
+		}
+
+		// the pixels are stored tightly packed, so copy them row by row into a surface of our own
+		SDL_Surface* surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+			static_cast<int>(entry.width_), static_cast<int>(entry.height_), static_cast<int>(entry.bitsPerPixel_),
+			entry.redMask_, entry.greenMask_, entry.blueMask_, entry.alphaMask_);
+
+		if (!surface)
+		{
+			return 0;
+		}
+
+		unsigned int rowBytes = entry.width_ * surface->format->BytesPerPixel;
+		if (static_cast<unsigned long>(rowBytes) * entry.height_ > entry.dataSize_)
+		{
+			// log the error
+			WriteLog(stderr, "\"%s\" is truncated in the asset archive!\n", filePath);
+
+			SDL_FreeSurface(surface);
+			return 0;
+		}
+
+		for (unsigned int row = 0; row < entry.height_; row++)
+		{
+			memcpy(static_cast<unsigned char*>(surface->pixels) + row * surface->pitch, data + row * rowBytes, rowBytes);
+		}
+
+		return surface;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned int AssetArchive::ReadUint32(const unsigned char* bytes)
+	{
+		return
+			static_cast<unsigned int>(bytes[0]) |
+			(static_cast<unsigned int>(bytes[1]) << 8) |
+			(static_cast<unsigned int>(bytes[2]) << 16) |
+			(static_cast<unsigned int>(bytes[3]) << 24);
+	}
+
+} // end namespace
+
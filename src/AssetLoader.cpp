@@ -0,0 +1,350 @@
+
+// CODESTYLE: v2.0
+
+// AssetLoader.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: loads a batch of image resources, decoding them in parallel on a thread pool
+
+/**
+ * @file AssetLoader.cpp
+ * @brief Asset Loader - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	AssetLoader::AssetLoader(ThreadPool* threadPool, bool logTimings) :
+		threadPool_(threadPool),
+		pendingDecodes_(0),
+		startTime_(0),
+		started_(false),
+		logTimings_(logTimings)
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	AssetLoader::~AssetLoader()
+	{
+		// the workers may still be writing into requests_
+		if (started_ && threadPool_)
+		{
+			threadPool_->WaitFor(&pendingDecodes_);
+		}
+
+		for (unsigned int index = 0; index < requests_.size(); index++)
+		{
+			Engine::UnloadImageResource(requests_[index].decoded_);
+		}
+		requests_.clear();
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetLoader::Request(const char* filePath, SDL_Surface** destination)
+	{
+		if (destination)
+		{
+			this->QueueRequest(filePath, destination, 0, 0, 0);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetLoader::Request(const char* filePath, ImageHandle* destination, ImageDecoder decoder, const void* decoderData)
+	{
+		if (destination)
+		{
+			this->QueueRequest(filePath, 0, destination, decoder, decoderData);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetLoader::QueueRequest(const char* filePath, SDL_Surface** destination, ImageHandle* handle,
+		ImageDecoder decoder, const void* decoderData)
+	{
+		if (!filePath)
+		{
+			return;
+		}
+
+		if (started_)
+		{
+			// log the error, the workers hold pointers into requests_ so it can't grow now
+			WriteLog(stderr, "Cannot request \"%s\" from an asset loader that has already started!\n", filePath);
+			return;
+		}
+
+		ImageRequest request;
+		request.filePath_ 		= filePath;
+		request.destination_ 	= destination;
+		request.handle_ 		= handle;
+		request.decoded_ 		= 0;
+		request.converted_ 		= false;
+		request.decoder_ 		= decoder;
+		request.decoderData_ 	= decoderData;
+		request.loader_ 		= this;
+
+		// an image that is already loaded needs no decoding at all
+		SDL_Surface* cached = ResourceCache::AcquireCached(filePath);
+		AssetLoader::Deliver(request, cached);
+
+		if (!cached)
+		{
+			requests_.push_back(request);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetLoader::Start()
+	{
+		if (started_)
+		{
+			return;
+		}
+
+		started_ = true;
+		startTime_ = Clock::GetMicroseconds();
+		pendingDecodes_ = static_cast<int>(requests_.size());
+
+		// decode everything in parallel; requests_ is not touched again until the decoding is done
+		for (unsigned int index = 0; index < requests_.size(); index++)
+		{
+			if (threadPool_)
+			{
+				threadPool_->Submit(AssetLoader::DecodeJob, &requests_[index]);
+			}
+			else
+			{
+				AssetLoader::DecodeJob(&requests_[index]);
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool AssetLoader::IsDecoded() const
+	{
+		return started_ && pendingDecodes_ <= 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool AssetLoader::Finish()
+	{
+		this->Start();
+
+		if (requests_.empty())
+		{
+			started_ = false;
+			return true;
+		}
+
+		Microseconds decodeStart = startTime_;
+
+		// only this loader's images are waited on, not everything else on the pool
+		if (threadPool_ && !this->IsDecoded())
+		{
+			threadPool_->WaitFor(&pendingDecodes_);
+		}
+
+		// make sure every surface the workers wrote is visible here
+		__sync_synchronize();
+
+		Microseconds convertStart = Clock::GetMicroseconds();
+
+		// convert everything to the display format here, on the thread that owns the screen
+		bool allLoaded = true;
+		unsigned int cachedCount = 0;
+		{
+			PROFILE_SCOPE(PROFILE_ZONE_CONVERT);
+
+			for (unsigned int index = 0; index < requests_.size(); index++)
+			{
+				ImageRequest& request = requests_[index];
+
+				// what came out of the pixel cache is already in the display format
+				SDL_Surface* surface = (request.converted_) ?
+					request.decoded_ : Engine::ConvertImageResource(request.decoded_);
+
+				// the cache may hand back an existing surface in place of this one
+				request.decoded_ = ResourceCache::Insert(request.filePath_.c_str(), surface);
+				AssetLoader::Deliver(request, request.decoded_);
+
+				if (!surface)
+				{
+					allLoaded = false;
+				}
+
+				if (request.converted_)
+				{
+					cachedCount++;
+				}
+			}
+		}
+
+		// write the newly converted images to the pixel cache in the background, for the next run
+		if (PixelCache::IsEnabled())
+		{
+			for (unsigned int index = 0; index < requests_.size(); index++)
+			{
+				ImageRequest& request = requests_[index];
+
+				// a made image has no source file to key the cache with
+				if (!request.converted_ && !request.decoder_ && request.decoded_)
+				{
+					this->QueueStore(request.filePath_, request.decoded_);
+				}
+			}
+		}
+
+		// the surfaces now belong to the destinations
+		for (unsigned int index = 0; index < requests_.size(); index++)
+		{
+			requests_[index].decoded_ = 0;
+		}
+
+		Microseconds finishTime = Clock::GetMicroseconds();
+
+		if (logTimings_)
+		{
+			WriteLog(stderr, "Loaded %u images in %lldus (%u from the pixel cache, decoded in %lldus on %d worker threads, converted in %lldus).\n",
+				static_cast<unsigned int>(requests_.size()),
+				static_cast<long long>(finishTime - decodeStart),
+				cachedCount,
+				static_cast<long long>(convertStart - decodeStart),
+				(threadPool_) ? threadPool_->GetThreadCount() : 0,
+				static_cast<long long>(finishTime - convertStart));
+		}
+
+		requests_.clear();
+		started_ = false;
+
+		return allLoaded;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned int AssetLoader::GetRequestCount() const
+	{
+		return static_cast<unsigned int>(requests_.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetLoader::Deliver(ImageRequest& request, SDL_Surface* surface)
+	{
+		if (request.handle_)
+		{
+			request.handle_->Reset(surface);
+		}
+		else
+		{
+			*request.destination_ = surface;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetLoader::DecodeJob(void* userData)
+	{
+		PROFILE_SCOPE(PROFILE_ZONE_DECODE);
+
+		ImageRequest* request = static_cast<ImageRequest*>(userData);
+
+		if (request->decoder_)
+		{
+			request->decoded_ = request->decoder_(request->filePath_.c_str(), request->decoderData_);
+			request->converted_ = false;
+		}
+		else
+		{
+			request->decoded_ = PixelCache::Load(request->filePath_.c_str());
+			request->converted_ = (0 != request->decoded_);
+
+			if (!request->converted_)
+			{
+				request->decoded_ = Engine::DecodeImageResource(request->filePath_.c_str());
+			}
+		}
+
+		// publish the surface before the count says it is there
+		__sync_fetch_and_sub(&request->loader_->pendingDecodes_, 1);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetLoader::QueueStore(const std::string& filePath, SDL_Surface* converted)
+	{
+		// the surface can be let go of while the job is still writing, so the job gets its own copy
+		SDL_Surface* copy = SDL_CreateRGBSurface(
+			SDL_SWSURFACE,
+			converted->w, converted->h,
+			converted->format->BitsPerPixel,
+			converted->format->Rmask, converted->format->Gmask, converted->format->Bmask, converted->format->Amask);
+
+		if (!copy)
+		{
+			// log the error, the image is only missing from the pixel cache
+			WriteLog(stderr, "Unable to copy \"%s\" for the pixel cache!\n\tSDL Error: %s\n", filePath.c_str(), SDL_GetError());
+			return;
+		}
+
+		// locking undoes any RLE encoding, so the rows are plain pixels
+		if (SDL_MUSTLOCK(converted))
+		{
+			SDL_LockSurface(converted);
+		}
+
+		unsigned int rowBytes = converted->w * converted->format->BytesPerPixel;
+
+		for (int row = 0; row < converted->h; row++)
+		{
+			memcpy(static_cast<unsigned char*>(copy->pixels) + row * copy->pitch,
+				static_cast<unsigned char*>(converted->pixels) + row * converted->pitch, rowBytes);
+		}
+
+		if (SDL_MUSTLOCK(converted))
+		{
+			SDL_UnlockSurface(converted);
+		}
+
+		if (converted->flags & SDL_SRCCOLORKEY)
+		{
+			SDL_SetColorKey(copy, SDL_SRCCOLORKEY, converted->format->colorkey);
+		}
+
+		StoreRequest* store = new StoreRequest;
+		store->filePath_ 	= filePath;
+		store->pixels_ 		= copy;
+
+		if (threadPool_)
+		{
+			threadPool_->Submit(AssetLoader::StoreJob, store);
+		}
+		else
+		{
+			AssetLoader::StoreJob(store);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetLoader::StoreJob(void* userData)
+	{
+		StoreRequest* store = static_cast<StoreRequest*>(userData);
+		PixelCache::Store(store->filePath_.c_str(), store->pixels_);
+
+		SDL_FreeSurface(store->pixels_);
+		delete store;
+	}
+
+} // end namespace
+
@@ -0,0 +1,267 @@
+
+// CODESTYLE: v2.0
+
+// AssetWatcher.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: watches the art directories and decodes images as they change on disk
+
+/**
+ * @file AssetWatcher.cpp
+ * @brief Asset Watcher - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+#if defined(__linux__)
+	#include <poll.h>
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	AssetWatcher::AssetWatcher() :
+		inotifyFd_(-1),
+		thread_(0),
+		lock_(SDL_CreateMutex()),
+		readyCount_(0),
+		stopping_(false)
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	AssetWatcher::~AssetWatcher()
+	{
+		this->Stop();
+
+		for (unsigned int index = 0; index < readyImages_.size(); index++)
+		{
+			SDL_FreeSurface(readyImages_[index].decoded_);
+		}
+		readyImages_.clear();
+
+		SDL_DestroyMutex(lock_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetWatcher::Watch(const std::string& directory)
+	{
+		if (directories_.end() == std::find(directories_.begin(), directories_.end(), directory))
+		{
+			directories_.push_back(directory);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool AssetWatcher::Start()
+	{
+		#if defined(__linux__)
+
+		if (thread_)
+		{
+			return true;
+		}
+
+		inotifyFd_ = inotify_init();
+		if (inotifyFd_ < 0)
+		{
+			// log the error
+			WriteLog(stderr, "Unable to start watching the art for changes!\n");
+
+			// return failure
+			return false;
+		}
+
+		for (unsigned int index = 0; index < directories_.size(); index++)
+		{
+			// editors either write the file in place or write a new one and move it over the old
+			int watch = inotify_add_watch(inotifyFd_, directories_[index].c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+			if (watch < 0)
+			{
+				// log the error, the other directories are still watched
+				WriteLog(stderr, "Unable to watch \"%s\" for changes!\n", directories_[index].c_str());
+				continue;
+			}
+			watches_[watch] = directories_[index];
+		}
+
+		stopping_ = false;
+		thread_ = SDL_CreateThread(AssetWatcher::WatcherThread, this);
+		if (!thread_)
+		{
+			// log the error
+			WriteLog(stderr, "Unable to create the asset watcher thread!\n\tSDL Error: %s\n", SDL_GetError());
+
+			close(inotifyFd_);
+			inotifyFd_ = -1;
+			watches_.clear();
+
+			// return failure
+			return false;
+		}
+
+		WriteLog(stderr, "Watching %u directories for changed art.\n", static_cast<unsigned int>(watches_.size()));
+
+		// return success
+		return true;
+
+		#else
+
+		// log the error
+		WriteLog(stderr, "Watching the art for changes is not supported on this platform!\n");
+
+		// return failure
+		return false;
+
+		#endif
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetWatcher::Stop()
+	{
+		if (!thread_)
+		{
+			return;
+		}
+
+		// the thread notices within one poll interval
+		stopping_ = true;
+		SDL_WaitThread(thread_, 0);
+		thread_ = 0;
+
+		#if defined(__linux__)
+		close(inotifyFd_);
+		#endif
+
+		inotifyFd_ = -1;
+		watches_.clear();
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool AssetWatcher::TakeReloadedImage(std::string* filePath, SDL_Surface** decoded)
+	{
+		// the common case of nothing having changed costs no lock
+		if (readyCount_ <= 0)
+		{
+			return false;
+		}
+
+		SDL_LockMutex(lock_);
+
+		bool taken = !readyImages_.empty();
+		if (taken)
+		{
+			*filePath = readyImages_.front().filePath_;
+			*decoded = readyImages_.front().decoded_;
+
+			readyImages_.erase(readyImages_.begin());
+			readyCount_ = static_cast<int>(readyImages_.size());
+		}
+
+		SDL_UnlockMutex(lock_);
+
+		return taken;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	int AssetWatcher::WatcherThread(void* userData)
+	{
+		#if defined(__linux__)
+
+		AssetWatcher* watcher = static_cast<AssetWatcher*>(userData);
+
+		// inotify events are variable length, so this is aligned for the header and roomy for the names
+		union
+		{
+			struct inotify_event event_;
+			char bytes_[0x1000];
+		} buffer;
+
+		while (!watcher->stopping_)
+		{
+			struct pollfd waitFor;
+			waitFor.fd = watcher->inotifyFd_;
+			waitFor.events = POLLIN;
+			waitFor.revents = 0;
+
+			if (poll(&waitFor, 1, ASSETWATCHER_POLL_INTERVAL) <= 0)
+			{
+				continue;
+			}
+
+			ssize_t bytesRead = read(watcher->inotifyFd_, buffer.bytes_, sizeof(buffer.bytes_));
+
+			for (ssize_t offset = 0; offset < bytesRead; )
+			{
+				const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer.bytes_ + offset);
+				offset += sizeof(struct inotify_event) + event->len;
+
+				std::map<int, std::string>::iterator directory = watcher->watches_.find(event->wd);
+				if (directory == watcher->watches_.end() || !event->len)
+				{
+					continue;
+				}
+
+				std::string fileName(event->name);
+				if (fileName.size() > 4 && 0 == fileName.compare(fileName.size() - 4, 4, ".png"))
+				{
+					watcher->ReloadImage(directory->second + fileName);
+				}
+			}
+		}
+
+		#endif
+
+		return 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void AssetWatcher::ReloadImage(const std::string& filePath)
+	{
+		SDL_Surface* decoded = Engine::DecodeImageResource(filePath.c_str(), false);
+		if (!decoded)
+		{
+			// already logged, and the next save will try again
+			return;
+		}
+
+		SDL_LockMutex(lock_);
+
+		// a file saved twice before the main thread got to it only needs its newest version
+		bool replaced = false;
+		for (unsigned int index = 0; index < readyImages_.size() && !replaced; index++)
+		{
+			if (readyImages_[index].filePath_ == filePath)
+			{
+				SDL_FreeSurface(readyImages_[index].decoded_);
+				readyImages_[index].decoded_ = decoded;
+				replaced = true;
+			}
+		}
+
+		if (!replaced)
+		{
+			ReloadedImage image;
+			image.filePath_ = filePath;
+			image.decoded_ = decoded;
+			readyImages_.push_back(image);
+		}
+
+		readyCount_ = static_cast<int>(readyImages_.size());
+
+		SDL_UnlockMutex(lock_);
+	}
+
+} // end namespace
+
@@ -14,390 +14,351 @@
 
 #include "lwc.h"
 
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace LOFI
 {
-	BitmapFont::BitmapFont() :
-		fontImage_(0),
-		letterWidth_(8),
-		letterHeight_(8),
-		spacing_(1)
+	/// reads the pixel at @a pixel from a surface with @a bytesPerPixel bytes per pixel
+	static inline Uint32 ReadPixel(const Uint8* pixel, int bytesPerPixel)
 	{
-		// default font
-		const int defaultFont[] =
+		switch(bytesPerPixel)
 		{
-			0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,1,1,1,0,0,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,1,1,1,1,0,0,0,0,0,0,1,1,1,0,0,0,0,0,1,1,1,0,0,0,0,1,0,0,0,1,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,
-			1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,
-			0,0,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,1,0,0,1,1,0,1,1,1,1,0,0,1,1,0,0,1,1,0,0,0,0,1,1,0,0,0,1,1,0,1,1,1,0,0,
-			1,1,0,0,0,0,0,0,1,1,1,1,1,1,0,0,0,1,1,1,1,0,0,0,0,0,1,0,0,0,1,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,1,1,1,0,1,1,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,1,1,0,1,1,1,1,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,
-			1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,1,1,0,0,1,0,0,0,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,1,1,0,1,1,1,0,0,1,1,1,1,1,1,0,0,
-			0,0,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,1,1,0,0,1,1,0,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,
-			0,1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0,1,1,1,1,1,0,0,0,0,1,0,0,0,1,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,1,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,0,0,
-			0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,1,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,1,0,0,1,1,1,1,1,1,0,0,
-			0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,
-			0,0,0,0,1,1,0,0,1,1,1,1,1,1,0,0,0,1,1,1,1,1,1,0,0,0,1,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,1,1,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,
-			0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,1,1,1,1,1,1,0,0,0,0,0,0,0,1,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,1,0,1,0,1,0,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,
-			1,0,0,0,0,0,0,1,0,0,0,0,1,1,1,0,0,1,1,1,1,0,0,0,1,1,1,1,0,0,0,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,1,0,1,0,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,
-			1,0,1,0,0,1,0,1,0,0,1,1,1,1,1,0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,0,0,1,1,1,0,1,1,0,
-			0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,0,1,1,1,0,0,0,0,0,1,0,1,0,1,0,1,0,0,0,1,1,0,0,0,1,1,1,1,1,1,1,1,1,1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,
-			1,0,0,0,0,0,0,1,1,1,1,1,1,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,
-			1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,1,0,1,0,1,0,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,
-			1,0,1,1,1,1,0,1,0,0,1,1,1,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,1,1,1,0,0,1,1,0,1,1,1,0,0,0,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,
-			1,1,0,0,1,1,0,0,0,1,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,1,0,1,0,1,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,1,1,0,0,0,0,1,1,0,0,0,0,
-			1,0,0,1,1,0,0,1,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,1,0,0,
-			1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,1,1,0,0,0,0,1,0,1,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,
-			1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,1,1,0,0,0,0,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,1,1,1,0,0,0,1,1,1,0,1,1,0,0,0,0,0,1,1,0,0,
-			0,1,1,1,1,1,1,0,0,1,1,1,1,1,1,1,0,1,1,1,1,0,0,0,0,1,0,1,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,1,1,0,0,
-			0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,1,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,1,1,0,1,1,0,0,0,1,1,1,1,0,0,0,1,1,1,1,1,1,0,0,1,1,1,1,1,1,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,1,1,1,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,1,1,0,1,1,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,
-			1,1,1,1,1,1,1,1,0,0,1,1,1,1,0,0,0,1,1,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,1,1,1,0,0,0,1,1,1,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,0,0,0,1,1,0,0,0,0,
-			1,1,0,1,1,0,1,1,0,1,1,1,1,1,1,0,0,1,1,0,1,1,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,1,1,0,1,1,0,0,0,
-			0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,1,1,0,0,0,
-			1,1,1,1,1,1,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,1,1,1,1,1,0,0,0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,
-			1,1,0,0,1,1,0,0,1,1,1,1,1,1,1,0,0,1,1,1,1,0,0,0,0,1,1,1,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,1,1,0,0,0,0,
-			1,1,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,
-			1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,1,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,
-			1,1,1,0,0,1,1,1,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,
-			1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,0,1,1,1,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			1,1,1,1,1,1,1,1,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,1,1,1,1,1,1,0,0,1,1,1,0,0,1,1,0,1,0,1,1,1,1,0,0,1,1,1,1,0,0,0,0,
-			0,1,1,1,1,0,0,0,1,1,0,0,1,1,1,0,0,1,1,1,1,0,0,0,1,1,0,1,1,1,0,1,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,1,1,0,0,0,0,0,0,1,1,1,1,1,1,0,0,
-			0,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,1,1,1,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,1,1,0,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,0,1,1,1,1,0,0,0,0,0,1,1,1,1,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,1,1,1,1,1,1,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,
-			1,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,1,1,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			1,1,0,0,0,0,1,1,1,1,0,0,1,1,0,0,0,0,0,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,1,1,1,1,1,1,1,0,0,0,1,1,0,0,0,0,
-			1,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,1,1,1,1,1,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,1,1,1,0,0,
-			0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,1,1,0,1,1,0,0,0,1,1,0,0,0,0,0,
-			1,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,0,0,1,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,
-			0,0,0,0,0,1,1,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,
-			0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,1,1,1,1,1,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,1,1,1,0,0,1,1,0,0,0,0,0,0,0,1,1,1,1,0,0,0,
-			0,0,1,1,1,1,1,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,1,0,0,1,1,1,1,1,1,0,1,1,0,1,1,0,0,0,0,0,1,1,0,0,0,
-			0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,1,1,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,
-			0,1,1,0,0,1,1,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,1,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,0,1,1,1,1,0,0,0,0,0,1,1,1,1,0,0,0,1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,1,1,1,0,0,0,
-			0,0,1,1,1,1,1,1,0,1,1,1,1,0,0,0,0,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,1,1,1,1,1,1,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,1,0,0,0,0,0,1,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,1,1,1,0,0,1,1,1,1,1,1,0,0,1,1,1,1,1,1,0,0,0,0,0,1,1,1,0,0,0,0,0,1,0,0,0,0,
-			1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,1,1,1,0,0,0,0,0,1,1,1,0,
-			0,0,1,1,1,0,0,0,1,1,0,1,1,0,1,1,0,1,1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,0,1,1,0,0,1,0,1,1,0,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,
-			0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,0,0,1,1,0,1,1,
-			0,1,1,1,1,1,0,0,1,1,0,1,1,0,1,1,1,1,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,1,0,0,
-			0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,1,1,0,1,1,
-			1,1,1,1,1,1,1,0,0,1,1,1,1,0,1,1,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,
-			0,0,0,0,1,1,0,0,0,1,1,1,1,0,0,0,1,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,
-			0,1,1,1,1,1,0,0,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,1,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,0,0,1,1,0,0,0,0,
-			0,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,0,1,1,1,1,1,1,1,1,0,0,0,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,
-			0,0,1,1,1,0,0,0,0,0,0,1,1,0,1,1,1,1,1,1,1,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,0,0,1,1,0,1,0,0,
-			1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,1,1,0,0,0,
-			0,0,0,1,0,0,0,0,0,0,0,1,1,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,1,1,0,0,1,1,1,1,1,1,0,0,0,1,1,1,1,0,0,0,0,1,1,1,0,1,1,0,0,0,0,1,1,0,0,0,
-			0,1,1,1,1,1,1,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,
-			0,0,1,1,1,0,0,0,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,1,1,1,1,1,1,1,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,
-			0,1,1,1,1,1,0,0,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,1,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,
-			0,0,1,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,0,0,1,1,0,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,
-			0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,1,0,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,
-			1,1,1,1,1,1,1,0,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,
-			0,0,0,0,1,1,0,0,0,1,1,1,1,0,0,0,1,1,1,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,
-			1,1,1,1,1,1,1,0,1,1,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,
-			0,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,1,1,1,1,1,0,0,0,1,1,1,1,1,1,1,1,0,0,0,1,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,
-			1,1,0,1,0,1,1,0,0,1,1,1,1,0,0,0,0,1,1,0,0,1,1,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,1,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,
-			1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,0,
-			0,0,0,1,0,0,0,0,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,1,1,1,1,0,0,0,1,1,1,1,1,1,1,0,1,1,1,1,1,1,0,0,0,1,1,1,1,0,0,0,0,1,1,1,0,1,1,0,
-			0,1,1,1,1,1,1,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,0,1,1,0,0,0,
-			0,0,1,1,1,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,
-			0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,1,1,1,0,0,0,1,1,1,1,1,1,1,0,1,1,0,0,1,1,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,1,1,0,0,0,0,0,1,1,1,1,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,
-			0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,1,0,1,1,0,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,
-			0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,
-			0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,1,1,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,
-			0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,1,1,0,1,1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,0,0,0,0,1,1,0,0,1,1,0,0,
-			0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,1,1,1,1,1,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,1,1,1,1,1,1,0,0,
-			1,1,1,1,1,1,1,0,0,1,1,1,1,1,1,0,1,1,0,1,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,
-			0,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,1,1,0,0,0,0,1,1,1,1,1,0,0,1,1,1,1,1,1,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,
-			0,1,1,1,1,1,0,0,0,1,1,1,1,1,1,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,0,0,0,
-			1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,1,1,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,
-			0,0,0,1,0,0,0,0,0,1,1,1,1,1,1,0,0,1,1,1,0,1,1,0,0,1,1,1,1,0,0,0,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,
-			0,1,1,1,1,1,1,0,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,
-			0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,1,1,0,0,0,0,1,1,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,1,1,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,1,1,1,0,1,1,0,0,1,1,1,0,0,1,0,
-			0,0,0,1,1,0,0,0,0,1,1,1,1,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,1,1,1,0,1,1,0,1,1,0,0,0,1,1,0,
-			0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,1,1,0,1,1,1,0,0,1,0,0,1,1,1,0,0,
-			0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,0,1,0,1,1,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,
-			1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,1,1,1,1,0,0,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,1,0,1,1,1,1,1,1,1,0,1,1,0,0,1,1,0,0,1,1,0,1,0,1,1,0,
-			1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,0,0,0,1,1,0,1,1,1,1,1,1,1,0,1,1,1,0,0,0,1,1,0,0,0,0,1,1,1,0,0,1,0,
-			0,0,0,1,1,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,1,1,1,0,1,1,1,0,0,1,1,1,1,1,0,0,1,1,1,1,1,1,1,0,
-			0,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,1,1,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,1,0,0,1,1,1,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,1,1,1,0,1,1,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,1,1,0,1,1,0,0,
-			0,0,0,0,0,1,1,0,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			1,1,1,1,1,1,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,1,1,1,1,1,1,0,0,0,0,1,1,1,0,0,0,
-			1,1,1,1,1,1,1,1,0,0,1,1,1,1,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			1,1,0,0,0,0,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,
-			1,1,1,0,0,1,1,1,0,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,1,1,0,0,0,1,1,0,
-			0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,1,1,0,0,0,0,0,1,1,0,1,1,1,1,1,1,1,1,1,1,1,0,1,1,1,1,0,0,0,0,1,1,0,1,1,0,0,
-			1,1,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,0,0,0,1,1,1,1,1,1,0,0,0,0,1,1,1,0,0,0,0,1,1,1,0,1,1,0,0,1,1,0,1,1,0,0,
-			0,1,1,0,0,1,1,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,1,1,1,0,0,0,
-			1,1,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,1,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,1,0,0,0,
-			0,1,1,1,1,1,1,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			1,1,1,0,0,1,1,1,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,
-			0,1,1,0,0,0,0,0,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,
-			1,1,1,1,1,1,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,1,1,1,0,0,1,1,0,1,1,0,0,0,1,1,0,
-			0,0,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,
-			1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,
-			1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,1,0,0,0,0,1,1,0,0,1,1,0,0,
-			0,1,1,1,1,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,1,1,0,0,0,1,1,1,1,1,1,0,0,0,1,1,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,
-			1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,1,1,1,1,1,1,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,
-			0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,
-			1,1,1,1,1,1,0,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,1,1,1,1,0,1,1,0,0,0,1,1,0,1,1,1,1,1,1,1,1,0,0,0,1,1,0,0,0,1,1,0,0,0,0,1,1,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,1,0,0,
-			1,1,0,0,0,0,0,0,0,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,1,1,0,0,
-			0,1,1,1,1,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,1,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,
-			1,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,1,1,0,0,1,0,0,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,1,1,1,1,0,0,
-			0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,1,1,1,1,0,1,1,1,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,1,0,0,1,1,0,0,0,
-			1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,1,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,
-			1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,1,1,0,1,1,1,1,1,1,1,1,0,0,0,1,1,1,1,1,0,1,1,0,1,1,0,0,0,0,0,1,1,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,0,0,
-			1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,0,0,0,1,1,1,1,1,1,1,0,1,1,0,1,1,0,0,0,1,1,1,1,1,1,0,0,
-			0,1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,0,1,1,1,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,1,1,0,0,1,1,1,1,0,0,0,1,1,1,0,0,0,0,0,0,0,0,1,1,1,0,0,
-			1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,0,0,0,1,1,1,0,0,0,0,0,0,1,1,1,1,
-			0,0,0,0,0,1,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,0,1,1,0,0,
-			0,0,0,0,1,1,1,1,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,
-			0,1,1,1,0,0,0,0,0,1,1,1,1,1,1,0,1,1,0,1,1,0,0,0,1,1,1,1,1,1,1,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,
-			0,1,1,1,1,1,0,1,1,1,1,1,1,1,1,0,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,1,1,0,0,1,1,1,0,0,0,0,0,
-			0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,0,1,1,1,1,1,0,0,0,0,0,0,1,1,0,0,
-			1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,
-			0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,1,1,0,1,1,0,1,1,1,1,0,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,1,1,0,0,1,1,1,0,1,1,0,0,
-			1,1,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,
-			0,0,1,1,0,0,0,0,0,1,1,1,1,1,1,0,1,1,0,0,1,1,1,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,1,1,1,1,1,1,1,1,1,1,0,0,1,1,0,0,0,1,1,0,1,1,0,0,
-			1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,0,0,1,1,0,0,1,1,1,1,0,0,0,1,1,1,0,0,1,1,0,0,0,0,1,1,1,0,0,
-			0,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,1,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,1,1,1,1,1,1,1,1,0,1,1,1,1,0,0,0,0,0,1,1,1,1,0,0,
-			0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,1,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,
-			0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,1,1,0,0,0,
-			0,1,1,1,1,1,0,0,0,0,1,1,1,0,0,0,1,1,0,0,0,1,1,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,
-			0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,
-			1,1,0,0,0,1,1,0,0,1,1,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,
-			0,1,1,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,
-			0,0,1,1,1,0,0,0,0,1,1,0,0,1,0,0,1,1,0,1,1,0,0,0,1,1,1,1,0,1,1,0,0,0,1,1,0,1,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,1,1,0,1,1,0,0,
-			0,1,1,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,1,1,0,0,0,1,1,1,1,0,0,0,0,1,1,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,1,1,0,1,1,0,1,1,0,0,
-			0,0,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,1,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,
-			0,0,0,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,1,1,1,1,1,1,1,1,1,1,0,0,0,1,1,0,1,1,1,1,1,1,1,1,1,1,1,1,1,0,1,1,0,1,1,0,1,1,0,1,1,0,0,
-			0,0,0,1,1,0,0,0,1,1,1,1,1,1,1,0,0,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,
-			0,0,0,1,1,0,0,0,1,1,1,0,0,1,1,0,1,1,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,1,1,1,1,1,1,1,1,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,
-			0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,1,1,1,0,0,0,0,0,0,0,1,0,0,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,
-			0,0,1,1,1,1,0,0,1,1,1,1,1,1,0,0,1,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,
-			1,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,1,1,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,1,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,
-			0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,
-			0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,1,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,1,1,1,0,1,1,0,0,0,0,1,1,0,0,0,0,
-			0,1,1,1,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,1,1,1,1,1,1,0,0,0,1,1,1,0,0,0,
-			0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,1,1,0,1,0,1,1,0,0,0,0,1,1,0,0,0,1,1,1,1,1,1,1,0,0,0,0,1,1,1,0,0,
-			0,0,1,1,0,0,0,0,1,1,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,1,1,0,1,1,0,1,1,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,1,1,0,0,0,1,1,0,1,0,1,1,0,0,0,1,1,0,0,0,0,
-			0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,1,1,1,0,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,1,1,0,1,1,0,1,1,0,1,1,1,1,1,0,0,
-			0,0,0,0,0,0,0,0,0,0,1,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,1,1,0,0,0,1,1,0,0,0,1,1,0,0,0,1,1,0,0,0,0,
-			0,0,1,1,0,0,0,0,1,1,1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,1,1,1,1,0,0,0,1,1,0,0,0,1,1,0,1,1,1,0,0,0,0,0,
-			0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,1,1,0,
-			1,1,0,0,1,1,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,1,1,1,1,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,
-			0,1,1,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,0,0,1,1,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,1,0,0,
-			0,0,1,1,0,0,0,0,1,1,0,1,1,0,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,1,1,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,1,1,1,1,1,1,1,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,0,1,1,0,0,1,1,0,1,1,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,
-			0,1,1,1,1,0,0,0,1,1,0,1,1,0,0,0,0,1,1,0,0,1,1,0,1,1,1,1,1,0,0,0,1,1,1,1,0,1,1,1,0,0,0,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,1,1,1,1,0,0,
-			0,1,1,0,0,0,1,1,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,1,1,1,1,0,1,1,0,0,0,1,1,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			1,1,0,0,1,1,0,0,1,1,1,1,0,1,0,0,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,0,0,0,0,1,1,1,1,0,0,
-			0,1,1,0,0,0,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,1,1,1,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,1,1,0,1,1,1,1,1,0,0,0,1,1,1,1,0,1,1,1,0,0,0,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,1,1,1,1,0,0,
-			0,1,1,0,0,1,1,1,1,1,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			1,1,1,1,1,1,0,0,1,1,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,1,1,1,1,0,1,1,0,0,0,0,0,0,0,1,1,1,1,0,0,
-			1,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,1,1,1,1,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,
-			1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			1,0,0,1,1,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,1,1,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,
-			0,0,1,1,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,1,1,1,1,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,
-			0,1,0,1,1,0,1,0,1,1,1,1,1,1,1,1,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,
-			0,0,1,1,0,0,0,0,0,0,0,1,1,0,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			0,0,1,1,1,1,0,0,1,1,1,1,1,1,1,1,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,1,1,0,0,
-			0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			1,1,1,0,0,1,1,1,0,1,1,1,1,1,1,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,
-			0,1,1,1,1,0,0,0,0,1,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			1,1,1,0,0,1,1,1,0,0,1,1,1,1,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,
-			1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,1,1,0,0,1,1,0,1,1,1,1,1,0,0,0,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,0,
-			1,1,1,1,1,1,0,0,0,0,0,1,1,0,0,0,1,1,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			0,1,0,1,1,0,1,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,1,1,1,1,1,1,1,0,
-			1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,
-			1,0,0,1,1,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-			0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 
-		};
+			case 1: return *pixel;
+			case 2: return *reinterpret_cast<const Uint16*>(pixel);
+			case 3:
+			{
+				return (SDL_LIL_ENDIAN == SDL_BYTEORDER) ?
+					(pixel[0] | (pixel[1] << 8) | (pixel[2] << 16)) :
+					(pixel[2] | (pixel[1] << 8) | (pixel[0] << 16));
+			}
+			case 4: return *reinterpret_cast<const Uint32*>(pixel);
+			default: break;
+		}
+		return 0;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	/// writes @a color to @a pixel, specialized for each number of bytes per pixel
+	template <int BYTES_PER_PIXEL> inline void WritePixel(Uint8* pixel, Uint32 color);
+	
+	template <> inline void WritePixel<1>(Uint8* pixel, Uint32 color)
+	{
+		*pixel = static_cast<Uint8>(color);
+	}
+	
+	template <> inline void WritePixel<2>(Uint8* pixel, Uint32 color)
+	{
+		*reinterpret_cast<Uint16*>(pixel) = static_cast<Uint16>(color);
+	}
+	
+	template <> inline void WritePixel<3>(Uint8* pixel, Uint32 color)
+	{
+		if (SDL_LIL_ENDIAN == SDL_BYTEORDER)
+		{
+			pixel[0] = color;
+			pixel[1] = color >> 8;
+			pixel[2] = color >> 16;
+		}
+		else
+		{
+			pixel[2] = color;
+			pixel[1] = color >> 8;
+			pixel[0] = color >> 16;
+		}
+	}
+	
+	template <> inline void WritePixel<4>(Uint8* pixel, Uint32 color)
+	{
+		*reinterpret_cast<Uint32*>(pixel) = color;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	#if defined(__SSE2__)
+	/// writes @a color over the opaque pixels of one 8 pixel row of a letter on a 32 bit surface, 4 pixels at a time
+	static inline void BlendRow8(Uint8* rowPixels, unsigned int bits, Uint32 color)
+	{
+		const __m128i fill 		= _mm_set1_epi32(static_cast<int>(color));
+		const __m128i lowBits 	= _mm_set_epi32(8, 4, 2, 1);
+		const __m128i highBits 	= _mm_set_epi32(128, 64, 32, 16);
 		
-		fontImage_ = SDL_CreateRGBSurface(
-			SDL_SRCCOLORKEY, 
-			128, 128, globalEngineInstance->GetScreen()->format->BitsPerPixel, 0, 0, 0, 0);
-		SDL_SetColorKey(fontImage_, (SDL_SRCCOLORKEY|SDL_RLEACCEL), SDL_MapRGB(fontImage_->format, 255, 0, 255));
-		SDL_FillRect(fontImage_, 0, SDL_MapRGB(fontImage_->format, 255, 0, 255));
+		// spread the row's 8 bits over 8 lanes, all ones where the letter is opaque
+		__m128i spread 		= _mm_set1_epi32(static_cast<int>(bits));
+		__m128i lowMask 	= _mm_cmpeq_epi32(_mm_and_si128(spread, lowBits), lowBits);
+		__m128i highMask 	= _mm_cmpeq_epi32(_mm_and_si128(spread, highBits), highBits);
 		
-		if (SDL_MUSTLOCK(fontImage_))
+		__m128i* low 	= reinterpret_cast<__m128i*>(rowPixels);
+		__m128i* high 	= reinterpret_cast<__m128i*>(rowPixels + 16);
+		
+		_mm_storeu_si128(low, _mm_or_si128(_mm_and_si128(lowMask, fill), _mm_andnot_si128(lowMask, _mm_loadu_si128(low))));
+		_mm_storeu_si128(high, _mm_or_si128(_mm_and_si128(highMask, fill), _mm_andnot_si128(highMask, _mm_loadu_si128(high))));
+	}
+	#endif
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * writes the opaque pixels of one compiled letter into the locked @a destination at @a x, @a y,
+	 * clipped to its clip rect; @a colors is null when every pixel is @a color
+	 */
+	template <int BYTES_PER_PIXEL>
+	static void DrawGlyph(SDL_Surface* destination, int x, int y,
+		const unsigned int* rows, const unsigned int* colors, Uint32 color, int width, int height)
+	{
+		const SDL_Rect& clip = destination->clip_rect;
+		
+		int firstRow 		= std::max(0, clip.y - y);
+		int lastRow 		= std::min(height, clip.y + clip.h - y);
+		int firstColumn 	= std::max(0, clip.x - x);
+		int lastColumn 		= std::min(width, clip.x + clip.w - x);
+		
+		if (firstRow >= lastRow || firstColumn >= lastColumn)
 		{
-			SDL_LockSurface(fontImage_);
+			return;
 		}
 		
-		unsigned int whitePixel = SDL_MapRGB(fontImage_->format, 255, 255, 255);
+		// the columns inside the clip rect; firstColumn is always below 32 here
+		unsigned int columnMask = (lastColumn >= 32) ? ~0u : ((1u << lastColumn) - 1);
+		columnMask &= ~((1u << firstColumn) - 1);
 		
-		switch(fontImage_->format->BytesPerPixel)
+		Uint8* rowPixels =
+			static_cast<Uint8*>(destination->pixels) + (y + firstRow) * destination->pitch + x * BYTES_PER_PIXEL;
+		
+		for (int row = firstRow; row < lastRow; row++, rowPixels += destination->pitch)
 		{
-			// 8 bits per pixel
-			case 1: 
+			unsigned int bits = rows[row] & columnMask;
+			
+			#if defined(__SSE2__)
+			if (4 == BYTES_PER_PIXEL && 8 == width && 0xFF == columnMask && !colors)
 			{
-				for (int y = 0; y < 128; y++)
+				if (bits)
 				{
-					for (int x = 0; x < 128; x++)
-					{
-						if (0 != defaultFont[x + (y * 128)])
-						{
-							unsigned char* imageDataBuffer = 
-								static_cast<unsigned char*>(
-									static_cast<unsigned char*>(fontImage_->pixels) + y * fontImage_->pitch + x);
-							*imageDataBuffer = whitePixel;
-						}
-					}
+					BlendRow8(rowPixels, bits, color);
 				}
-			} break;
+				continue;
+			}
+			#endif
 			
-			// 15 or 16 bits per pixel 
-			case 2: 
+			while (bits)
 			{
-				unsigned int pitchOver2 = fontImage_->pitch / 2;
-				for (int y = 0; y < 128; y++)
-				{
-					for (int x = 0; x < 128; x++)
-					{
-						if (0 != defaultFont[x + (y * 128)])
-						{
-							unsigned short* imageDataBuffer = 
-								static_cast<unsigned short*>(
-									static_cast<unsigned short*>(fontImage_->pixels) + y * pitchOver2 + x);
-							*imageDataBuffer = whitePixel;
-						}
-					}
-				}
-			} break;
+				int column = __builtin_ctz(bits);
+				bits &= bits - 1;
+				
+				WritePixel<BYTES_PER_PIXEL>(rowPixels + column * BYTES_PER_PIXEL,
+					(colors) ? colors[row * width + column] : color);
+			}
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	/// the width and height of the built in font image, 16 letters of 8x8 pixels across and down
+	/// the last generation handed to a font; fonts are only made and destroyed on the main thread
+	static unsigned int lastFontGeneration = 0;
+	
+	static const int DEFAULT_FONT_SIZE = 128;
+	
+	/// the built in font image, 1 bit per pixel with the leftmost pixel of each byte in its high bit
+	static const unsigned char defaultFontBits[DEFAULT_FONT_SIZE * DEFAULT_FONT_SIZE / 8] =
+	{
+		0x00, 0x80, 0x00, 0x78, 0x7C, 0xFC, 0x30, 0x00, 0x78, 0x1C, 0x1C, 0x22, 0x18, 0x36, 0x00, 0x00,
+		0x00, 0xE0, 0x00, 0xCC, 0xC6, 0x66, 0x30, 0x00, 0xCC, 0x00, 0x00, 0x88, 0x18, 0x36, 0x00, 0xFC,
+		0x00, 0xF8, 0x00, 0xDC, 0xDE, 0x66, 0x18, 0xDC, 0xC0, 0xFC, 0x78, 0x22, 0x18, 0x36, 0x76, 0x00,
+		0x00, 0xFE, 0x00, 0xFC, 0xDE, 0x7C, 0x00, 0x66, 0xCC, 0x60, 0x0C, 0x88, 0x18, 0x36, 0xDC, 0xFC,
+		0x00, 0xF8, 0x00, 0xEC, 0xDE, 0x60, 0x00, 0x66, 0x78, 0x78, 0x7C, 0x22, 0x1F, 0xFF, 0xC8, 0x00,
+		0x00, 0xE0, 0x00, 0xCC, 0xC0, 0x60, 0x00, 0x7C, 0x18, 0x60, 0xCC, 0x88, 0x00, 0x00, 0xDC, 0xFC,
+		0x00, 0x80, 0x00, 0x78, 0x78, 0xF0, 0x00, 0x60, 0x0C, 0xFC, 0x7E, 0x22, 0x00, 0x00, 0x76, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x78, 0x00, 0x00, 0x88, 0x00, 0x00, 0x00, 0x00,
+		0x7E, 0x02, 0x30, 0x30, 0x30, 0x78, 0x00, 0x00, 0x00, 0x00, 0x38, 0x55, 0x18, 0x00, 0x00, 0x30,
+		0x81, 0x0E, 0x78, 0xF0, 0x78, 0xCC, 0x00, 0x00, 0xCC, 0x00, 0x00, 0xAA, 0x18, 0x00, 0x78, 0x30,
+		0xA5, 0x3E, 0x78, 0x30, 0xCC, 0xCC, 0x78, 0x76, 0x00, 0x7F, 0x70, 0x55, 0x18, 0xFF, 0xCC, 0xFC,
+		0x81, 0xFE, 0x30, 0x30, 0xCC, 0xCC, 0x0C, 0xCC, 0xCC, 0x0C, 0x30, 0xAA, 0x18, 0x00, 0xF8, 0x30,
+		0xBD, 0x3E, 0x30, 0x30, 0xFC, 0xDC, 0x7C, 0xCC, 0xCC, 0x7F, 0x30, 0x55, 0xFF, 0xFF, 0xCC, 0x30,
+		0x99, 0x0E, 0x00, 0x30, 0xCC, 0x78, 0xCC, 0x7C, 0xCC, 0xCC, 0x30, 0xAA, 0x00, 0x18, 0xF8, 0x00,
+		0x81, 0x02, 0x30, 0xFC, 0xCC, 0x1C, 0x76, 0x0C, 0x7E, 0x7F, 0x78, 0x55, 0x00, 0x18, 0xC0, 0xFC,
+		0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1E, 0x00, 0x00, 0x00, 0xAA, 0x00, 0x18, 0xC0, 0x00,
+		0x7E, 0x18, 0x6C, 0x78, 0xFC, 0xFC, 0xE0, 0x00, 0x1C, 0x3E, 0x00, 0xDD, 0x00, 0x00, 0x00, 0x60,
+		0xFF, 0x3C, 0x6C, 0xCC, 0x66, 0x66, 0x60, 0x00, 0x00, 0x6C, 0x1C, 0x77, 0x00, 0x00, 0xFE, 0x30,
+		0xDB, 0x7E, 0x6C, 0x0C, 0x66, 0x66, 0x7C, 0xD8, 0x78, 0xCC, 0x00, 0xDD, 0x00, 0x00, 0xC6, 0x18,
+		0xFF, 0x18, 0x00, 0x38, 0x7C, 0x7C, 0x66, 0x6C, 0xCC, 0xFE, 0x78, 0x77, 0x00, 0x00, 0xC0, 0x30,
+		0xC3, 0x18, 0x00, 0x60, 0x66, 0x78, 0x66, 0x6C, 0xFC, 0xCC, 0xCC, 0xDD, 0xFF, 0xFF, 0xC0, 0x60,
+		0xE7, 0x7E, 0x00, 0xCC, 0x66, 0x6C, 0x66, 0x60, 0xC0, 0xCC, 0xCC, 0x77, 0x18, 0x36, 0xC0, 0x00,
+		0xFF, 0x3C, 0x00, 0xFC, 0xFC, 0xE6, 0xBC, 0xF0, 0x78, 0xCE, 0x78, 0xDD, 0x18, 0x36, 0xC0, 0xFC,
+		0x7E, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x77, 0x18, 0x36, 0x00, 0x00,
+		0x6C, 0x66, 0x6C, 0x78, 0x3C, 0x78, 0x00, 0x00, 0x7E, 0x78, 0x00, 0x18, 0x18, 0x36, 0x00, 0x18,
+		0xFE, 0x66, 0x6C, 0xCC, 0x66, 0xCC, 0x00, 0x00, 0xC3, 0xCC, 0x1C, 0x18, 0x18, 0x36, 0xFE, 0x30,
+		0xFE, 0x66, 0xFE, 0x0C, 0xC0, 0xE0, 0x78, 0x7C, 0x3C, 0x00, 0x00, 0x18, 0x18, 0x36, 0x6C, 0x60,
+		0xFE, 0x66, 0x6C, 0x38, 0xC0, 0x38, 0xCC, 0xC0, 0x06, 0x78, 0xCC, 0x18, 0x18, 0x36, 0x6C, 0x30,
+		0x7C, 0x66, 0xFE, 0x0C, 0xC0, 0x1C, 0xC0, 0x78, 0x3E, 0xCC, 0xCC, 0x18, 0x1F, 0x3F, 0x6C, 0x18,
+		0x38, 0x00, 0x6C, 0xCC, 0x66, 0xCC, 0xCC, 0x0C, 0x66, 0xCC, 0xCC, 0x18, 0x18, 0x00, 0x6C, 0x00,
+		0x10, 0x66, 0x6C, 0x78, 0x3C, 0x78, 0x78, 0xF8, 0x3F, 0x78, 0x7E, 0x18, 0x18, 0x00, 0x6C, 0xFC,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00,
+		0x10, 0x7F, 0x30, 0x1C, 0xFC, 0xFC, 0x1C, 0x10, 0xCC, 0x00, 0x00, 0x18, 0x00, 0x18, 0xFE, 0x0E,
+		0x38, 0xDB, 0x7C, 0x3C, 0x6C, 0xB4, 0x0C, 0x30, 0x00, 0xCC, 0xF8, 0x18, 0x00, 0x18, 0x66, 0x1B,
+		0x7C, 0xDB, 0xC0, 0x6C, 0x66, 0x30, 0x0C, 0x7C, 0x78, 0x00, 0x00, 0x18, 0x00, 0x1F, 0x30, 0x1B,
+		0xFE, 0x7B, 0x78, 0xCC, 0x66, 0x30, 0x7C, 0x30, 0x0C, 0x78, 0xF8, 0x18, 0x00, 0x18, 0x18, 0x18,
+		0x7C, 0x1B, 0x0C, 0xFE, 0x66, 0x30, 0xCC, 0x30, 0x7C, 0xCC, 0xCC, 0xF8, 0xFF, 0x1F, 0x30, 0x18,
+		0x38, 0x1B, 0xF8, 0x0C, 0x6C, 0x30, 0xCC, 0x34, 0xCC, 0xCC, 0xCC, 0x18, 0x00, 0x00, 0x66, 0x18,
+		0x10, 0x1B, 0x30, 0x0C, 0xFC, 0x78, 0x76, 0x18, 0x7E, 0x78, 0xCC, 0x18, 0x00, 0x00, 0xFE, 0x18,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x18,
+		0x38, 0x7E, 0x00, 0xFC, 0xFE, 0xCC, 0x00, 0x00, 0xE0, 0x00, 0xFC, 0x18, 0x18, 0x00, 0x00, 0x18,
+		0x7C, 0xC3, 0xC6, 0xC0, 0x62, 0xCC, 0x00, 0x00, 0x00, 0xE0, 0x00, 0x18, 0x18, 0x00, 0x00, 0x18,
+		0x38, 0x78, 0xCC, 0xF8, 0x68, 0xCC, 0x78, 0xCC, 0x78, 0x00, 0xCC, 0xF8, 0x18, 0x1F, 0x7E, 0x18,
+		0xFE, 0xCC, 0x18, 0x0C, 0x78, 0xCC, 0xCC, 0xCC, 0x0C, 0x78, 0xEC, 0x18, 0x18, 0x18, 0xCC, 0x18,
+		0xFE, 0xCC, 0x30, 0x0C, 0x68, 0xCC, 0xFC, 0xCC, 0x7C, 0xCC, 0xFC, 0xF8, 0xFF, 0x1F, 0xCC, 0x18,
+		0xD6, 0x78, 0x66, 0xCC, 0x62, 0xCC, 0xC0, 0xCC, 0xCC, 0xCC, 0xDC, 0x18, 0x18, 0x18, 0xCC, 0xD8,
+		0x10, 0x8C, 0xC6, 0x78, 0xFE, 0xFC, 0x78, 0x76, 0x7E, 0x78, 0xCC, 0x18, 0x18, 0x18, 0x78, 0xD8,
+		0x38, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x18, 0x00, 0x70,
+		0x10, 0x00, 0x38, 0x38, 0xFE, 0xCC, 0x38, 0x00, 0x30, 0x78, 0x3C, 0x36, 0x18, 0x00, 0x00, 0x30,
+		0x10, 0x00, 0x6C, 0x60, 0x62, 0xCC, 0x6C, 0x00, 0x30, 0xCC, 0x6C, 0x36, 0x18, 0x00, 0x66, 0x30,
+		0x38, 0x00, 0x38, 0xC0, 0x68, 0xCC, 0x60, 0xCC, 0x78, 0x00, 0x6C, 0x36, 0x1F, 0x00, 0x66, 0x00,
+		0x7C, 0x00, 0x76, 0xF8, 0x78, 0xCC, 0xF0, 0xCC, 0x0C, 0xCC, 0x3E, 0x36, 0x18, 0x00, 0x66, 0xFC,
+		0xFE, 0x7E, 0xDC, 0xCC, 0x68, 0xCC, 0x60, 0xCC, 0x7C, 0xCC, 0x00, 0xF6, 0x1F, 0x3F, 0x66, 0x00,
+		0x7C, 0x7E, 0xCC, 0xCC, 0x60, 0x78, 0x60, 0x78, 0xCC, 0xCC, 0x7E, 0x36, 0x18, 0x36, 0x7C, 0x30,
+		0x10, 0x7E, 0x76, 0x78, 0xF0, 0x30, 0xF0, 0x30, 0x7E, 0x7E, 0x00, 0x36, 0x18, 0x36, 0x60, 0x30,
+		0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x36, 0x18, 0x36, 0xC0, 0x00,
+		0x00, 0x18, 0x60, 0xFC, 0x3C, 0xC6, 0x00, 0x00, 0x00, 0x00, 0x3C, 0x00, 0x36, 0x36, 0x00, 0x00,
+		0x00, 0x3C, 0x60, 0xCC, 0x66, 0xC6, 0x00, 0x00, 0x00, 0xE0, 0x66, 0x00, 0x36, 0x36, 0x76, 0x72,
+		0x18, 0x7E, 0xC0, 0x0C, 0xC0, 0xC6, 0x76, 0xC6, 0x7C, 0x00, 0x66, 0x00, 0x36, 0x36, 0xDC, 0x9C,
+		0x3C, 0x18, 0x00, 0x18, 0xC0, 0xD6, 0xCC, 0xC6, 0xC0, 0xCC, 0x3C, 0x00, 0x36, 0x36, 0x18, 0x00,
+		0x3C, 0x7E, 0x00, 0x30, 0xCE, 0xFE, 0xCC, 0xD6, 0xC0, 0xCC, 0x00, 0xFE, 0x37, 0xF7, 0x18, 0x72,
+		0x18, 0x3C, 0x00, 0x60, 0x66, 0xEE, 0x7C, 0xFE, 0x7C, 0xCC, 0x7E, 0x36, 0x36, 0x36, 0x18, 0x9C,
+		0x00, 0x18, 0x00, 0x60, 0x3E, 0xC6, 0x0C, 0x6C, 0x06, 0x7E, 0x00, 0x36, 0x36, 0x36, 0x18, 0x00,
+		0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xF8, 0x00, 0x3C, 0x00, 0x00, 0x36, 0x36, 0x36, 0x00, 0x00,
+		0xFF, 0x18, 0x18, 0x78, 0xCC, 0xC6, 0xE0, 0x00, 0x7E, 0x00, 0x30, 0x00, 0x36, 0x18, 0xFC, 0x38,
+		0xFF, 0x3C, 0x30, 0xCC, 0xCC, 0xC6, 0x60, 0x00, 0xC3, 0xCC, 0x00, 0x00, 0x36, 0x18, 0x30, 0x6C,
+		0xE7, 0x7E, 0x60, 0xCC, 0xCC, 0x6C, 0x6C, 0xC6, 0x3C, 0x00, 0x30, 0xF8, 0x37, 0xFF, 0x78, 0x6C,
+		0xC3, 0x18, 0x60, 0x78, 0xFC, 0x38, 0x76, 0x6C, 0x66, 0xCC, 0x60, 0x18, 0x30, 0x00, 0xCC, 0x38,
+		0xC3, 0x18, 0x60, 0xCC, 0xCC, 0x6C, 0x66, 0x38, 0x7E, 0xCC, 0xC0, 0xF8, 0x3F, 0xFF, 0xCC, 0x00,
+		0xE7, 0x18, 0x30, 0xCC, 0xCC, 0xC6, 0x66, 0x6C, 0x60, 0xFC, 0xCC, 0x18, 0x00, 0x18, 0x78, 0x00,
+		0xFF, 0x18, 0x18, 0x78, 0xCC, 0xC6, 0xE6, 0xC6, 0x3C, 0x0C, 0x78, 0x18, 0x00, 0x18, 0x30, 0x00,
+		0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0x00, 0x18, 0x00, 0x18, 0xFC, 0x00,
+		0x00, 0x18, 0x60, 0x78, 0x78, 0xCC, 0x30, 0x00, 0xCC, 0xC6, 0x00, 0x36, 0x00, 0x18, 0x38, 0x00,
+		0x00, 0x18, 0x30, 0xCC, 0x30, 0xCC, 0x00, 0x00, 0x00, 0x38, 0x00, 0x36, 0x00, 0x18, 0x6C, 0x00,
+		0x00, 0x18, 0x18, 0xCC, 0x30, 0xCC, 0x70, 0xCC, 0x78, 0x7C, 0x00, 0xF6, 0x3F, 0x18, 0xC6, 0x00,
+		0x00, 0x18, 0x18, 0x7C, 0x30, 0x78, 0x30, 0xCC, 0xCC, 0xC6, 0xFC, 0x06, 0x30, 0x18, 0xFE, 0x18,
+		0x00, 0x7E, 0x18, 0x0C, 0x30, 0x30, 0x30, 0xCC, 0xFC, 0xC6, 0xC0, 0xF6, 0x37, 0xF8, 0xC6, 0x18,
+		0x00, 0x3C, 0x30, 0x18, 0x30, 0x30, 0x30, 0x7C, 0xC0, 0x7C, 0xC0, 0x36, 0x36, 0x00, 0x6C, 0x00,
+		0x00, 0x18, 0x60, 0x70, 0x78, 0x78, 0x78, 0x0C, 0x78, 0x38, 0x00, 0x36, 0x36, 0x00, 0x38, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0x00, 0x36, 0x36, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x1E, 0xFE, 0x18, 0x00, 0xE0, 0xCC, 0x00, 0x36, 0x36, 0x00, 0x38, 0x00,
+		0x00, 0x00, 0x66, 0x00, 0x0C, 0xCC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x36, 0x36, 0x00, 0x6C, 0x00,
+		0x00, 0x00, 0x3C, 0x30, 0x0C, 0x98, 0x78, 0xFC, 0x78, 0xCC, 0x00, 0x36, 0xF7, 0x00, 0xC6, 0x00,
+		0x00, 0x00, 0xFF, 0x30, 0x0C, 0x30, 0x18, 0x98, 0xCC, 0xCC, 0xFC, 0x36, 0x00, 0x00, 0xC6, 0x00,
+		0x00, 0x00, 0x3C, 0x00, 0xCC, 0x62, 0x18, 0x30, 0xFC, 0xCC, 0x0C, 0x36, 0xFF, 0x1F, 0x6C, 0x18,
+		0x00, 0x00, 0x66, 0x30, 0xCC, 0xC6, 0x18, 0x64, 0xC0, 0xCC, 0x0C, 0x36, 0x00, 0x18, 0x6C, 0x00,
+		0x00, 0x00, 0x00, 0x30, 0x78, 0xFE, 0xD8, 0xFC, 0x78, 0x78, 0x00, 0x36, 0x00, 0x18, 0xEE, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x00, 0x00, 0x00, 0x00, 0x36, 0x00, 0x18, 0x00, 0x00,
+		0x0F, 0x00, 0x00, 0x00, 0xE6, 0x78, 0xE0, 0x1C, 0xCC, 0x18, 0xC6, 0x00, 0x00, 0xFF, 0x1C, 0x0F,
+		0x07, 0x30, 0x30, 0x00, 0x66, 0x60, 0x60, 0x30, 0x00, 0x18, 0xCC, 0x00, 0x00, 0xFF, 0x30, 0x0C,
+		0x0F, 0x60, 0x30, 0x30, 0x6C, 0x60, 0x66, 0x30, 0x70, 0x7E, 0xD8, 0xFE, 0xFF, 0xFF, 0x18, 0x0C,
+		0x7D, 0xFE, 0xFC, 0x30, 0x78, 0x60, 0x6C, 0xE0, 0x30, 0xC0, 0x3E, 0x06, 0x00, 0xFF, 0x7C, 0x0C,
+		0xCC, 0x60, 0x30, 0x00, 0x6C, 0x60, 0x78, 0x30, 0x30, 0xC0, 0x63, 0xF6, 0xF7, 0xFF, 0xCC, 0xEC,
+		0xCC, 0x30, 0x30, 0x70, 0x66, 0x60, 0x6C, 0x30, 0x30, 0x7E, 0xCE, 0x36, 0x36, 0xFF, 0xCC, 0x6C,
+		0xCC, 0x00, 0x00, 0x30, 0xE6, 0x78, 0xE6, 0x1C, 0x78, 0x18, 0x98, 0x36, 0x36, 0xFF, 0x78, 0x3C,
+		0x78, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x1F, 0x36, 0x36, 0xFF, 0x00, 0x1C,
+		0x3C, 0x00, 0x00, 0x18, 0xF0, 0xC0, 0x70, 0x18, 0x7C, 0x38, 0xC6, 0x36, 0x36, 0x00, 0x00, 0x78,
+		0x66, 0x00, 0x00, 0x30, 0x60, 0x60, 0x30, 0x18, 0xC6, 0x6C, 0xCC, 0x36, 0x36, 0x00, 0x00, 0x6C,
+		0x66, 0xC0, 0x00, 0x60, 0x60, 0x30, 0x30, 0x18, 0x38, 0x64, 0xD8, 0xF6, 0x37, 0x00, 0x7E, 0x6C,
+		0x66, 0xC0, 0x00, 0xC0, 0x60, 0x18, 0x30, 0x00, 0x18, 0xF0, 0xF3, 0x06, 0x30, 0x00, 0xDB, 0x6C,
+		0x3C, 0xC0, 0x00, 0x60, 0x62, 0x0C, 0x30, 0x18, 0x18, 0x60, 0x67, 0xFE, 0x37, 0xFF, 0xDB, 0x6C,
+		0x18, 0xFE, 0x70, 0x30, 0x66, 0x06, 0x30, 0x18, 0x18, 0xE6, 0xCF, 0x00, 0x36, 0xFF, 0x7E, 0x00,
+		0x7E, 0x00, 0x30, 0x18, 0xFE, 0x02, 0x78, 0x18, 0x3C, 0xFC, 0x9F, 0x00, 0x36, 0xFF, 0x00, 0x00,
+		0x18, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x36, 0xFF, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xC6, 0x78, 0x00, 0xE0, 0xE0, 0xCC, 0x00, 0x36, 0x00, 0xF0, 0x06, 0x78,
+		0x00, 0x24, 0x00, 0x00, 0xEE, 0x18, 0x00, 0x30, 0x00, 0xCC, 0x18, 0x36, 0x00, 0xF0, 0x0C, 0x0C,
+		0x00, 0x66, 0x00, 0xFC, 0xFE, 0x18, 0xEC, 0x30, 0x70, 0x78, 0x00, 0x36, 0xFF, 0xF0, 0x7E, 0x38,
+		0x00, 0xFF, 0xFC, 0x00, 0xD6, 0x18, 0xFE, 0x1C, 0x30, 0xFC, 0x18, 0x36, 0x00, 0xF0, 0xDB, 0x60,
+		0x00, 0x66, 0x00, 0xFC, 0xC6, 0x18, 0xD6, 0x30, 0x30, 0x30, 0x18, 0xFE, 0xFF, 0xF0, 0xDB, 0x7C,
+		0x00, 0x24, 0x00, 0x00, 0xC6, 0x18, 0xC6, 0x30, 0x30, 0xFC, 0x3C, 0x00, 0x00, 0xF0, 0x7E, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xC6, 0x78, 0xC6, 0xE0, 0x78, 0x30, 0x3C, 0x00, 0x00, 0xF0, 0x60, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0xF0, 0xC0, 0x00,
+		0x7F, 0x00, 0x00, 0x60, 0xC6, 0x10, 0x00, 0x76, 0xCC, 0xF0, 0x00, 0x18, 0x36, 0x0F, 0x3C, 0x00,
+		0x63, 0x18, 0x00, 0x30, 0xE6, 0x38, 0x00, 0xDC, 0x30, 0xD8, 0x33, 0x18, 0x36, 0x0F, 0x60, 0x00,
+		0x7F, 0x3C, 0x00, 0x18, 0xF6, 0x6C, 0xF8, 0x00, 0x78, 0xD8, 0x66, 0xF8, 0xF7, 0x0F, 0xC0, 0x3C,
+		0x63, 0x7E, 0x00, 0x0C, 0xDE, 0xC6, 0xCC, 0x00, 0xCC, 0xF4, 0xCC, 0x18, 0x00, 0x0F, 0xFC, 0x3C,
+		0x63, 0xFF, 0x00, 0x18, 0xCE, 0x00, 0xCC, 0x00, 0xCC, 0xCC, 0x66, 0xF8, 0xF7, 0x0F, 0xC0, 0x3C,
+		0x67, 0xFF, 0x30, 0x30, 0xC6, 0x00, 0xCC, 0x00, 0xFC, 0xDE, 0x33, 0x00, 0x36, 0x0F, 0x60, 0x3C,
+		0xE6, 0x00, 0x30, 0x60, 0xC6, 0x00, 0xCC, 0x00, 0xCC, 0xCC, 0x00, 0x00, 0x36, 0x0F, 0x3C, 0x00,
+		0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x36, 0x0F, 0x00, 0x00,
+		0x99, 0x00, 0x06, 0x78, 0x38, 0x00, 0x00, 0x10, 0x30, 0x0E, 0x00, 0x00, 0x18, 0xFF, 0x78, 0x00,
+		0x5A, 0xFF, 0x0C, 0xCC, 0x6C, 0x00, 0x00, 0x38, 0x30, 0x1B, 0xCC, 0x00, 0x18, 0xFF, 0xCC, 0x00,
+		0x3C, 0xFF, 0x18, 0x0C, 0xC6, 0x00, 0x78, 0x6C, 0x00, 0x18, 0x66, 0x00, 0xFF, 0xFF, 0xCC, 0x00,
+		0xE7, 0x7E, 0x30, 0x18, 0xC6, 0x00, 0xCC, 0xC6, 0x78, 0x7E, 0x33, 0x00, 0x00, 0xFF, 0xCC, 0x00,
+		0xE7, 0x3C, 0x60, 0x30, 0xC6, 0x00, 0xCC, 0xC6, 0xCC, 0x18, 0x66, 0xF8, 0xFF, 0x00, 0xCC, 0x00,
+		0x3C, 0x18, 0xC0, 0x00, 0x6C, 0x00, 0xCC, 0xC6, 0xFC, 0x18, 0xCC, 0x18, 0x00, 0x00, 0xCC, 0x00,
+		0x5A, 0x00, 0x80, 0x30, 0x38, 0x00, 0x78, 0xFE, 0xCC, 0xD8, 0x00, 0x18, 0x00, 0x00, 0xCC, 0x00,
+		0x99, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x70, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00
+	};
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	/// writes @a color into the locked @a image wherever the built in font has a pixel set
+	template <int BYTES_PER_PIXEL>
+	static void ExpandDefaultFont(SDL_Surface* image, Uint32 color)
+	{
+		const unsigned char* bits = defaultFontBits;
+		Uint8* rowPixels = static_cast<Uint8*>(image->pixels);
+		
+		for (int y = 0; y < DEFAULT_FONT_SIZE; y++, rowPixels += image->pitch)
+		{
+			Uint8* pixel = rowPixels;
 			
-			// 24 bits per pixel
-			case 3: 
+			for (int column = 0; column < DEFAULT_FONT_SIZE / 8; column++, bits++)
 			{
-				if (SDL_LIL_ENDIAN == SDL_BYTEORDER)
+				if (!*bits)
 				{
-					for (int y = 0; y < 128; y++)
-					{
-						for (int x = 0; x < 128; x++)
-						{
-							if (0 != defaultFont[x + (y * 128)])
-							{
-								unsigned char* imageDataBuffer = 
-									static_cast<unsigned char*>(
-										static_cast<unsigned char*>(fontImage_->pixels) + y * fontImage_->pitch + x * 3);
-							
-								imageDataBuffer[0] = whitePixel;
-								imageDataBuffer[1] = whitePixel >> 8;
-								imageDataBuffer[2] = whitePixel >> 16;
-							}
-						}
-					}
+					pixel += 8 * BYTES_PER_PIXEL;
+					continue;
 				}
-				else
-				{
-					for (int y = 0; y < 128; y++)
-					{
-						for (int x = 0; x < 128; x++)
-						{
-							if (0 != defaultFont[x + (y * 128)])
-							{
-								unsigned char* imageDataBuffer = 
-									static_cast<unsigned char*>(
-										static_cast<unsigned char*>(fontImage_->pixels) + y * fontImage_->pitch + x * 3);
-							
-								imageDataBuffer[2] = whitePixel;
-								imageDataBuffer[1] = whitePixel >> 8;
-								imageDataBuffer[0] = whitePixel >> 16;
-							}
-						}
-					}
-				}
-			} break;
-			
-			// 32 bits per pixel
-			case 4: 
-			{
-				unsigned int pitchOver4 = fontImage_->pitch / 4;
-				for (int y = 0; y < 128; y++)
+				
+				for (unsigned int mask = 0x80; mask; mask >>= 1, pixel += BYTES_PER_PIXEL)
 				{
-					for (int x = 0; x < 128; x++)
+					if (*bits & mask)
 					{
-						if (0 != defaultFont[x + (y * 128)])
-						{
-							unsigned int* imageDataBuffer = 
-								static_cast<unsigned int*>(
-									static_cast<unsigned int*>(fontImage_->pixels) + y * pitchOver4 + x);
-							*imageDataBuffer = whitePixel;
-						}
+						WritePixel<BYTES_PER_PIXEL>(pixel, color);
 					}
 				}
-			} break;
+			}
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	BitmapFont::BitmapFont() :
+		fontImage_(0),
+		letterWidth_(8),
+		letterHeight_(8),
+		spacing_(1),
+		glyphColor_(0),
+		compiledImage_(0),
+		generation_(++lastFontGeneration)
+	{
+		fontImage_ = SDL_CreateRGBSurface(
+			SDL_SRCCOLORKEY, 
+			DEFAULT_FONT_SIZE, DEFAULT_FONT_SIZE, globalEngineInstance->GetScreen()->format->BitsPerPixel, 0, 0, 0, 0);
+		SurfaceMemory::Track(fontImage_, SURFACE_CATEGORY_FONTS);
+		SDL_SetColorKey(fontImage_, (SDL_SRCCOLORKEY|SDL_RLEACCEL), SDL_MapRGB(fontImage_->format, 255, 0, 255));
+		SDL_FillRect(fontImage_, 0, SDL_MapRGB(fontImage_->format, 255, 0, 255));
+		
+		if (SDL_MUSTLOCK(fontImage_))
+		{
+			SDL_LockSurface(fontImage_);
+		}
+		
+		Uint32 whitePixel = SDL_MapRGB(fontImage_->format, 255, 255, 255);
+		
+		switch(fontImage_->format->BytesPerPixel)
+		{
+			case 1: ExpandDefaultFont<1>(fontImage_, whitePixel); break;
+			case 2: ExpandDefaultFont<2>(fontImage_, whitePixel); break;
+			case 3: ExpandDefaultFont<3>(fontImage_, whitePixel); break;
+			case 4: ExpandDefaultFont<4>(fontImage_, whitePixel); break;
 			default: break;
 		}
 		
@@ -406,6 +367,8 @@ namespace LOFI
 			SDL_UnlockSurface(fontImage_);
 		}
 		
+		this->CompileGlyphs();
+		
 	} // end constructor
 
 	////////////////////////////////////////////////////////////////////////////
@@ -417,13 +380,20 @@ namespace LOFI
 
 	////////////////////////////////////////////////////////////////////////////
 	
-	bool BitmapFont::Load(const char* filePath, int letterWidth, int letterHeight, int spacing)
+	bool BitmapFont::Load(const char* filePath, int letterWidth, int letterHeight, int spacing, AssetLoader* assetLoader)
 	{
 		Destroy();
 		
-		fontImage_ = Engine::LoadImageResource(filePath);
+		if (assetLoader)
+		{
+			assetLoader->Request(filePath, &fontImage_);
+		}
+		else
+		{
+			fontImage_ = Engine::LoadImageResource(filePath);
+		}
 		
-		if (!fontImage_)
+		if (!fontImage_ && !assetLoader)
 		{
 			return false;
 		}
@@ -431,6 +401,12 @@ namespace LOFI
 		letterWidth_ 	= letterWidth;
 		letterHeight_ 	= letterHeight;
 		spacing_ 		= spacing;
+		
+		// an image still on its way from the asset loader is compiled when it is first printed
+		if (!assetLoader)
+		{
+			this->CompileGlyphs();
+		}
 		return true;
 	}
 	
@@ -446,6 +422,8 @@ namespace LOFI
 			globalEngineInstance->GetScreen()->format->BitsPerPixel, 
 			0, 0, 0, 0);
 		
+		SurfaceMemory::Track(fontImage_, SURFACE_CATEGORY_FONTS);
+		
 		SDL_SetColorKey(fontImage_, (SDL_SRCCOLORKEY|SDL_RLEACCEL), SDL_MapRGB(fontImage_->format, 255, 0, 255));
 		
 		Engine::BlitSprite(source, fontImage_, 0, 0);
@@ -453,6 +431,8 @@ namespace LOFI
 		letterWidth_ 	= letterWidth;
 		letterHeight_ 	= letterHeight;
 		spacing_ 		= spacing;
+		
+		this->CompileGlyphs();
 	}
 
 	////////////////////////////////////////////////////////////////////////////
@@ -470,15 +450,54 @@ namespace LOFI
 		vsnprintf(textBuffer, BITFNT_MAX_STRING_LENGTH - 1, text, va);
 		va_end(va);
 		
-		unsigned int textLength = strlen(textBuffer);
+		this->PrintText(destination, x, y, textBuffer, strlen(textBuffer));
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void BitmapFont::PrintText(SDL_Surface* destination, int x, int y, const char* textBuffer, unsigned int textLength)
+	{
+		PROFILE_SCOPE(PROFILE_ZONE_FONTPRINT);
+		
+		if (!fontImage_ || !textBuffer)
+		{
+			return;
+		}
 		
 		// save the origin, and a drawing cursor location
 		int originX = x;
 		int cursorX = x;
 		int cursorY = y;
 		
-		// default tab size is 8
-		int tabSize = (8 * letterWidth_) + (7 * spacing_);
+		int tabSize = this->GetTabWidth();
+		
+		if (compiledImage_ != fontImage_)
+		{
+			this->CompileGlyphs();
+		}
+		
+		// the compiled letters are raw pixels of the font image, so they can only be written to a surface of its format
+		const SDL_PixelFormat* fontFormat = fontImage_->format;
+		const SDL_PixelFormat* destinationFormat = destination->format;
+		
+		bool writeDirectly =
+			!glyphRows_.empty() &&
+			fontFormat->BytesPerPixel > 1 &&
+			fontFormat->BytesPerPixel == destinationFormat->BytesPerPixel &&
+			fontFormat->Rmask == destinationFormat->Rmask &&
+			fontFormat->Gmask == destinationFormat->Gmask &&
+			fontFormat->Bmask == destinationFormat->Bmask;
+		
+		// the whole string is written in one lock of the destination
+		bool locked = writeDirectly && SDL_MUSTLOCK(destination);
+		if (locked && SDL_LockSurface(destination) < 0)
+		{
+			writeDirectly = false;
+			locked = false;
+		}
+		
+		const unsigned int* colors = (glyphColors_.empty()) ? 0 : &glyphColors_[0];
+		int glyphPixels = letterWidth_ * letterHeight_;
 		
 		for (unsigned int index = 0; index < textLength; index++)
 		{
@@ -503,14 +522,30 @@ namespace LOFI
 					// any other character just gets printed
 					
 					// get the letter
-					int letter = textBuffer[index];
+					int letter = static_cast<unsigned char>(textBuffer[index]);
 					
-					// find the position of the letter
-					int letterX = (letter / 16) * letterWidth_;
-					int letterY = (letter % 16) * letterHeight_;
-					
-					// blit the damn thing!
-					Engine::Blit(fontImage_, destination, letterX, letterY, cursorX, cursorY, letterWidth_, letterHeight_);
+					if (writeDirectly)
+					{
+						const unsigned int* rows = &glyphRows_[letter * letterHeight_];
+						const unsigned int* letterColors = (colors) ? colors + letter * glyphPixels : 0;
+						
+						switch(destinationFormat->BytesPerPixel)
+						{
+							case 2: DrawGlyph<2>(destination, cursorX, cursorY, rows, letterColors, glyphColor_, letterWidth_, letterHeight_); break;
+							case 3: DrawGlyph<3>(destination, cursorX, cursorY, rows, letterColors, glyphColor_, letterWidth_, letterHeight_); break;
+							case 4: DrawGlyph<4>(destination, cursorX, cursorY, rows, letterColors, glyphColor_, letterWidth_, letterHeight_); break;
+							default: break;
+						}
+					}
+					else
+					{
+						// find the position of the letter
+						int letterX = (letter / 16) * letterWidth_;
+						int letterY = (letter % 16) * letterHeight_;
+						
+						// blit the damn thing!
+						Engine::Blit(fontImage_, destination, letterX, letterY, cursorX, cursorY, letterWidth_, letterHeight_);
+					}
 					
 					// advance cursor position
 					cursorX += letterWidth_;
@@ -518,6 +553,11 @@ namespace LOFI
 				} break;
 			}
 		}
+		
+		if (locked)
+		{
+			SDL_UnlockSurface(destination);
+		}
 	}
 
 	////////////////////////////////////////////////////////////////////////////
@@ -543,6 +583,52 @@ namespace LOFI
 	
 	////////////////////////////////////////////////////////////////////////////
 
+	int BitmapFont::GetTabWidth() const
+	{
+		// default tab size is 8
+		return (8 * letterWidth_) + (7 * spacing_);
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	void BitmapFont::MeasureText(const char* text, unsigned int length, int* width, int* height) const
+	{
+		int cursorX = 0;
+		int cursorY = 0;
+		int right = 0;
+		int bottom = 0;
+		
+		for (unsigned int index = 0; index < length; index++)
+		{
+			switch(text[index])
+			{
+				case '\n':
+				{
+					cursorX = 0;
+					cursorY += letterHeight_ + spacing_;
+				} break;
+				
+				case '\t':
+				{
+					cursorX += this->GetTabWidth();
+				} break;
+				
+				default:
+				{
+					right = std::max(right, cursorX + letterWidth_);
+					bottom = std::max(bottom, cursorY + letterHeight_);
+					
+					cursorX += letterWidth_ + spacing_;
+				} break;
+			}
+		}
+		
+		*width = right;
+		*height = bottom;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
 	SDL_Surface* BitmapFont::GetFontImage() const
 	{
 		return fontImage_;
@@ -550,12 +636,116 @@ namespace LOFI
 	
 	////////////////////////////////////////////////////////////////////////////
 
+	unsigned int BitmapFont::GetGeneration() const
+	{
+		return generation_;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
 	void BitmapFont::Destroy()
 	{
 		if (0 != fontImage_)
 		{
 			Engine::UnloadImageResource(fontImage_);
+			fontImage_ = 0;
+		}
+		
+		glyphRows_.clear();
+		glyphColors_.clear();
+		compiledImage_ = 0;
+		
+		// whatever was cached for the old image no longer matches
+		generation_ = ++lastFontGeneration;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	bool BitmapFont::CompileGlyphs()
+	{
+		glyphRows_.clear();
+		glyphColors_.clear();
+		compiledImage_ = fontImage_;
+		
+		if (!fontImage_ || letterWidth_ <= 0 || letterHeight_ <= 0 || letterWidth_ > BITFNT_MAX_COMPILED_WIDTH)
+		{
+			return false;
+		}
+		
+		const SDL_PixelFormat* format = fontImage_->format;
+		int bytesPerPixel = format->BytesPerPixel;
+		
+		bool keyed = 0 != (fontImage_->flags & SDL_SRCCOLORKEY);
+		Uint32 colorKey = format->colorkey;
+		
+		if (SDL_MUSTLOCK(fontImage_) && SDL_LockSurface(fontImage_) < 0)
+		{
+			return false;
+		}
+		
+		int glyphPixels = letterWidth_ * letterHeight_;
+		
+		glyphRows_.resize(BITFNT_LETTER_COUNT * letterHeight_, 0);
+		
+		// every pixel's color is kept until the font turns out to be all one color, which they nearly always are
+		std::vector<unsigned int> colors(BITFNT_LETTER_COUNT * glyphPixels, 0);
+		bool oneColor = true;
+		bool anyOpaque = false;
+		
+		for (int letter = 0; letter < BITFNT_LETTER_COUNT; letter++)
+		{
+			// the letters run down the columns of the font image, the same as Print() blits them
+			int letterX = (letter / 16) * letterWidth_;
+			int letterY = (letter % 16) * letterHeight_;
+			
+			for (int row = 0; row < letterHeight_; row++)
+			{
+				int imageY = letterY + row;
+				if (imageY >= fontImage_->h)
+				{
+					break;
+				}
+				
+				const Uint8* imageRow = static_cast<const Uint8*>(fontImage_->pixels) + imageY * fontImage_->pitch;
+				unsigned int bits = 0;
+				
+				for (int column = 0; column < letterWidth_ && letterX + column < fontImage_->w; column++)
+				{
+					Uint32 pixel = ReadPixel(imageRow + (letterX + column) * bytesPerPixel, bytesPerPixel);
+					if (keyed && pixel == colorKey)
+					{
+						continue;
+					}
+					
+					bits |= 1u << column;
+					colors[letter * glyphPixels + row * letterWidth_ + column] = pixel;
+					
+					if (!anyOpaque)
+					{
+						glyphColor_ = pixel;
+						anyOpaque = true;
+					}
+					else if (pixel != glyphColor_)
+					{
+						oneColor = false;
+					}
+				}
+				
+				glyphRows_[letter * letterHeight_ + row] = bits;
+			}
 		}
+		
+		if (SDL_MUSTLOCK(fontImage_))
+		{
+			SDL_UnlockSurface(fontImage_);
+		}
+		
+		if (!oneColor)
+		{
+			glyphColors_.swap(colors);
+		}
+		
+		return true;
 	}
 	
 } // end namespace
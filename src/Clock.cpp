@@ -0,0 +1,96 @@
+
+// CODESTYLE: v2.0
+
+// Clock.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: monotonic wall-clock time source and precise sleeping for the main loop
+
+/**
+ * @file Clock.cpp
+ * @brief Monotonic Clock - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#elif defined(__APPLE__)
+	#include <mach/mach_time.h>
+#else
+	#include <time.h>
+#endif
+
+// how far ahead of a deadline we stop sleeping and start spinning
+#define CLOCK_SPIN_THRESHOLD 2000
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	Microseconds Clock::GetMicroseconds()
+	{
+		#if defined(_WIN32)
+
+		static LARGE_INTEGER frequency = { { 0, 0 } };
+		if (0 == frequency.QuadPart)
+		{
+			QueryPerformanceFrequency(&frequency);
+		}
+
+		LARGE_INTEGER counter;
+		QueryPerformanceCounter(&counter);
+
+		return static_cast<Microseconds>(
+			(counter.QuadPart / frequency.QuadPart) * 1000000 +
+			((counter.QuadPart % frequency.QuadPart) * 1000000) / frequency.QuadPart);
+
+		#elif defined(__APPLE__)
+
+		static mach_timebase_info_data_t timebase = { 0, 0 };
+		if (0 == timebase.denom)
+		{
+			mach_timebase_info(&timebase);
+		}
+
+		return static_cast<Microseconds>(
+			(mach_absolute_time() * timebase.numer / timebase.denom) / 1000);
+
+		#elif defined(CLOCK_MONOTONIC)
+
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+
+		return static_cast<Microseconds>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+
+		#else
+
+		// no monotonic clock on this platform, so fall back on the millisecond timer
+		return static_cast<Microseconds>(SDL_GetTicks()) * 1000;
+
+		#endif
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Clock::SleepUntil(Microseconds deadline)
+	{
+		Microseconds remaining = deadline - Clock::GetMicroseconds();
+
+		// sleep away all but the last couple of milliseconds
+		while (remaining > CLOCK_SPIN_THRESHOLD)
+		{
+			SDL_Delay(static_cast<Uint32>((remaining - CLOCK_SPIN_THRESHOLD) / 1000) + 1);
+			remaining = deadline - Clock::GetMicroseconds();
+		}
+
+		// and spin out the rest so we wake up right on time
+		while (remaining > 0)
+		{
+			remaining = deadline - Clock::GetMicroseconds();
+		}
+	}
+
+} // end namespace
+
@@ -16,10 +16,29 @@
 
 #define PROJECT_WINDOW_CAPTION "CCPS Solutions Presents: LWC v2.3"
 
+// better input handling
+#define MOTIONBUTTON_UP 			0x0
+#define MOTIONBUTTON_DOWN 			0x1
+#define MOTIONBUTTON_STRAFELEFT 	0x2
+#define MOTIONBUTTON_STRAFERIGHT 	0x3
+
+// slow the fucking player down! (microseconds between steps while a motion button is held)
+#define PLAYER_MOTION_REPEAT_DELAY 	200000
+
+// how long an action message stays on the HUD (microseconds)
+#define ACTION_MESSAGE_DURATION 	1000000
+
+// the most wall-clock time a single frame may feed into the simulation (microseconds)
+#define ENGINE_MAX_SIMULATION_LAG 	250000
+
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace LOFI
 {
+	unsigned long Engine::pixelsWritten_ = 0;
+	
+	////////////////////////////////////////////////////////////////////////////
+
 	BitmapFont* Engine::GetDefaultBitmapFont() const
 	{
 		return defaultFont_;
@@ -36,8 +55,21 @@ namespace LOFI
 
 	SDL_Surface* Engine::LoadImageResource(const char* filePath)
 	{
-		// attempt to pre-load the image
-		SDL_Surface* preLoad = IMG_Load(filePath);
+		// share the image if it is already loaded
+		return ResourceCache::Acquire(filePath);
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* Engine::DecodeImageResource(const char* filePath, bool useArchive)
+	{
+		// attempt to pre-load the image, from the asset archive if it has it
+		SDL_Surface* preLoad = (useArchive) ? AssetArchive::LoadImage(filePath) : 0;
+		
+		if (!preLoad)
+		{
+			preLoad = IMG_Load(filePath);
+		}
 
 		// if it failed to load
 		if (!preLoad)
@@ -55,6 +87,21 @@ namespace LOFI
 		// Scrim's art uses alpha which gets turned into black, so we set the colorkey to black
 		SDL_SetColorKey(preLoad, (SDL_SRCCOLORKEY | SDL_RLEACCEL), SDL_MapRGB(preLoad->format, 0, 0, 0));
 
+		// return success
+		return preLoad;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* Engine::ConvertImageResource(SDL_Surface* preLoad)
+	{
+		// the decode failed and has already been logged
+		if (!preLoad)
+		{
+			// return null
+			return 0;
+		}
+
 		// convert the image to the proper format and set the image resource surface
 		SDL_Surface* surface = SDL_DisplayFormat(preLoad);
 
@@ -81,7 +128,12 @@ namespace LOFI
 	{
 		if (image)
 		{
-			SDL_FreeSurface(image);
+			// cached images are freed when their last reference goes, anything else right away
+			if (!ResourceCache::Release(image))
+			{
+				SurfaceMemory::Untrack(image);
+				SDL_FreeSurface(image);
+			}
 			
 			// de-init the pointer
 			image = 0;
@@ -126,6 +178,9 @@ namespace LOFI
 		
 		// blit
 		SDL_BlitSurface(source, &sourceRect, target, &targetRect);
+		
+		// SDL hands back the clipped rect that was actually written
+		pixelsWritten_ += targetRect.w * targetRect.h;
 	}
 	
 	////////////////////////////////////////////////////////////////////////////
@@ -160,6 +215,44 @@ namespace LOFI
 		
 		// blit
 		SDL_BlitSurface(source, 0, target, &targetRect);
+		
+		// SDL hands back the clipped rect that was actually written
+		pixelsWritten_ += targetRect.w * targetRect.h;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	void Engine::FillRect(SDL_Surface* target, SDL_Rect* rect, unsigned int color)
+	{
+		// we cannot fill a surface that does not exist!
+		if (!target)
+		{
+			// log the error
+			WriteLog(stderr, "Cannot fill a surface that has not been initialized!\n");
+
+			// return
+			return;
+		}
+		
+		// fill
+		SDL_FillRect(target, rect, color);
+		
+		// SDL clips the rect in place
+		pixelsWritten_ += (rect) ? (rect->w * rect->h) : (target->clip_rect.w * target->clip_rect.h);
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned long Engine::GetPixelsWritten()
+	{
+		return pixelsWritten_;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	void Engine::ResetPixelsWritten()
+	{
+		pixelsWritten_ = 0;
 	}
 	
 	////////////////////////////////////////////////////////////////////////////
@@ -168,12 +261,52 @@ namespace LOFI
 		engineIsRunning_(false),
 		screen_(0),
 		mainScreen_(0),
+		presenter_(0),
+		presentThread_(false),
 		event_(0),
 		artManager_(0),
 		mapView_(0),
 		gameState_(0),
-		defaultFont_(0)
+		defaultFont_(0),
+		textCache_(0),
+		headless_(false),
+		frameLimit_(0),
+		screenshotPath_(0),
+		workerThreads_(-1),
+		archivePath_(0),
+		tracePath_(0),
+		pixelCachePath_(PIXELCACHE_DEFAULT_DIRECTORY),
+		artMemoryBudget_(ART_DEFAULT_MEMORY_BUDGET),
+		surfaceMemoryBudget_(0),
+		hotReload_(false),
+		assetWatcher_(0),
+		timers_(0),
+		threadPool_(0),
+		simulationStep_(1000000 / ENGINE_DEFAULT_SIMULATION_RATE),
+		framePeriod_(1000000 / ENGINE_DEFAULT_FRAME_RATE),
+		miniMap_(0),
+		showAutomap_(false),
+		mapPyramid_(0),
+		showWorldOverview_(false),
+		worldOverviewLevel_(0),
+		actionMessageSerial_(0),
+		laidOutMessageSerial_(0),
+		actionMessageTimer_(0),
+		requestUpdateDisplay_(true),
+		showProfilerOverlay_(false),
+		playerMotionCooldown_(PLAYER_MOTION_REPEAT_DELAY),
+		simulationThread_(0),
+		simulationRunning_(false),
+		simulationChanged_(true),
+		inputQueueHead_(0),
+		inputQueueTail_(0)
 	{
+		hudActionMessage_[0] = 0;
+		
+		for (int index = 0; index < 4; index++)
+		{
+			motionButtonDown_[index] = false;
+		}
 	}
 
 	////////////////////////////////////////////////////////////////////////////
@@ -193,6 +326,41 @@ namespace LOFI
 
 	bool Engine::Initialize(int args, char* argv[])
 	{
+		// read the command line options
+		if (!this->ParseCommandLine(args, argv))
+		{
+			// return failure
+			return false;
+		}
+		
+		// the trace starts before everything else, so it takes in the start-up
+		if (tracePath_ && !TraceRecorder::Start(tracePath_))
+		{
+			// return failure
+			return false;
+		}
+		
+		if (!this->InitializeGame())
+		{
+			// Destroy() is never called after a failed start, so close the trace here to leave it valid
+			TraceRecorder::Stop();
+			
+			// return failure
+			return false;
+		}
+		
+		// return success
+		return true;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	bool Engine::InitializeGame()
+	{
+		// time the start-up, which only shows up when recording a trace
+		PROFILE_SCOPE(PROFILE_ZONE_LOADING);
+		Microseconds startupStart = Clock::GetMicroseconds();
+		
 		// initialize the external libraries
 		if (!this->InitializeLibraries())
 		{
@@ -208,7 +376,10 @@ namespace LOFI
 		}
 		
 		// set the window caption
-		SDL_WM_SetCaption(PROJECT_WINDOW_CAPTION, 0);
+		if (!headless_)
+		{
+			SDL_WM_SetCaption(PROJECT_WINDOW_CAPTION, 0);
+		}
 
 		// create the SDL event handler instance
 		event_ = new SDL_Event;
@@ -221,19 +392,196 @@ namespace LOFI
 			return false;
 		}
 		
+		// read the resources from the packed archive when there is one, and from loose files otherwise
+		if (archivePath_)
+		{
+			if (!AssetArchive::Mount(archivePath_))
+			{
+				// return failure
+				return false;
+			}
+		}
+		else
+		{
+			AssetArchive::Mount(ASSETARCHIVE_DEFAULT_PATH);
+		}
+		
+		// the converted images depend on the display format, so this waits until the screen is up
+		PixelCache::SetDirectory(pixelCachePath_);
+		
+		SurfaceMemory::SetBudget(surfaceMemoryBudget_);
+		
+		threadPool_ = new ThreadPool(workerThreads_);
+		
+		// queue up all of the art, and decode it in parallel below
+		AssetLoader assetLoader(threadPool_);
+		
 		defaultFont_ = new BitmapFont();
-		defaultFont_->Load("resources/fonts/font8x8white.png", 8, 8, 1);
+		defaultFont_->Load("resources/fonts/font8x8white.png", 8, 8, 1, &assetLoader);
+		textCache_ = new TextCache();
 		
-		// create the art manager
-		artManager_ = new ArtManager();
+		// create the art manager, the wall sets load as they are needed
+		artManager_ = new ArtManager(threadPool_);
+		artManager_->SetMemoryBudget(artMemoryBudget_);
 		mapView_ = new MapView(artManager_);
 		gameState_ = new GameState();
+		timers_ = new TimerQueue();
+		
+		assetLoader.Request("resources/overlays/mainscreen.png", &mainScreenOverlay_);
+		
+		// small compass overlay images
+		assetLoader.Request("resources/overlays/sm_compass_n.png", &smallCompassOverlay_[0]);
+		assetLoader.Request("resources/overlays/sm_compass_e.png", &smallCompassOverlay_[1]);
+		assetLoader.Request("resources/overlays/sm_compass_s.png", &smallCompassOverlay_[2]);
+		assetLoader.Request("resources/overlays/sm_compass_w.png", &smallCompassOverlay_[3]);
+		
+		assetLoader.Finish();
+		
+		if (!mainScreenOverlay_)
+		{
+			// return failure
+			return false;
+		}
 
 		// start our engines ^-^
 		engineIsRunning_ = true;
 		
 		gameState_->StartNewGame();
+		
+		// start loading the walls around the starting point
+		artManager_->Prefetch(gameState_->GetCurrentMap(), gameState_->GetPlayerPosition());
+		
+		if (hotReload_)
+		{
+			std::vector<std::string> artDirectories;
+			artManager_->GetArtDirectories(&artDirectories);
+			
+			assetWatcher_ = new AssetWatcher();
+			for (unsigned int index = 0; index < artDirectories.size(); index++)
+			{
+				assetWatcher_->Watch(artDirectories[index]);
+			}
+			
+			// the game still runs without it
+			if (!assetWatcher_->Start())
+			{
+				delete assetWatcher_;
+				assetWatcher_ = 0;
+			}
+		}
+		
+		// a minimap
+		miniMap_ = new MiniMap(gameState_->GetCurrentMap(), 140, 140);
+		miniMap_->SetAutomap(showAutomap_);
+		
+		// the world overview
+		mapPyramid_ = new MapPyramid();
+		
+		WriteLog(stderr, "Engine started in %lldus.\n", static_cast<long long>(Clock::GetMicroseconds() - startupStart));
+		ResourceCache::WriteReport(stderr);
+		SurfaceMemory::WriteReport(stderr);
+
+		// return success
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool Engine::ParseCommandLine(int args, char* argv[])
+	{
+		for (int index = 1; index < args; index++)
+		{
+			if (0 == strcmp(argv[index], "--fps") && index + 1 < args)
+			{
+				// the target frame rate, zero runs uncapped
+				this->SetTargetFrameRate(atoi(argv[++index]));
+			}
+			else if (0 == strcmp(argv[index], "--tick-rate") && index + 1 < args)
+			{
+				// the simulation rate
+				this->SetSimulationRate(atoi(argv[++index]));
+			}
+			else if (0 == strcmp(argv[index], "--profile"))
+			{
+				// start with the profiler overlay up
+				showProfilerOverlay_ = true;
+				Profiler::SetEnabled(true);
+			}
+			else if (0 == strcmp(argv[index], "--automap"))
+			{
+				// start with the walls shown on the mini-map
+				showAutomap_ = true;
+			}
+			else if (0 == strcmp(argv[index], "--headless"))
+			{
+				// render off-screen without opening a window
+				headless_ = true;
+			}
+			else if (0 == strcmp(argv[index], "--present-thread"))
+			{
+				// present the frames on a thread of their own
+				presentThread_ = true;
+			}
+			else if (0 == strcmp(argv[index], "--frames") && index + 1 < args)
+			{
+				// stop after this many frames
+				frameLimit_ = atoi(argv[++index]);
+			}
+			else if (0 == strcmp(argv[index], "--screenshot") && index + 1 < args)
+			{
+				// save the last frame as a BMP when the engine stops
+				screenshotPath_ = argv[++index];
+			}
+			else if (0 == strcmp(argv[index], "--archive") && index + 1 < args)
+			{
+				// load the resources from this archive instead of the default one
+				archivePath_ = argv[++index];
+			}
+			else if (0 == strcmp(argv[index], "--pixel-cache") && index + 1 < args)
+			{
+				// keep the converted images in this directory
+				pixelCachePath_ = argv[++index];
+			}
+			else if (0 == strcmp(argv[index], "--no-pixel-cache"))
+			{
+				// always decode and convert the images
+				pixelCachePath_ = 0;
+			}
+			else if (0 == strcmp(argv[index], "--worker-threads") && index + 1 < args)
+			{
+				// the size of the thread pool, zero does all the work on the main thread
+				workerThreads_ = atoi(argv[++index]);
+			}
+			else if (0 == strcmp(argv[index], "--surface-budget") && index + 1 < args)
+			{
+				// the most memory in KB all of the surfaces should use, zero for no limit
+				surfaceMemoryBudget_ = strtoul(argv[++index], 0, 10) * 1024;
+			}
+			else if (0 == strcmp(argv[index], "--hot-reload"))
+			{
+				// reload the wall art when it changes on disk
+				hotReload_ = true;
+			}
+			else if (0 == strcmp(argv[index], "--art-budget") && index + 1 < args)
+			{
+				// the most memory in KB the wall sets may use, zero for no limit
+				artMemoryBudget_ = strtoul(argv[++index], 0, 10) * 1024;
+			}
+			else if (0 == strcmp(argv[index], "--trace") && index + 1 < args)
+			{
+				// record every profiled scope to a Chrome trace file, once the options are all read
+				tracePath_ = argv[++index];
+			}
+			else
+			{
+				// log the error
+				WriteLog(stderr, "Unknown command line option \"%s\"!\n", argv[index]);
 
+				// return failure
+				return false;
+			}
+		}
+		
 		// return success
 		return true;
 	}
@@ -242,8 +590,20 @@ namespace LOFI
 
 	bool Engine::InitializeLibraries()
 	{
+		Uint32 subsystems = SDL_INIT_EVERYTHING;
+		
+		if (headless_)
+		{
+			// SDL's dummy video driver gives us an off-screen framebuffer and never touches a display,
+			// and we leave out the audio, joystick and cd-rom subsystems a build host may not have
+			static char dummyVideoDriver[] = "SDL_VIDEODRIVER=dummy";
+			SDL_putenv(dummyVideoDriver);
+			
+			subsystems = SDL_INIT_VIDEO | SDL_INIT_TIMER;
+		}
+		
 		// initialize SDL
-		if (SDL_Init(SDL_INIT_EVERYTHING) < 0)
+		if (SDL_Init(subsystems) < 0)
 		{
 			// log the error
 			WriteLog(stderr, "SDL Library Initialization Failed!\n\tSDL Error: %s\n", SDL_GetError());
@@ -251,6 +611,18 @@ namespace LOFI
 			// return failure
 			return false;
 		}
+		
+		#if (SDL_IMAGE_MAJOR_VERSION * 10000 + SDL_IMAGE_MINOR_VERSION * 100 + SDL_IMAGE_PATCHLEVEL) >= 10210
+		// load the PNG decoder now, so the asset loader's threads never race to do it
+		if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
+		{
+			// log the error
+			WriteLog(stderr, "SDL_image PNG Initialization Failed!\n\tSDL_image Error: %s\n", IMG_GetError());
+
+			// return failure
+			return false;
+		}
+		#endif
 
 		// return success
 		return true;
@@ -261,7 +633,7 @@ namespace LOFI
 	bool Engine::InitializeScreen()
 	{
 		// initialize the screen
-		mainScreen_ = SDL_SetVideoMode(640, 480, 24, SDL_HWSURFACE | SDL_DOUBLEBUF);
+		mainScreen_ = SDL_SetVideoMode(640, 480, 24, (headless_) ? SDL_SWSURFACE : (SDL_HWSURFACE | SDL_DOUBLEBUF));
 		
 		if (!mainScreen_)
 		{
@@ -282,6 +654,13 @@ namespace LOFI
 			// return failure
 			return false;
 		}
+		
+		SurfaceMemory::Track(mainScreen_, SURFACE_CATEGORY_SCREENS);
+		SurfaceMemory::Track(screen_, SURFACE_CATEGORY_SCREENS);
+		
+		// the frames are drawn onto the screen and flipped; only drawn into back buffers and presented on a
+		// thread of their own when asked for, as SDL 1.2 wants the video calls made on the thread that pumps the events
+		presenter_ = new Presenter(mainScreen_, !headless_, presentThread_);
 
 		// return success
 		return true;
@@ -294,367 +673,805 @@ namespace LOFI
 		// we don't have a state stack processor system yet
 		// so lets just get a basic while loop running for testing
 		
+		this->SetActionMessage("Starting Out...");
 		
-		Position playerPosition(0, 0, 0); 
-		char hudActionMessage[0x100];
-		char compassMessage[0x32];
-		bool requestUpdateDisplay = true;
-		bool requestClearActionMessage = false;
-		int actionMessageClearDelay = 50;
-		int actionMessageClearCounter = actionMessageClearDelay;
-		
-				
-		sprintf(hudActionMessage, "%s", "Starting Out...");
-		
-		int actionMessageX = ((screen_->w / 2) - ((strlen(hudActionMessage) * 9) / 2));
-		
-		playerPosition.Copy(gameState_->GetPlayerPosition());
+		// the first state is taken at once, so the keys and the first frame never see an empty snapshot
+		this->PublishSnapshot();
+		this->ConsumeSnapshot();
 		
-		int playerX = playerPosition.x_;
-		int playerZ = playerPosition.y_;
-		int compass = playerPosition.facing_;
+		// the simulation steps on a thread of its own, so a slow frame never holds up the key presses;
+		// if the thread can't be started it is stepped here between frames instead
+		this->StartSimulationThread();
 		
-		sprintf(compassMessage, "You are facing %s.",
-			(0x0 == playerPosition.facing_) ? "North" :
-			(0x1 == playerPosition.facing_) ? "East" :
-			(0x2 == playerPosition.facing_) ? "South" :
-			(0x3 == playerPosition.facing_) ? "West" : "<Invalid Direction>");
+		// the simulation runs in fixed steps of wall-clock time, independent of how fast we can draw
+		Microseconds previousTime = Clock::GetMicroseconds();
+		Microseconds nextFrameTime = previousTime;
+		Microseconds simulationLag = 0;
+		int framesPresented = 0;
 
-		int gameScreenX = 40;
-		int gameScreenY = mainScreen_->h / 2 - screen_->h / 2;
+		// while the engine is running
+		while(engineIsRunning_)
+		{
+			Microseconds currentTime = Clock::GetMicroseconds();
+			Microseconds elapsedTime = currentTime - previousTime;
+			previousTime = currentTime;
+			
+			{
+				PROFILE_SCOPE(PROFILE_ZONE_FRAME);
+				
+				// process the events
+				this->HandleEvents();
+				
+				// swap in any art that was edited since the last frame
+				if (assetWatcher_)
+				{
+					this->ReloadChangedArt();
+				}
+				
+				// run as many simulation steps as the wall-clock time calls for
+				if (!simulationThread_)
+				{
+					// after a stall (dragging the window, a breakpoint) don't try to catch up on all of it at once
+					simulationLag += (elapsedTime > ENGINE_MAX_SIMULATION_LAG) ? ENGINE_MAX_SIMULATION_LAG : elapsedTime;
+					
+					while (simulationLag >= simulationStep_)
+					{
+						this->UpdateSimulation();
+						simulationLag -= simulationStep_;
+					}
+				}
+				
+				// draw whatever the simulation has published since the last frame
+				if (this->ConsumeSnapshot())
+				{
+					requestUpdateDisplay_ = true;
+				}
+				
+				// keep the walls around the player loading in the background
+				const SimulationSnapshot& snapshot = snapshots_.GetReadBuffer();
+				Position playerPosition(snapshot.player_);
+				artManager_->Prefetch(snapshot.map_, &playerPosition);
+				
+				// the profiler overlay is drawn over the last frame, so keep redrawing while it is up
+				if (showProfilerOverlay_)
+				{
+					requestUpdateDisplay_ = true;
+				}
+				
+				// should we update the display?
+				if (requestUpdateDisplay_)
+				{
+					this->RenderFrame();
+					requestUpdateDisplay_ = false;
+				}
+				
+				if (showProfilerOverlay_)
+				{
+					Profiler::DrawOverlay(defaultFont_, presenter_->GetBackBuffer(), 384, 52);
+				}
+				
+				// flip the screen
+				this->FlipScreen();
+				
+				// nothing is being drawn now, so this is when the caches can let go of surfaces
+				SurfaceMemory::EnforceBudget();
+			}
+			
+			if (Profiler::IsEnabled())
+			{
+				Profiler::EndFrame();
+			}
+			
+			// batch runs stop on their own after a set number of frames
+			if (frameLimit_ > 0 && ++framesPresented >= frameLimit_)
+			{
+				this->Stop();
+			}
+			
+			// pace the frames to the target rate without drifting
+			if (framePeriod_ > 0)
+			{
+				nextFrameTime += framePeriod_;
+				
+				// if we fell more than a frame behind then start pacing afresh from now
+				if (nextFrameTime < Clock::GetMicroseconds() - framePeriod_)
+				{
+					nextFrameTime = Clock::GetMicroseconds();
+				}
+				
+				Clock::SleepUntil(nextFrameTime);
+			}
+		} // end while
 		
+		this->StopSimulationThread();
 		
-		SDL_Surface* mainScreenOverlay = Engine::LoadImageResource("resources/overlays/mainscreen.png");
+		timers_->Clear();
+		actionMessageTimer_ = 0;
 		
-		if (!mainScreenOverlay)
+		// keep the last frame for batch rendering
+		if (screenshotPath_)
 		{
-			this->Stop();
-			return;
+			this->SaveScreenshot(screenshotPath_);
 		}
-		
-		// small compass overlay images
-		SDL_Surface** smallCompassOverlay = new SDL_Surface* [4];
-		
-		smallCompassOverlay[0] = Engine::LoadImageResource("resources/overlays/sm_compass_n.png");
-		smallCompassOverlay[1] = Engine::LoadImageResource("resources/overlays/sm_compass_e.png");
-		smallCompassOverlay[2] = Engine::LoadImageResource("resources/overlays/sm_compass_s.png");
-		smallCompassOverlay[3] = Engine::LoadImageResource("resources/overlays/sm_compass_w.png");
-
-
-		
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
 
-		// better input handling
-		const int MOTIONBUTTON_UP 			= 0x0;
-		const int MOTIONBUTTON_DOWN 		= 0x1;
-		const int MOTIONBUTTON_STRAFELEFT 	= 0x2;
-		const int MOTIONBUTTON_STRAFERIGHT 	= 0x3;
-		bool motionButtonDown[4] = { false, false, false, false };
-		
-		// slow the fucking player down!
-		int playerMotionDelay = 10;
-		int playerMotionCounter = playerMotionDelay;
-		
-		
-		// a minimap
-		MiniMap miniMap(gameState_->GetCurrentMap(), 140, 140);
+	void Engine::HandleEvents()
+	{
+		PROFILE_SCOPE(PROFILE_ZONE_INPUT);
 
-		// while the engine is running
-		while(engineIsRunning_)
+		// process the events
+		while(SDL_PollEvent(event_))
 		{
-			// process the events
-			while(SDL_PollEvent(event_))
+			switch(event_->type)
 			{
-				switch(event_->type)
+				// the window was closed
+				case SDL_QUIT:
 				{
-					// the window was closed
-					case SDL_QUIT:
-					{
-						// stop the engine
-						this->Stop();
-					} break;
+					// stop the engine
+					this->Stop();
+				} break;
 
-					// a key was pressed
-					case SDL_KEYDOWN:
+				// a key was pressed
+				case SDL_KEYDOWN:
+				{
+					// what key is down
+					switch(event_->key.keysym.sym)
 					{
-						// what key is down
-						switch(event_->key.keysym.sym)
+						case SDLK_ESCAPE:
 						{
-							case SDLK_ESCAPE:
-							{
-								// stop the engine
-								this->Stop();
-							} break;
-							
-							case 'w':
-							case 'W':
-							case SDLK_UP:
+							// stop the engine
+							this->Stop();
+						} break;
+						
+						case SDLK_F3:
+						{
+							// toggle the profiler overlay
+							showProfilerOverlay_ = !showProfilerOverlay_;
+							Profiler::SetEnabled(showProfilerOverlay_);
+							requestUpdateDisplay_ = true;
+						} break;
+						
+						case SDLK_TAB:
+						{
+							// toggle the walls on the mini-map
+							showAutomap_ = !showAutomap_;
+							miniMap_->SetAutomap(showAutomap_);
+							requestUpdateDisplay_ = true;
+						} break;
+						
+						case 'm':
+						case 'M':
+						{
+							// toggle the world overview, opening it on the whole map
+							showWorldOverview_ = !showWorldOverview_;
+							if (showWorldOverview_)
 							{
-								motionButtonDown[MOTIONBUTTON_UP] = true;
-							} break;
-							
-							case 's':
-							case 'S':
-							case SDLK_DOWN:
+								mapPyramid_->SetMap(snapshots_.GetReadBuffer().map_);
+								mapPyramid_->Update();
+								worldOverviewLevel_ = mapPyramid_->GetLevelToFit(screen_->w - 16, screen_->h - 16);
+							}
+							requestUpdateDisplay_ = true;
+						} break;
+						
+						case SDLK_EQUALS:
+						case SDLK_PLUS:
+						case SDLK_KP_PLUS:
+						{
+							// zoom the world overview in
+							if (showWorldOverview_ && worldOverviewLevel_ > 0)
 							{
-								motionButtonDown[MOTIONBUTTON_DOWN] = true;
-							} break;
-							
-							case 'q':
-							case 'Q':
-							case SDLK_COMMA:
-							case SDLK_LESS:
+								worldOverviewLevel_--;
+								requestUpdateDisplay_ = true;
+							}
+						} break;
+						
+						case SDLK_MINUS:
+						case SDLK_KP_MINUS:
+						{
+							// zoom the world overview out
+							if (showWorldOverview_ && worldOverviewLevel_ + 1 < mapPyramid_->GetLevelCount())
 							{
-								motionButtonDown[MOTIONBUTTON_STRAFELEFT] = true;
-							} break;
-							
-							case 'e':
-							case 'E':
-							case SDLK_PERIOD:
-							case SDLK_GREATER:
-							{
-								motionButtonDown[MOTIONBUTTON_STRAFERIGHT] = true;
-							} break;
-							
-							default: break;
-						} // end switch
-					} break;
-					
-					// a key was released
-					case SDL_KEYUP:
+								worldOverviewLevel_++;
+								requestUpdateDisplay_ = true;
+							}
+						} break;
+						
+						case 'w':
+						case 'W':
+						case SDLK_UP:
+						{
+							this->QueueInput(INPUT_MOTION_PRESSED, MOTIONBUTTON_UP);
+						} break;
+						
+						case 's':
+						case 'S':
+						case SDLK_DOWN:
+						{
+							this->QueueInput(INPUT_MOTION_PRESSED, MOTIONBUTTON_DOWN);
+						} break;
+						
+						case 'q':
+						case 'Q':
+						case SDLK_COMMA:
+						case SDLK_LESS:
+						{
+							this->QueueInput(INPUT_MOTION_PRESSED, MOTIONBUTTON_STRAFELEFT);
+						} break;
+						
+						case 'e':
+						case 'E':
+						case SDLK_PERIOD:
+						case SDLK_GREATER:
+						{
+							this->QueueInput(INPUT_MOTION_PRESSED, MOTIONBUTTON_STRAFERIGHT);
+						} break;
+						
+						default: break;
+					} // end switch
+				} break;
+				
+				// a key was released
+				case SDL_KEYUP:
+				{
+					// what key is up
+					switch(event_->key.keysym.sym)
 					{
-						// what key is up
-						switch(event_->key.keysym.sym)
+						case 'w':
+						case 'W':
+						case SDLK_UP:
 						{
-							case 'w':
-							case 'W':
-							case SDLK_UP:
-							{
-								motionButtonDown[MOTIONBUTTON_UP] = false;
-							} break;
-							
-							case 's':
-							case 'S':
-							case SDLK_DOWN:
-							{
-								motionButtonDown[MOTIONBUTTON_DOWN] = false;
-							} break;
-							
-							case 'q':
-							case 'Q':
-							case SDLK_COMMA:
-							case SDLK_LESS:
-							{
-								motionButtonDown[MOTIONBUTTON_STRAFELEFT] = false;
-							} break;
-							
-							case 'e':
-							case 'E':
-							case SDLK_PERIOD:
-							case SDLK_GREATER:
-							{
-								motionButtonDown[MOTIONBUTTON_STRAFERIGHT] = false;
-							} break;
-							
-							case 'a':
-							case 'A':
-							case SDLK_LEFT:
-							{
-								gameState_->TurnPlayerLeft();
-								sprintf(hudActionMessage, "%s", "Turned Left...");
-								requestUpdateDisplay = true;
-							} break;
-							
-							case 'd':
-							case 'D':
-							case SDLK_RIGHT:
-							{
-								gameState_->TurnPlayerRight();
-								sprintf(hudActionMessage, "%s", "Turned Right...");
-								requestUpdateDisplay = true;
-							} break;
-							default: break;
-						}
-					} break;
-
-					default: break;
-				} // end switch
-			} // end while
-			
+							this->QueueInput(INPUT_MOTION_RELEASED, MOTIONBUTTON_UP);
+						} break;
+						
+						case 's':
+						case 'S':
+						case SDLK_DOWN:
+						{
+							this->QueueInput(INPUT_MOTION_RELEASED, MOTIONBUTTON_DOWN);
+						} break;
+						
+						case 'q':
+						case 'Q':
+						case SDLK_COMMA:
+						case SDLK_LESS:
+						{
+							this->QueueInput(INPUT_MOTION_RELEASED, MOTIONBUTTON_STRAFELEFT);
+						} break;
+						
+						case 'e':
+						case 'E':
+						case SDLK_PERIOD:
+						case SDLK_GREATER:
+						{
+							this->QueueInput(INPUT_MOTION_RELEASED, MOTIONBUTTON_STRAFERIGHT);
+						} break;
+						
+						case 'a':
+						case 'A':
+						case SDLK_LEFT:
+						{
+							this->QueueInput(INPUT_TURN_LEFT);
+						} break;
+						
+						case 'd':
+						case 'D':
+						case SDLK_RIGHT:
+						{
+							this->QueueInput(INPUT_TURN_RIGHT);
+						} break;
+						default: break;
+					}
+				} break;
+
+				default: break;
+			} // end switch
+		} // end while
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	void Engine::UpdateSimulation()
+	{
+		PROFILE_SCOPE(PROFILE_ZONE_SIMULATION);
+		
+		// the key presses since the last step
+		InputCommand command = INPUT_MOTION_PRESSED;
+		int button = 0;
+		
+		while (this->TakeInput(&command, &button))
+		{
+			switch(command)
+			{
+				case INPUT_MOTION_PRESSED: { motionButtonDown_[button] = true; } break;
+				case INPUT_MOTION_RELEASED: { motionButtonDown_[button] = false; } break;
+				
+				case INPUT_TURN_LEFT:
+				{
+					gameState_->TurnPlayerLeft();
+					this->SetActionMessage("Turned Left...");
+				} break;
+				
+				case INPUT_TURN_RIGHT:
+				{
+					gameState_->TurnPlayerRight();
+					this->SetActionMessage("Turned Right...");
+				} break;
+				
+				default: break;
+			}
+		}
+
 ////////////////////////////////////////////////////////////////////////////////
 // *************************** NEW PLAYER MOTION **************************** //
 ////////////////////////////////////////////////////////////////////////////////
-			
-			// are we moving forward?
-			if (motionButtonDown[MOTIONBUTTON_UP])
+		
+		// are we moving forward?
+		if (motionButtonDown_[MOTIONBUTTON_UP])
+		{
+			if ((playerMotionCooldown_ -= simulationStep_) <= 0)
 			{
-				if (--playerMotionCounter <= 0)
+				playerMotionCooldown_ = PLAYER_MOTION_REPEAT_DELAY;
+				
+				if (gameState_->MovePlayerForward())
 				{
-					playerMotionCounter = playerMotionDelay;
-					
-					if (gameState_->MovePlayerForward())
-					{
-						sprintf(hudActionMessage, "%s", "Moved Forward...");
-						requestUpdateDisplay = true;
-					}
-					else
-					{
-						sprintf(hudActionMessage, "%s", "That way is blocked!");
-						requestUpdateDisplay = true;
-					}
+					this->SetActionMessage("Moved Forward...");
+				}
+				else
+				{
+					this->SetActionMessage("That way is blocked!");
 				}
 			}
-			
-			// are we moving back?
-			if (motionButtonDown[MOTIONBUTTON_DOWN])
+		}
+		
+		// are we moving back?
+		if (motionButtonDown_[MOTIONBUTTON_DOWN])
+		{
+			if ((playerMotionCooldown_ -= simulationStep_) <= 0)
 			{
-				if (--playerMotionCounter <= 0)
+				playerMotionCooldown_ = PLAYER_MOTION_REPEAT_DELAY;
+				
+				if (gameState_->MovePlayerBack())
 				{
-					playerMotionCounter = playerMotionDelay;
-					
-					if (gameState_->MovePlayerBack())
-					{
-						sprintf(hudActionMessage, "%s", "Moved Back...");
-						requestUpdateDisplay = true;
-					}
-					else
-					{
-						sprintf(hudActionMessage, "%s", "That way is blocked!");
-						requestUpdateDisplay = true;
-					}
+					this->SetActionMessage("Moved Back...");
+				}
+				else
+				{
+					this->SetActionMessage("That way is blocked!");
 				}
 			}
-			
-			// are we strafing left?
-			if (motionButtonDown[MOTIONBUTTON_STRAFELEFT])
+		}
+		
+		// are we strafing left?
+		if (motionButtonDown_[MOTIONBUTTON_STRAFELEFT])
+		{
+			if ((playerMotionCooldown_ -= simulationStep_) <= 0)
 			{
-				if (--playerMotionCounter <= 0)
+				playerMotionCooldown_ = PLAYER_MOTION_REPEAT_DELAY;
+				
+				if (gameState_->MovePlayerLeft())
 				{
-					playerMotionCounter = playerMotionDelay;
-					
-					if (gameState_->MovePlayerLeft())
-					{
-						sprintf(hudActionMessage, "%s", "Stepped Left...");
-						requestUpdateDisplay = true;
-					}
-					else
-					{
-						sprintf(hudActionMessage, "%s", "That way is blocked!");
-						requestUpdateDisplay = true;
-					}
+					this->SetActionMessage("Stepped Left...");
+				}
+				else
+				{
+					this->SetActionMessage("That way is blocked!");
 				}
 			}
-			
-			// are we strafing right?
-			if (motionButtonDown[MOTIONBUTTON_STRAFERIGHT])
+		}
+		
+		// are we strafing right?
+		if (motionButtonDown_[MOTIONBUTTON_STRAFERIGHT])
+		{
+			if ((playerMotionCooldown_ -= simulationStep_) <= 0)
 			{
-				if (--playerMotionCounter <= 0)
+				playerMotionCooldown_ = PLAYER_MOTION_REPEAT_DELAY;
+				
+				if (gameState_->MovePlayerRight())
 				{
-					playerMotionCounter = playerMotionDelay;
-					
-					if (gameState_->MovePlayerRight())
-					{
-						sprintf(hudActionMessage, "%s", "Stepped Right...");
-						requestUpdateDisplay = true;
-					}
-					else
-					{
-						sprintf(hudActionMessage, "%s", "That way is blocked!");
-						requestUpdateDisplay = true;
-					}
+					this->SetActionMessage("Stepped Right...");
+				}
+				else
+				{
+					this->SetActionMessage("That way is blocked!");
 				}
 			}
+		}
+		
+		// fire any delayed actions that came due during this step
+		timers_->Advance(simulationStep_);
+		
+		// hand anything that changed over to be drawn
+		if (simulationChanged_)
+		{
+			this->PublishSnapshot();
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
 
-			// is is time to request the action message be cleared?
-			if (--actionMessageClearCounter <= 0)
-			{
-				actionMessageClearCounter = actionMessageClearDelay;
-				requestClearActionMessage = true;
-			}
+	bool Engine::StartSimulationThread()
+	{
+		simulationRunning_ = true;
+		simulationThread_ = SDL_CreateThread(Engine::SimulationThread, this);
+		
+		if (!simulationThread_)
+		{
+			simulationRunning_ = false;
+			
+			// log the error
+			WriteLog(stderr, "Unable to start the simulation thread, it will run on the main thread!\n\tSDL Error: %s\n", SDL_GetError());
 			
-			// should we clear the action message ?
-			if (requestClearActionMessage)
+			// return failure
+			return false;
+		}
+		
+		// return success
+		return true;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	void Engine::StopSimulationThread()
+	{
+		if (!simulationThread_)
+		{
+			return;
+		}
+		
+		simulationRunning_ = false;
+		SDL_WaitThread(simulationThread_, 0);
+		simulationThread_ = 0;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	int Engine::SimulationThread(void* userData)
+	{
+		Engine* engine = static_cast<Engine*>(userData);
+		
+		Microseconds nextStepTime = Clock::GetMicroseconds();
+		
+		while (engine->simulationRunning_)
+		{
+			engine->UpdateSimulation();
+			
+			// after a stall don't try to catch up on all of it at once
+			nextStepTime += engine->simulationStep_;
+			if (nextStepTime < Clock::GetMicroseconds() - ENGINE_MAX_SIMULATION_LAG)
 			{
-				sprintf(hudActionMessage, "%s", "Waiting...");
-				requestClearActionMessage = false;
-				requestUpdateDisplay = true;
+				nextStepTime = Clock::GetMicroseconds();
 			}
 			
-			// should we update the display?
-			if (requestUpdateDisplay)
-			{
-				actionMessageX = ((screen_->w / 2) - ((strlen(hudActionMessage) * 9) / 2));
+			Clock::SleepUntil(nextStepTime);
+		}
+		
+		return 0;
+	}
 	
-				playerPosition.Copy(gameState_->GetPlayerPosition());
+	////////////////////////////////////////////////////////////////////////////
+
+	void Engine::QueueInput(InputCommand command, int button)
+	{
+		unsigned int head = inputQueueHead_;
+		
+		// the queue only fills up if the simulation has stalled
+		if (head - inputQueueTail_ >= ENGINE_INPUT_QUEUE_SIZE)
+		{
+			WriteLog(stderr, "The input queue is full, a key press was lost!\n");
+			return;
+		}
+		
+		inputQueue_[head % ENGINE_INPUT_QUEUE_SIZE].command_ = command;
+		inputQueue_[head % ENGINE_INPUT_QUEUE_SIZE].button_ = button;
+		
+		// the key press has to be in the queue before the simulation can see it there
+		__sync_synchronize();
+		inputQueueHead_ = head + 1;
+	}
 	
-				playerX = playerPosition.x_;
-				playerZ = playerPosition.y_;
-				compass = playerPosition.facing_;
+	////////////////////////////////////////////////////////////////////////////
+
+	bool Engine::TakeInput(InputCommand* command, int* button)
+	{
+		unsigned int tail = inputQueueTail_;
+		
+		if (tail == inputQueueHead_)
+		{
+			return false;
+		}
+		
+		__sync_synchronize();
+		*command = inputQueue_[tail % ENGINE_INPUT_QUEUE_SIZE].command_;
+		*button = inputQueue_[tail % ENGINE_INPUT_QUEUE_SIZE].button_;
+		
+		// the key press has to be read before its place can be used again
+		__sync_synchronize();
+		inputQueueTail_ = tail + 1;
+		
+		return true;
+	}
 	
-				sprintf(compassMessage, "You are facing %s.",
-					(0x0 == playerPosition.facing_) ? "North" :
-					(0x1 == playerPosition.facing_) ? "East" :
-					(0x2 == playerPosition.facing_) ? "South" :
-					(0x3 == playerPosition.facing_) ? "West" : "<Invalid Direction>");
-					
-				
-				mapView_->RenderMap(screen_, gameState_->GetCurrentMap(), gameState_->GetPlayerPosition());
-				
-				defaultFont_->Print(screen_, actionMessageX, 8, "%s", hudActionMessage);
-				defaultFont_->Print(screen_, 8, screen_->h - 34, "Player X: %2d", playerX);
-				defaultFont_->Print(screen_, 8, screen_->h - 25, "Player Z: %2d", playerZ);
-				defaultFont_->Print(screen_, 8, screen_->h - 16, "%s", compassMessage);
-			
-				// blit the game screen onto the main screen
-				Engine::BlitSprite(screen_, mainScreen_, gameScreenX, gameScreenY);
-			
-				// blit the overlays
-				Engine::BlitSprite(mainScreenOverlay, mainScreen_, 0, 0);
-				
-				Engine::BlitSprite(smallCompassOverlay[compass], mainScreen_, 42, 42);
-				
-				// blit the minimap
-				miniMap.Update();
-				miniMap.Render(mainScreen_, 390, 290);
-				
-				requestUpdateDisplay = false;
+	////////////////////////////////////////////////////////////////////////////
+
+	void Engine::PublishSnapshot()
+	{
+		SimulationSnapshot& snapshot = snapshots_.GetWriteBuffer();
+		
+		snapshot.map_ = gameState_->GetCurrentMap();
+		snapshot.player_.Copy(gameState_->GetPlayerPosition());
+		snprintf(snapshot.actionMessage_, sizeof(snapshot.actionMessage_), "%s", hudActionMessage_);
+		snapshot.actionMessageSerial_ = actionMessageSerial_;
+		
+		snapshots_.Publish();
+		simulationChanged_ = false;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	bool Engine::ConsumeSnapshot()
+	{
+		if (!snapshots_.TakeLatest())
+		{
+			return false;
+		}
+		
+		// a new message is laid out once, rather than each frame it is drawn
+		const SimulationSnapshot& snapshot = snapshots_.GetReadBuffer();
+		if (snapshot.actionMessageSerial_ != laidOutMessageSerial_)
+		{
+			// centered across the game screen, and wrapped onto more lines if it is too long for it
+			actionMessageLayout_.Layout(defaultFont_, snapshot.actionMessage_, screen_->w, TEXT_ALIGN_CENTER);
+			laidOutMessageSerial_ = snapshot.actionMessageSerial_;
+		}
+		
+		return true;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	void Engine::ReloadChangedArt()
+	{
+		std::string filePath;
+		SDL_Surface* decoded = 0;
+		std::vector<SDL_Surface*> reloadedImages;
+		
+		while (assetWatcher_->TakeReloadedImage(&filePath, &decoded))
+		{
+			// the decoding was done on the watcher thread, only the conversion has to happen here
+			SDL_Surface* converted = Engine::ConvertImageResource(decoded);
+			if (!converted)
+			{
+				continue;
 			}
 			
+			// the archive's copy is out of date now, so every later load of it reads the file
+			AssetArchive::Override(filePath.c_str());
 			
+			// anything still holding the old image keeps it until it lets go
+			ResourceCache::Detach(filePath.c_str());
+			reloadedImages.push_back(ResourceCache::Insert(filePath.c_str(), converted));
 			
-			// flip the screen
-			this->FlipScreen();
+			unsigned int queued = artManager_->ReloadImage(filePath.c_str());
 			
-			// reduce the cpu hoggingness of SDL ^-^
-			SDL_Delay(20);
-		} // end while
+			WriteLog(stderr, "Reloaded \"%s\", rebuilding %u wall sets.\n", filePath.c_str(), queued);
+		}
+		
+		// the old sets are drawn until the rebuilt ones are ready
+		if (artManager_->InstallReloadedSets())
+		{
+			requestUpdateDisplay_ = true;
+		}
+		
+		// the sets being rebuilt have taken their own references to the new images by now
+		for (unsigned int index = 0; index < reloadedImages.size(); index++)
+		{
+			Engine::UnloadImageResource(reloadedImages[index]);
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	void Engine::RenderFrame()
+	{
+		SDL_Surface* frame = presenter_->GetBackBuffer();
+		
+		int gameScreenX = 40;
+		int gameScreenY = frame->h / 2 - screen_->h / 2;
+		
+		// without a simulation thread the state is handed over here, so whatever was just done to it is drawn
+		if (!simulationThread_)
+		{
+			this->PublishSnapshot();
+			this->ConsumeSnapshot();
+		}
+		
+		// the state is drawn as the simulation last published it, and nothing is read from the game state itself
+		const SimulationSnapshot& snapshot = snapshots_.GetReadBuffer();
+		Map* currentMap = snapshot.map_;
+		Position playerPosition(snapshot.player_);
+		
+		int playerX = playerPosition.x_;
+		int playerZ = playerPosition.y_;
+		int compass = playerPosition.facing_;
+		
+
+		mapView_->RenderMap(screen_, currentMap, &playerPosition);
+		
+		// the pyramid follows the cells as they are visited, so the overview is always only a blit
+		mapPyramid_->SetMap(currentMap);
+		mapPyramid_->Update();
+		
+		if (showWorldOverview_)
+		{
+			worldOverviewLevel_ = std::min(worldOverviewLevel_, mapPyramid_->GetLevelCount() - 1);
+			
+			Engine::FillRect(screen_, 0, SDL_MapRGB(screen_->format, 0, 0, 0));
+			mapPyramid_->Draw(screen_, 8, 8, screen_->w - 16, screen_->h - 16, worldOverviewLevel_, playerX, playerZ);
+		}
+		
+		// the HUD lines rarely change between updates, so they are drawn from the text cache
+		TextFormatter hudLine;
+		
+		actionMessageLayout_.Draw(screen_, 0, 8, textCache_);
+		
+		hudLine.Clear() << "Player X: " << Padded(playerX, 2);
+		textCache_->Print(defaultFont_, screen_, 8, screen_->h - 34, hudLine.GetText(), hudLine.GetLength());
+		
+		hudLine.Clear() << "Player Z: " << Padded(playerZ, 2);
+		textCache_->Print(defaultFont_, screen_, 8, screen_->h - 25, hudLine.GetText(), hudLine.GetLength());
+		
+		hudLine.Clear() << "You are facing " << Direction(playerPosition.facing_) << '.';
+		textCache_->Print(defaultFont_, screen_, 8, screen_->h - 16, hudLine.GetText(), hudLine.GetLength());
+	
+		// update the minimap, following the game onto a new map if one was started
+		miniMap_->SetMap(currentMap);
+		miniMap_->Update(&playerPosition);
+		
+		PROFILE_SCOPE(PROFILE_ZONE_OVERLAYS);
+		
+		// blit the game screen onto the frame
+		Engine::BlitSprite(screen_, frame, gameScreenX, gameScreenY);
+	
+		// blit the overlays
+		Engine::BlitSprite(mainScreenOverlay_, frame, 0, 0);
+		
+		Engine::BlitSprite(smallCompassOverlay_[compass], frame, 42, 42);
+		
+		// blit the minimap
+		miniMap_->Render(frame, 390, 290);
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	void Engine::SetActionMessage(const char* message, bool expires)
+	{
+		snprintf(hudActionMessage_, sizeof(hudActionMessage_), "%s", message);
+		actionMessageSerial_++;
+		simulationChanged_ = true;
 		
-		Engine::UnloadImageResource(smallCompassOverlay[0]);
-		Engine::UnloadImageResource(smallCompassOverlay[1]);
-		Engine::UnloadImageResource(smallCompassOverlay[2]);
-		Engine::UnloadImageResource(smallCompassOverlay[3]);
-		delete [] smallCompassOverlay;
+		// a new message restarts the countdown to clearing it
+		if (actionMessageTimer_)
+		{
+			timers_->Cancel(actionMessageTimer_);
+			actionMessageTimer_ = 0;
+		}
 		
-		Engine::UnloadImageResource(mainScreenOverlay);
+		if (expires)
+		{
+			actionMessageTimer_ = timers_->Schedule(ACTION_MESSAGE_DURATION, Engine::OnActionMessageExpired, this);
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	void Engine::OnActionMessageExpired(void* userData)
+	{
+		Engine* engine = static_cast<Engine*>(userData);
 		
+		engine->actionMessageTimer_ = 0;
+		engine->SetActionMessage("Waiting...", false);
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	void Engine::SetTargetFrameRate(int framesPerSecond)
+	{
+		if (framesPerSecond > ENGINE_MAX_FRAME_RATE)
+		{
+			framesPerSecond = ENGINE_MAX_FRAME_RATE;
+		}
 		
+		framePeriod_ = (framesPerSecond > 0) ? (1000000 / framesPerSecond) : 0;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	void Engine::SetSimulationRate(int ticksPerSecond)
+	{
+		if (ticksPerSecond <= 0)
+		{
+			ticksPerSecond = ENGINE_DEFAULT_SIMULATION_RATE;
+		}
+		else if (ticksPerSecond > ENGINE_MAX_SIMULATION_RATE)
+		{
+			ticksPerSecond = ENGINE_MAX_SIMULATION_RATE;
+		}
+		
+		simulationStep_ = 1000000 / ticksPerSecond;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	TimerQueue* Engine::GetTimerQueue() const
+	{
+		return timers_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	ThreadPool* Engine::GetThreadPool() const
+	{
+		return threadPool_;
 	}
 
 	////////////////////////////////////////////////////////////////////////////
 
 	void Engine::Destroy()
 	{
+		this->StopSimulationThread();
+		
+		if (textCache_)
+		{
+			textCache_->WriteReport(stderr);
+		}
+		
+		if (presenter_)
+		{
+			presenter_->WriteReport(stderr);
+		}
+		
 		#define _TMP_DELOBJ(object) if (object) { delete object; object = 0; }
 
+		_TMP_DELOBJ(presenter_)
+		_TMP_DELOBJ(assetWatcher_)
 		_TMP_DELOBJ(event_)
 		_TMP_DELOBJ(artManager_)
 		_TMP_DELOBJ(mapView_)
 		_TMP_DELOBJ(gameState_)
+		_TMP_DELOBJ(textCache_)
 		_TMP_DELOBJ(defaultFont_)
+		_TMP_DELOBJ(timers_)
+		_TMP_DELOBJ(miniMap_)
+		_TMP_DELOBJ(mapPyramid_)
+		_TMP_DELOBJ(threadPool_)
 
 		#undef _TMP_DELOBJ
 		
+		// unload the overlays
+		for (int index = 0; index < 4; index++)
+		{
+			smallCompassOverlay_[index].Reset();
+		}
+		
+		mainScreenOverlay_.Reset();
+		
 		// unload the game screen
 		Engine::UnloadImageResource(screen_);
+		
+		// SDL frees the video surface itself
+		SurfaceMemory::Untrack(mainScreen_);
+		
+		// everything should have let go of its images by now
+		SurfaceMemory::WriteReport(stderr);
+		ResourceCache::WriteReport(stderr, true);
+		ResourceCache::ReleaseAll();
+		
+		AssetArchive::Unmount();
+		
+		// finish writing the trace, if we were recording one
+		TraceRecorder::Stop();
 	}
 
 	////////////////////////////////////////////////////////////////////////////
@@ -679,14 +1496,48 @@ namespace LOFI
 
 	void Engine::FlipScreen()
 	{
-		SDL_Flip(mainScreen_);
+		// the presenter flips it, or only copies it to the screen when running headless
+		presenter_->Submit();
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* Engine::GetMainScreen() const
+	{
+		return mainScreen_;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	bool Engine::IsHeadless() const
+	{
+		return headless_;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	bool Engine::SaveScreenshot(const char* filePath)
+	{
+		presenter_->Flush();
+		
+		if (SDL_SaveBMP(mainScreen_, filePath) < 0)
+		{
+			// log the error
+			WriteLog(stderr, "Unable to save screenshot to \"%s\"!\n\tSDL Error: %s\n", filePath, SDL_GetError());
+
+			// return failure
+			return false;
+		}
+
+		// return success
+		return true;
 	}
 	
 	////////////////////////////////////////////////////////////////////////////
 
 	void Engine::ClearScreen(unsigned int color)
 	{
-		SDL_FillRect(mainScreen_, 0, color);
+		Engine::FillRect(presenter_->GetBackBuffer(), 0, color);
 	}
 	
 } // end namespace
@@ -38,6 +38,18 @@ namespace LOFI
 		currentMap_ = new Map();
 		currentMap_->MakeMockup();
 		playerPosition_->Copy(currentMap_->GetStartingPoint(0));
+		currentMap_->MarkVisited(playerPosition_->x_, playerPosition_->y_);
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	void GameState::StartNewGame(int mapWidth, int mapHeight, unsigned int seed)
+	{
+		if (currentMap_) { delete currentMap_; }
+		currentMap_ = new Map();
+		currentMap_->MakeMaze(mapWidth, mapHeight, seed);
+		playerPosition_->Copy(currentMap_->GetStartingPoint(0));
+		currentMap_->MarkVisited(playerPosition_->x_, playerPosition_->y_);
 	}
 	
 	////////////////////////////////////////////////////////////////////////////
@@ -47,6 +59,7 @@ namespace LOFI
 		if (currentMap_->CanPassWallForCoordinate(playerPosition_))
 		{
 			playerPosition_->Copy(playerPosition_->GetPositionAheadOfThis(1));
+			currentMap_->MarkVisited(playerPosition_->x_, playerPosition_->y_);
 			return true;
 		}
 		
@@ -62,6 +75,7 @@ namespace LOFI
 		if (currentMap_->CanPassWallForCoordinate(&tempPosition))
 		{
 			playerPosition_->Copy(playerPosition_->GetPositionBehindThis(1));
+			currentMap_->MarkVisited(playerPosition_->x_, playerPosition_->y_);
 			return true;
 		}
 		return false;
@@ -76,6 +90,7 @@ namespace LOFI
 		if (currentMap_->CanPassWallForCoordinate(&tempPosition))
 		{
 			playerPosition_->Copy(playerPosition_->GetPositionLeftOfThis(1));
+			currentMap_->MarkVisited(playerPosition_->x_, playerPosition_->y_);
 			return true;
 		}
 		return false;
@@ -90,6 +105,7 @@ namespace LOFI
 		if (currentMap_->CanPassWallForCoordinate(&tempPosition))
 		{
 			playerPosition_->Copy(playerPosition_->GetPositionRightOfThis(1));
+			currentMap_->MarkVisited(playerPosition_->x_, playerPosition_->y_);
 			return true;
 		}
 		return false;
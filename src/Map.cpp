@@ -18,11 +18,20 @@
 
 namespace LOFI
 {
+	/// the number given to the last clear of any map
+	static unsigned int lastMapGeneration = 0;
+	
+	////////////////////////////////////////////////////////////////////////////
+
 	Map::Map() :
 		width_(0),
 		height_(0),
 		walls_(0),
 		passibility_(0),
+		visited_(0),
+		visitedOrder_(0),
+		visitedCount_(0),
+		generation_(0),
 		startingPoints_(0)
 	{
 	}
@@ -34,6 +43,8 @@ namespace LOFI
 		delete [] walls_;
 		delete [] startingPoints_;
 		delete [] passibility_;
+		delete [] visited_;
+		delete [] visitedOrder_;
 	}
 	
 	////////////////////////////////////////////////////////////////////////////
@@ -45,6 +56,110 @@ namespace LOFI
 	
 	////////////////////////////////////////////////////////////////////////////
 
+	void Map::MakeMaze(int width, int height, unsigned int seed)
+	{
+		width_ 	= (width < 2) ? 2 : width;
+		height_ = (height < 2) ? 2 : height;
+		this->ClearMap();
+		
+		startingPoints_ = new Position* [1];
+		startingPoints_[0] = new Position(0, 0, PLAYER_FACING_EAST);
+		
+		// a tiny LCG of our own so the same seed builds the same maze on every platform
+		#define _TMP_RANDOM(range) ((seed = seed * 1103515245 + 12345), static_cast<int>((seed >> 16) % (range)))
+		
+		// STEP #1 - wall off every edge of every cell, the shared edges get the same wall on both sides
+		for (int row = 0; row < height_; row++)
+		{
+			for (int column = 0; column < width_; column++)
+			{
+				int northWall = WALL_TYPE_BRICK + _TMP_RANDOM(4);
+				walls_[row][column][PLAYER_FACING_NORTH] = northWall;
+				passibility_[row][column][PLAYER_FACING_NORTH] = false;
+				if (row > 0)
+				{
+					walls_[row - 1][column][PLAYER_FACING_SOUTH] = northWall;
+					passibility_[row - 1][column][PLAYER_FACING_SOUTH] = false;
+				}
+				
+				int westWall = WALL_TYPE_BRICK + _TMP_RANDOM(4);
+				walls_[row][column][PLAYER_FACING_WEST] = westWall;
+				passibility_[row][column][PLAYER_FACING_WEST] = false;
+				if (column > 0)
+				{
+					walls_[row][column - 1][PLAYER_FACING_EAST] = westWall;
+					passibility_[row][column - 1][PLAYER_FACING_EAST] = false;
+				}
+			}
+		}
+		
+		for (int row = 0; row < height_; row++)
+		{
+			walls_[row][width_ - 1][PLAYER_FACING_EAST] = WALL_TYPE_STONE;
+			passibility_[row][width_ - 1][PLAYER_FACING_EAST] = false;
+		}
+		
+		for (int column = 0; column < width_; column++)
+		{
+			walls_[height_ - 1][column][PLAYER_FACING_SOUTH] = WALL_TYPE_STONE;
+			passibility_[height_ - 1][column][PLAYER_FACING_SOUTH] = false;
+		}
+		
+		// STEP #2 - carve the passages with a depth-first walk from the starting cell
+		std::vector<bool> carved(width_ * height_, false);
+		std::vector<int> trail;
+		
+		carved[0] = true;
+		trail.push_back(0);
+		
+		while (!trail.empty())
+		{
+			int cell = trail.back();
+			int column = cell % width_;
+			int row = cell / width_;
+			
+			// find the neighbours we have not carved into yet
+			int choices[4];
+			int choiceCount = 0;
+			
+			if (row > 0 			&& !carved[cell - width_]) 	{ choices[choiceCount++] = PLAYER_FACING_NORTH; }
+			if (column < width_ - 1 && !carved[cell + 1]) 		{ choices[choiceCount++] = PLAYER_FACING_EAST; }
+			if (row < height_ - 1 	&& !carved[cell + width_]) 	{ choices[choiceCount++] = PLAYER_FACING_SOUTH; }
+			if (column > 0 			&& !carved[cell - 1]) 		{ choices[choiceCount++] = PLAYER_FACING_WEST; }
+			
+			if (0 == choiceCount)
+			{
+				// dead end, back up
+				trail.pop_back();
+				continue;
+			}
+			
+			Position wall(column, row, choices[_TMP_RANDOM(choiceCount)]);
+			this->RemoveWall(&wall);
+			
+			Position next(0, 0, 0);
+			next.Copy(wall.GetPositionAheadOfThis(1));
+			
+			int nextCell = next.x_ + next.y_ * width_;
+			carved[nextCell] = true;
+			trail.push_back(nextCell);
+		}
+		
+		// STEP #3 - knock out some extra interior walls so there is more than one way around
+		int extraOpenings = (width_ * height_) / 10;
+		for (int index = 0; index < extraOpenings; index++)
+		{
+			int column = 1 + _TMP_RANDOM(width_ - 1);
+			int row = _TMP_RANDOM(height_);
+			Position wall(column, row, PLAYER_FACING_WEST);
+			this->RemoveWall(&wall);
+		}
+		
+		#undef _TMP_RANDOM
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
 	int Map::GetWallForCoordinate(Position* position)
 	{
 		return (
@@ -167,7 +282,19 @@ namespace LOFI
 			}
 		}
 		
-		// STEP #5 - free the startingPoints array
+		// STEP #5 - nothing has been visited on a cleared map
+		delete [] visited_;
+		visited_ = new bool [width_ * height_];
+		for (int cell = 0; cell < width_ * height_; cell++)
+		{
+			visited_[cell] = false;
+		}
+		delete [] visitedOrder_;
+		visitedOrder_ = new int [width_ * height_];
+		visitedCount_ = 0;
+		generation_ = ++lastMapGeneration;
+		
+		// STEP #6 - free the startingPoints array
 		if (startingPoints_)
 		{
 			if (startingPoints_[0])
@@ -179,7 +306,7 @@ namespace LOFI
 			startingPoints_ = 0;
 		}
 		
-		// STEP #6 - initialize walls_ and passibility_ arrays
+		// STEP #7 - initialize walls_ and passibility_ arrays
 		
 		for (row = 0; row < height_; row++)
 		{
@@ -352,8 +479,94 @@ namespace LOFI
 
 	bool Map::IsVisited(int column, int row) const
 	{
+		if (!visited_ || column < 0 || row < 0 || column >= width_ || row >= height_)
+		{
+			return false;
+		}
+		
+		return visited_[(row * width_) + column];
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	int Map::GetWallMask(int column, int row) const
+	{
+		if (column < 0 || row < 0 || column >= width_ || row >= height_)
+		{
+			return 0xF;
+		}
+		
+		int wallMask = 0;
+		for (int facing = 0; facing < 4; facing++)
+		{
+			if (!passibility_[row][column][facing])
+			{
+				wallMask |= (1 << facing);
+			}
+		}
 		
-		return false;
+		return wallMask;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	int Map::GetWall(int column, int row, int facing) const
+	{
+		if (column < 0 || row < 0 || column >= width_ || row >= height_ || facing < 0 || facing > 3)
+		{
+			return 0;
+		}
+		
+		return walls_[row][column][facing];
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	bool Map::MarkVisited(int column, int row)
+	{
+		if (!visited_ || column < 0 || row < 0 || column >= width_ || row >= height_)
+		{
+			return false;
+		}
+		
+		int cell = (row * width_) + column;
+		if (visited_[cell])
+		{
+			return false;
+		}
+		
+		visited_[cell] = true;
+		visitedOrder_[visitedCount_] = cell;
+		
+		// the cell has to be in the order before it is counted, for whoever reads it on another thread
+		__sync_synchronize();
+		visitedCount_ = visitedCount_ + 1;
+		return true;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned int Map::GetGeneration() const
+	{
+		return generation_;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned int Map::GetVisitedCount() const
+	{
+		unsigned int visitedCount = visitedCount_;
+		
+		// the cells it counts are read after the count
+		__sync_synchronize();
+		return visitedCount;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	int Map::GetVisitedCell(unsigned int index) const
+	{
+		return visitedOrder_[index];
 	}
 	
 	////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,278 @@
+
+// CODESTYLE: v2.0
+
+// MapPyramid.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: keeps the explored map as images at every zoom level, from a pixel per cell to the whole map in one
+
+/**
+ * @file MapPyramid.cpp
+ * @brief Map Pyramid - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	MapPyramid::MapPyramid() :
+		currentMap_(0),
+		builtGeneration_(0),
+		builtVisitedCount_(0)
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	MapPyramid::~MapPyramid()
+	{
+		this->DestroyLevels();
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void MapPyramid::SetMap(Map* sourceMap)
+	{
+		if (sourceMap != currentMap_)
+		{
+			this->DestroyLevels();
+		}
+
+		currentMap_ = sourceMap;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void MapPyramid::Update()
+	{
+		PROFILE_SCOPE(PROFILE_ZONE_MINIMAP);
+
+		if (!currentMap_)
+		{
+			return;
+		}
+
+		// a cleared map has changed everywhere
+		if (levels_.empty() || currentMap_->GetGeneration() != builtGeneration_)
+		{
+			this->Rebuild();
+			return;
+		}
+
+		// the cells visited since the last update
+		int mapWidth = currentMap_->GetWidth();
+		unsigned int visitedCount = currentMap_->GetVisitedCount();
+
+		for (; builtVisitedCount_ < visitedCount; builtVisitedCount_++)
+		{
+			int cell = currentMap_->GetVisitedCell(builtVisitedCount_);
+			this->AddVisitedCell(cell % mapWidth, cell / mapWidth);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	int MapPyramid::GetLevelCount() const
+	{
+		return static_cast<int>(levels_.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* MapPyramid::GetLevel(int level) const
+	{
+		if (level < 0 || level >= static_cast<int>(levels_.size()))
+		{
+			return 0;
+		}
+
+		return levels_[level].image_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	int MapPyramid::GetLevelToFit(int width, int height) const
+	{
+		for (unsigned int level = 0; level < levels_.size(); level++)
+		{
+			if (levels_[level].width_ <= width && levels_[level].height_ <= height)
+			{
+				return static_cast<int>(level);
+			}
+		}
+
+		// nothing fits, so the whole map in a pixel is the nearest
+		return (levels_.empty()) ? 0 : static_cast<int>(levels_.size()) - 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void MapPyramid::Draw(SDL_Surface* target, int x, int y, int width, int height, int level, int column, int row) const
+	{
+		if (!target || level < 0 || level >= static_cast<int>(levels_.size()) || width <= 0 || height <= 0)
+		{
+			return;
+		}
+
+		const PyramidLevel& pyramidLevel = levels_[level];
+
+		// the pixel of the marked cell on this level
+		int markX = column >> level;
+		int markY = row >> level;
+
+		// the top left of the box in pixels of the level; centered if it is smaller, following the mark if not
+		int left = (pyramidLevel.width_ <= width) ?
+			(pyramidLevel.width_ - width) / 2 :
+			std::max(0, std::min(pyramidLevel.width_ - width, markX - (width / 2)));
+
+		int top = (pyramidLevel.height_ <= height) ?
+			(pyramidLevel.height_ - height) / 2 :
+			std::max(0, std::min(pyramidLevel.height_ - height, markY - (height / 2)));
+
+		// only the part of the image within the box is blitted
+		int sourceX = std::max(0, left);
+		int sourceY = std::max(0, top);
+		int sourceRight = std::min(pyramidLevel.width_, left + width);
+		int sourceBottom = std::min(pyramidLevel.height_, top + height);
+
+		Engine::Blit(pyramidLevel.image_, target,
+			sourceX, sourceY,
+			x + (sourceX - left), y + (sourceY - top),
+			sourceRight - sourceX, sourceBottom - sourceY);
+
+		// mark the cell, big enough to see at any level
+		SDL_Rect mark;
+		mark.x = x + (markX - left) - 1;
+		mark.y = y + (markY - top) - 1;
+		mark.w = 3;
+		mark.h = 3;
+		Engine::FillRect(target, &mark, SDL_MapRGB(target->format, 255, 255, 0));
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void MapPyramid::Rebuild()
+	{
+		this->DestroyLevels();
+
+		int mapWidth = currentMap_->GetWidth();
+		int mapHeight = currentMap_->GetHeight();
+
+		if (mapWidth <= 0 || mapHeight <= 0)
+		{
+			return;
+		}
+
+		SDL_PixelFormat* screenFormat = globalEngineInstance->GetScreen()->format;
+
+		// halve the size until the whole map is a single pixel
+		int width = mapWidth;
+		int height = mapHeight;
+
+		for (;;)
+		{
+			PyramidLevel pyramidLevel;
+			pyramidLevel.width_ 	= width;
+			pyramidLevel.height_ 	= height;
+			pyramidLevel.image_ 	= SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, screenFormat->BitsPerPixel, 0, 0, 0, 0);
+
+			if (!pyramidLevel.image_)
+			{
+				// log the error
+				WriteLog(stderr, "Unable to create map pyramid level %dx%d!\n\tSDL Error: %s\n", width, height, SDL_GetError());
+
+				// return failure
+				this->DestroyLevels();
+				return;
+			}
+
+			SurfaceMemory::Track(pyramidLevel.image_, SURFACE_CATEGORY_MINIMAP);
+
+			// nothing has been visited yet
+			Engine::FillRect(pyramidLevel.image_, 0, SDL_MapRGB(pyramidLevel.image_->format, 32, 32, 32));
+			pyramidLevel.visitedCounts_.assign(width * height, 0);
+
+			levels_.push_back(pyramidLevel);
+
+			if (1 == width && 1 == height)
+			{
+				break;
+			}
+
+			width = (width + 1) / 2;
+			height = (height + 1) / 2;
+		}
+
+		// count everything visited so far
+		builtGeneration_ = currentMap_->GetGeneration();
+		builtVisitedCount_ = currentMap_->GetVisitedCount();
+
+		for (unsigned int index = 0; index < builtVisitedCount_; index++)
+		{
+			int cell = currentMap_->GetVisitedCell(index);
+			this->AddVisitedCell(cell % mapWidth, cell / mapWidth);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void MapPyramid::AddVisitedCell(int column, int row)
+	{
+		for (unsigned int level = 0; level < levels_.size(); level++)
+		{
+			int blockColumn = column >> level;
+			int blockRow = row >> level;
+
+			levels_[level].visitedCounts_[(blockRow * levels_[level].width_) + blockColumn]++;
+
+			this->PaintBlock(static_cast<int>(level), blockColumn, blockRow);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void MapPyramid::PaintBlock(int level, int blockColumn, int blockRow)
+	{
+		PyramidLevel& pyramidLevel = levels_[level];
+
+		// the blocks along the right and bottom edges can be cut short by the edge of the map
+		int blockSize = 1 << level;
+		int cellsAcross = std::min(blockSize, currentMap_->GetWidth() - (blockColumn * blockSize));
+		int cellsDown = std::min(blockSize, currentMap_->GetHeight() - (blockRow * blockSize));
+		int cells = cellsAcross * cellsDown;
+
+		int visited = static_cast<int>(pyramidLevel.visitedCounts_[(blockRow * pyramidLevel.width_) + blockColumn]);
+
+		// from the mini-map's color for not visited to its color for visited
+		Uint8 red 	= static_cast<Uint8>(32 - ((32 * visited) / cells));
+		Uint8 green = static_cast<Uint8>(32 + ((96 * visited) / cells));
+		Uint8 blue 	= static_cast<Uint8>(32 - ((32 * visited) / cells));
+
+		SDL_Rect pixel;
+		pixel.x = blockColumn;
+		pixel.y = blockRow;
+		pixel.w = 1;
+		pixel.h = 1;
+		Engine::FillRect(pyramidLevel.image_, &pixel, SDL_MapRGB(pyramidLevel.image_->format, red, green, blue));
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void MapPyramid::DestroyLevels()
+	{
+		for (unsigned int level = 0; level < levels_.size(); level++)
+		{
+			SurfaceMemory::Untrack(levels_[level].image_);
+			SDL_FreeSurface(levels_[level].image_);
+		}
+
+		levels_.clear();
+		builtGeneration_ = 0;
+		builtVisitedCount_ = 0;
+	}
+
+} // end namespace
+
@@ -20,8 +20,8 @@ namespace LOFI
 {
 	MapView::MapView(ArtManager* artManager) :
 		artManager_(artManager),
-		viewWidth_(300),
-		viewHeight_(400)
+		viewWidth_(ART_VIEW_WIDTH),
+		viewHeight_(ART_VIEW_HEIGHT)
 	{
 		//floorAndCeiling_ = Engine::LoadImageResource("resources/updown/floorceil.png");
 		
@@ -40,6 +40,10 @@ namespace LOFI
 
 	void MapView::RenderMap(SDL_Surface* target, Map* currentMap, Position* currentPosition)
 	{
+		PROFILE_SCOPE(PROFILE_ZONE_RENDERMAP);
+		
+		// the wall sets drawn from here on are kept loaded until the next frame
+		artManager_->BeginFrame();
 		
 		//Engine::BlitSprite(floorAndCeiling_, target, 0, 0);
 		
@@ -58,7 +62,7 @@ namespace LOFI
 		skyRect.x = skyRect.y = 0;
 		skyRect.w = viewWidth_;
 		skyRect.h = static_cast<int>(0.6f * static_cast<float>(viewHeight_));
-		SDL_FillRect(target, &skyRect, SDL_MapRGB(target->format, 77, 130, 229));
+		Engine::FillRect(target, &skyRect, SDL_MapRGB(target->format, 77, 130, 229));
 	}
 	
 	////////////////////////////////////////////////////////////////////////////
@@ -70,7 +74,7 @@ namespace LOFI
 		groundRect.y = static_cast<int>(0.6f * static_cast<float>(viewHeight_));
 		groundRect.w = viewWidth_;
 		groundRect.h = static_cast<int>(0.4f * static_cast<float>(viewHeight_));
-		SDL_FillRect(target, &groundRect, SDL_MapRGB(target->format, 16, 80, 30));
+		Engine::FillRect(target, &groundRect, SDL_MapRGB(target->format, 16, 80, 30));
 	}
 
 	////////////////////////////////////////////////////////////////////////////
@@ -18,15 +18,41 @@
 
 namespace LOFI
 {
+	/// the colors the automap draws each type of wall in
+	static const Uint8 automapWallColors[MINIMAP_WALL_TYPES][3] =
+	{
+		{ 224, 224, 224 }, 	// no type, the edges of the map
+		{ 176,  80,  56 }, 	// WALL_TYPE_BRICK
+		{ 144, 144, 144 }, 	// WALL_TYPE_STONE
+		{ 160, 112,  56 }, 	// WALL_TYPE_WOOD
+		{ 112, 160, 208 } 	// WALL_TYPE_METAL
+	};
+	
+	////////////////////////////////////////////////////////////////////////////
+	
 	MiniMap::MiniMap(Map* sourceMap, int width, int height) : 
 		currentMap_(0),
 		miniMapSurface_(0),
 		width_(width), 
-		height_(height)
+		height_(height),
+		repaintAll_(true),
+		paintedGeneration_(0),
+		paintedVisitedCount_(0),
+		paintedPlayerX_(0),
+		paintedPlayerZ_(0),
+		playerX_(0),
+		playerZ_(0),
+		cellWidth_(0),
+		cellHeight_(0),
+		scrolling_(false),
+		automap_(false),
+		stamps_(0)
 	{
 		width_ = (width_ <= 0) ? 1 : width_;
 		height_ = (height_ <= 0) ? 1 : height_;
 		
+		SurfaceMemory::AddEvictor(MiniMap::EvictForSurfaceBudget, this);
+		
 		SetMap(sourceMap);
 		RecreateMiniMapSurface();
 	}
@@ -35,6 +61,10 @@ namespace LOFI
 	
 	MiniMap::~MiniMap()
 	{
+		SurfaceMemory::RemoveEvictor(MiniMap::EvictForSurfaceBudget, this);
+		
+		DestroyChunks();
+		DestroyStamps();
 		DestroyMiniMapSurface();
 		currentMap_ 	= 0;
 		width_ 			= 0;
@@ -45,6 +75,11 @@ namespace LOFI
 	
 	void MiniMap::SetMap(Map* sourceMap)
 	{
+		if (sourceMap != currentMap_)
+		{
+			repaintAll_ = true;
+		}
+		
 		currentMap_ = sourceMap;
 	}
 	
@@ -62,9 +97,61 @@ namespace LOFI
 	
 	////////////////////////////////////////////////////////////////////////////
 	
-	void MiniMap::Update()
+	void MiniMap::Update(const Position* playerPosition)
 	{
-		RecreateMiniMapSurface();
+		PROFILE_SCOPE(PROFILE_ZONE_MINIMAP);
+		
+		if (playerPosition)
+		{
+			playerX_ = playerPosition->x_;
+			playerZ_ = playerPosition->y_;
+		}
+		
+		if (!miniMapSurface_ || !currentMap_)
+		{
+			RecreateMiniMapSurface();
+			return;
+		}
+		
+		// a cleared map has changed everywhere
+		if (currentMap_->GetGeneration() != paintedGeneration_)
+		{
+			repaintAll_ = true;
+		}
+		
+		if (repaintAll_)
+		{
+			RecreateMiniMapSurface();
+			return;
+		}
+		
+		// the cells visited since the last update
+		unsigned int visitedCount = currentMap_->GetVisitedCount();
+		for (; paintedVisitedCount_ < visitedCount; paintedVisitedCount_++)
+		{
+			dirtyCells_.push_back(currentMap_->GetVisitedCell(paintedVisitedCount_));
+		}
+		
+		RepaintChangedCells();
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void MiniMap::SetAutomap(bool automap)
+	{
+		if (automap != automap_)
+		{
+			repaintAll_ = true;
+		}
+		
+		automap_ = automap;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	bool MiniMap::IsAutomap() const
+	{
+		return automap_;
 	}
 	
 	////////////////////////////////////////////////////////////////////////////
@@ -85,62 +172,393 @@ namespace LOFI
 				WriteLog(stderr, "Unable to create mini-map surface %dx%d!\n\tSDL Error: %s\n", width_, height_, SDL_GetError());
 				return;
 			}
+			
+			SurfaceMemory::Track(miniMapSurface_, SURFACE_CATEGORY_MINIMAP);
 		
 			SDL_SetColorKey(miniMapSurface_, (SDL_SRCCOLORKEY | SDL_RLEACCEL), SDL_MapRGB(miniMapSurface_->format, 0, 0, 0));
 		}
 		
 		
-		// calculate size of cells
+		if (!currentMap_)
+		{
+			return;
+		}
+		
+		// whatever changed before now is covered by this repaint
+		paintedGeneration_ = currentMap_->GetGeneration();
+		paintedVisitedCount_ = currentMap_->GetVisitedCount();
+		dirtyCells_.clear();
+		repaintAll_ = false;
+		
+		// the chunks were of the last map, or of this one before it changed
+		DestroyChunks();
+		
+		// calculate size of cells, and scroll when they would be too small to see
 		int mapWidth = currentMap_->GetWidth();
 		int mapHeight = currentMap_->GetHeight();
-		int mapCellWidth = width_ / mapWidth;
-		int mapCellHeight = height_ / mapHeight;
+		cellWidth_ = width_ / mapWidth;
+		cellHeight_ = height_ / mapHeight;
+		scrolling_ = (cellWidth_ < MINIMAP_MIN_CELL_SIZE || cellHeight_ < MINIMAP_MIN_CELL_SIZE);
 		
-		// get player position
-		int playerZ = globalEngineInstance->GetGameState()->GetPlayerPosition()->y_;
-		int playerX = globalEngineInstance->GetGameState()->GetPlayerPosition()->x_;
+		if (scrolling_)
+		{
+			cellWidth_ = MINIMAP_MIN_CELL_SIZE;
+			cellHeight_ = MINIMAP_MIN_CELL_SIZE;
+		}
 		
-		// some colors
-		unsigned int playerCellColor 		= SDL_MapRGB(miniMapSurface_->format, 255, 255, 0);
-		unsigned int notVisitedCellColor 	= SDL_MapRGB(miniMapSurface_->format, 32, 32, 32);
-		unsigned int visitedCellColor 		= SDL_MapRGB(miniMapSurface_->format, 0, 128, 0);
+		if (automap_)
+		{
+			CreateStamps();
+		}
 		
-		// clear mini-map
-		SDL_FillRect(miniMapSurface_, 0, SDL_MapRGB(miniMapSurface_->format, 0, 0, 0));
+		paintedPlayerX_ = playerX_;
+		paintedPlayerZ_ = playerZ_;
 		
-		// allocate our rect only once	
-		SDL_Rect box;
+		if (scrolling_)
+		{
+			ComposeView();
+			return;
+		}
+		
+		// clear mini-map
+		Engine::FillRect(miniMapSurface_, 0, SDL_MapRGB(miniMapSurface_->format, 0, 0, 0));
 		
 		// draw cells
 		for (int row = 0; row < mapHeight; row++)
 		{
 			for (int column = 0; column < mapWidth; column++)
 			{
-				// calculate cell positioning
-				box.x = column * mapCellWidth;
-				box.y = row * mapCellHeight;
-				box.w = box.x + mapCellWidth;
-				box.h = box.y + mapCellHeight;
+				PaintCell(miniMapSurface_, column, row, column * cellWidth_, row * cellHeight_);
+			}
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void MiniMap::RepaintChangedCells()
+	{
+		bool changed = !dirtyCells_.empty();
+		int mapWidth = currentMap_->GetWidth();
+		
+		// the player leaving a cell, and arriving in one, changes both of them
+		if (playerX_ != paintedPlayerX_ || playerZ_ != paintedPlayerZ_)
+		{
+			dirtyCells_.push_back((paintedPlayerZ_ * mapWidth) + paintedPlayerX_);
+			dirtyCells_.push_back((playerZ_ * mapWidth) + playerX_);
+			
+			paintedPlayerX_ = playerX_;
+			paintedPlayerZ_ = playerZ_;
+			changed = true;
+		}
+		
+		for (unsigned int index = 0; index < dirtyCells_.size(); index++)
+		{
+			RepaintCell(dirtyCells_[index] % mapWidth, dirtyCells_[index] / mapWidth);
+		}
+		
+		dirtyCells_.clear();
+		
+		// the chunks are up to date, and the view moved or cells in it changed
+		if (scrolling_ && changed)
+		{
+			ComposeView();
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void MiniMap::RepaintCell(int column, int row)
+	{
+		if (!scrolling_)
+		{
+			PaintCell(miniMapSurface_, column, row, column * cellWidth_, row * cellHeight_);
+			return;
+		}
+		
+		// a chunk that is not kept is rendered as it is when it is next needed
+		int chunksAcross = (currentMap_->GetWidth() + MINIMAP_CHUNK_CELLS - 1) / MINIMAP_CHUNK_CELLS;
+		int chunkKey = ((row / MINIMAP_CHUNK_CELLS) * chunksAcross) + (column / MINIMAP_CHUNK_CELLS);
+		
+		std::map<int, SDL_Surface*>::iterator found = chunks_.find(chunkKey);
+		if (found != chunks_.end())
+		{
+			PaintCell(found->second, column, row,
+				(column % MINIMAP_CHUNK_CELLS) * cellWidth_,
+				(row % MINIMAP_CHUNK_CELLS) * cellHeight_);
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void MiniMap::PaintCell(SDL_Surface* target, int column, int row, int x, int y)
+	{
+		if (column < 0 || row < 0 || column >= currentMap_->GetWidth() || row >= currentMap_->GetHeight())
+		{
+			return;
+		}
+		
+		// calculate cell positioning
+		SDL_Rect box;
+		box.x = x;
+		box.y = y;
+		box.w = cellWidth_;
+		box.h = cellHeight_;
+		
+		// the automap stamps the cell with its walls
+		if (automap_ && stamps_)
+		{
+			int wallMask = 0;
+			int stampRow = 0;
+			
+			if (currentMap_->IsVisited(column, row))
+			{
+				wallMask = currentMap_->GetWallMask(column, row);
+				stampRow = 1 + (GetCellWallType(column, row, wallMask) * 2) + ((row == paintedPlayerZ_ && column == paintedPlayerX_) ? 1 : 0);
+			}
+			
+			Engine::Blit(stamps_, target, wallMask * cellWidth_, stampRow * cellHeight_, x, y, cellWidth_, cellHeight_);
+			return;
+		}
+		
+		// draw the cell
+		if (currentMap_->IsVisited(column, row))
+		{
+			if (row == paintedPlayerZ_ && column == paintedPlayerX_)
+			{
+				// if the player is here
+				Engine::FillRect(target, &box, SDL_MapRGB(target->format, 255, 255, 0));
+			}
+			else
+			{
+				// we have been here before
+				Engine::FillRect(target, &box, SDL_MapRGB(target->format, 0, 128, 0));
+			}
+		}
+		else
+		{
+			// we have not been here before
+			Engine::FillRect(target, &box, SDL_MapRGB(target->format, 32, 32, 32));
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void MiniMap::ComposeView()
+	{
+		int chunkWidth = MINIMAP_CHUNK_CELLS * cellWidth_;
+		int chunkHeight = MINIMAP_CHUNK_CELLS * cellHeight_;
+		int chunksAcross = (currentMap_->GetWidth() + MINIMAP_CHUNK_CELLS - 1) / MINIMAP_CHUNK_CELLS;
+		int chunksDown = (currentMap_->GetHeight() + MINIMAP_CHUNK_CELLS - 1) / MINIMAP_CHUNK_CELLS;
+		
+		// the top left of the view in pixels of the whole map, with the player's cell in the middle
+		int viewX = (paintedPlayerX_ * cellWidth_) + (cellWidth_ / 2) - (width_ / 2);
+		int viewY = (paintedPlayerZ_ * cellHeight_) + (cellHeight_ / 2) - (height_ / 2);
+		
+		// the chunks the view overlaps, rounding down for a view off the top or left of the map
+		int firstColumn = std::max(0, (viewX >= 0) ? viewX / chunkWidth : -1);
+		int firstRow = std::max(0, (viewY >= 0) ? viewY / chunkHeight : -1);
+		int lastColumn = std::min(chunksAcross - 1, (viewX + width_ - 1) / chunkWidth);
+		int lastRow = std::min(chunksDown - 1, (viewY + height_ - 1) / chunkHeight);
+		
+		// off the edges of the map is left clear
+		Engine::FillRect(miniMapSurface_, 0, SDL_MapRGB(miniMapSurface_->format, 0, 0, 0));
+		
+		for (int chunkRow = firstRow; chunkRow <= lastRow; chunkRow++)
+		{
+			for (int chunkColumn = firstColumn; chunkColumn <= lastColumn; chunkColumn++)
+			{
+				SDL_Surface* chunk = GetChunk(chunkColumn, chunkRow);
+				if (chunk)
+				{
+					Engine::BlitSprite(chunk, miniMapSurface_,
+						(chunkColumn * chunkWidth) - viewX,
+						(chunkRow * chunkHeight) - viewY);
+				}
+			}
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	SDL_Surface* MiniMap::GetChunk(int chunkColumn, int chunkRow)
+	{
+		int chunksAcross = (currentMap_->GetWidth() + MINIMAP_CHUNK_CELLS - 1) / MINIMAP_CHUNK_CELLS;
+		int chunkKey = (chunkRow * chunksAcross) + chunkColumn;
+		
+		std::map<int, SDL_Surface*>::iterator found = chunks_.find(chunkKey);
+		if (found != chunks_.end())
+		{
+			return found->second;
+		}
+		
+		SDL_Surface* chunk = SDL_CreateRGBSurface(
+			SDL_SWSURFACE, 
+			MINIMAP_CHUNK_CELLS * cellWidth_, MINIMAP_CHUNK_CELLS * cellHeight_, 
+			miniMapSurface_->format->BitsPerPixel, 
+			miniMapSurface_->format->Rmask, miniMapSurface_->format->Gmask, miniMapSurface_->format->Bmask, miniMapSurface_->format->Amask);
+		
+		if (!chunk)
+		{
+			// log the error
+			WriteLog(stderr, "Unable to create mini-map chunk %d,%d!\n\tSDL Error: %s\n", chunkColumn, chunkRow, SDL_GetError());
+			
+			// return failure
+			return 0;
+		}
+		
+		SurfaceMemory::Track(chunk, SURFACE_CATEGORY_MINIMAP);
+		
+		// the cells past the edge of the map stay clear
+		Engine::FillRect(chunk, 0, SDL_MapRGB(chunk->format, 0, 0, 0));
+		
+		int firstColumn = chunkColumn * MINIMAP_CHUNK_CELLS;
+		int firstRow = chunkRow * MINIMAP_CHUNK_CELLS;
+		
+		for (int row = 0; row < MINIMAP_CHUNK_CELLS; row++)
+		{
+			for (int column = 0; column < MINIMAP_CHUNK_CELLS; column++)
+			{
+				PaintCell(chunk, firstColumn + column, firstRow + row, column * cellWidth_, row * cellHeight_);
+			}
+		}
+		
+		chunks_[chunkKey] = chunk;
+		
+		while (chunks_.size() > MINIMAP_MAX_CHUNKS)
+		{
+			EvictFarthestChunk();
+		}
+		
+		return chunk;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	bool MiniMap::EvictFarthestChunk()
+	{
+		if (chunks_.empty() || !currentMap_)
+		{
+			return false;
+		}
+		
+		int chunksAcross = (currentMap_->GetWidth() + MINIMAP_CHUNK_CELLS - 1) / MINIMAP_CHUNK_CELLS;
+		int playerChunkColumn = paintedPlayerX_ / MINIMAP_CHUNK_CELLS;
+		int playerChunkRow = paintedPlayerZ_ / MINIMAP_CHUNK_CELLS;
+		
+		std::map<int, SDL_Surface*>::iterator farthest = chunks_.end();
+		int farthestDistance = -1;
+		
+		for (std::map<int, SDL_Surface*>::iterator chunk = chunks_.begin(); chunk != chunks_.end(); chunk++)
+		{
+			int distance = 
+				abs((chunk->first % chunksAcross) - playerChunkColumn) + 
+				abs((chunk->first / chunksAcross) - playerChunkRow);
+			
+			if (distance > farthestDistance)
+			{
+				farthest = chunk;
+				farthestDistance = distance;
+			}
+		}
+		
+		SurfaceMemory::Untrack(farthest->second);
+		SDL_FreeSurface(farthest->second);
+		chunks_.erase(farthest);
+		
+		return true;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void MiniMap::DestroyChunks()
+	{
+		for (std::map<int, SDL_Surface*>::iterator chunk = chunks_.begin(); chunk != chunks_.end(); chunk++)
+		{
+			SurfaceMemory::Untrack(chunk->second);
+			SDL_FreeSurface(chunk->second);
+		}
+		
+		chunks_.clear();
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	void MiniMap::CreateStamps()
+	{
+		int stampTableWidth = MINIMAP_WALL_MASKS * cellWidth_;
+		int stampTableHeight = (1 + (MINIMAP_WALL_TYPES * 2)) * cellHeight_;
+		
+		if (stamps_ && stamps_->w == stampTableWidth && stamps_->h == stampTableHeight)
+		{
+			return;
+		}
+		
+		DestroyStamps();
+		
+		stamps_ = SDL_CreateRGBSurface(
+			SDL_SWSURFACE, 
+			stampTableWidth, stampTableHeight, 
+			miniMapSurface_->format->BitsPerPixel, 
+			miniMapSurface_->format->Rmask, miniMapSurface_->format->Gmask, miniMapSurface_->format->Bmask, miniMapSurface_->format->Amask);
+		
+		if (!stamps_)
+		{
+			// log the error
+			WriteLog(stderr, "Unable to create the automap stamps %dx%d!\n\tSDL Error: %s\n", stampTableWidth, stampTableHeight, SDL_GetError());
+			
+			// return failure
+			return;
+		}
+		
+		SurfaceMemory::Track(stamps_, SURFACE_CATEGORY_MINIMAP);
+		
+		// the walls are drawn thicker on bigger cells
+		int thickness = std::max(1, std::min(cellWidth_, cellHeight_) / 7);
+		
+		for (int stampRow = 0; stampRow < 1 + (MINIMAP_WALL_TYPES * 2); stampRow++)
+		{
+			// the first row has not been visited, the rest alternate between without and with the player
+			Uint32 floorColor = 
+				(0 == stampRow) ? SDL_MapRGB(stamps_->format, 32, 32, 32) :
+				(0 == stampRow % 2) ? SDL_MapRGB(stamps_->format, 255, 255, 0) :
+				SDL_MapRGB(stamps_->format, 0, 128, 0);
+			
+			const Uint8* wallColor = automapWallColors[(stampRow > 0) ? (stampRow - 1) / 2 : 0];
+			Uint32 edgeColor = SDL_MapRGB(stamps_->format, wallColor[0], wallColor[1], wallColor[2]);
+			
+			for (int wallMask = 0; wallMask < MINIMAP_WALL_MASKS; wallMask++)
+			{
+				SDL_Rect box;
+				box.x = wallMask * cellWidth_;
+				box.y = stampRow * cellHeight_;
+				box.w = cellWidth_;
+				box.h = cellHeight_;
+				Engine::FillRect(stamps_, &box, floorColor);
 				
-				// draw the cell
-				if (currentMap_->IsVisited(column, row))
+				// nothing is known of the walls of a cell that has not been visited
+				if (0 == stampRow)
 				{
-					
-					if (row == playerZ && column == playerX)
+					continue;
+				}
+				
+				for (int facing = 0; facing < 4; facing++)
+				{
+					if (!(wallMask & (1 << facing)))
 					{
-						// if the player is here
-						SDL_FillRect(miniMapSurface_, &box, playerCellColor);
+						continue;
 					}
-					else
+					
+					SDL_Rect edge = box;
+					switch(facing)
 					{
-						// we have been here before
-						SDL_FillRect(miniMapSurface_, &box, visitedCellColor);
+						case PLAYER_FACING_NORTH: { edge.h = thickness; } break;
+						case PLAYER_FACING_SOUTH: { edge.y += cellHeight_ - thickness; edge.h = thickness; } break;
+						case PLAYER_FACING_WEST: { edge.w = thickness; } break;
+						case PLAYER_FACING_EAST: { edge.x += cellWidth_ - thickness; edge.w = thickness; } break;
+						default: break;
 					}
-				}
-				else
-				{
-					// we have not been here before
-					SDL_FillRect(miniMapSurface_, &box, notVisitedCellColor);
+					
+					Engine::FillRect(stamps_, &edge, edgeColor);
 				}
 			}
 		}
@@ -148,6 +566,54 @@ namespace LOFI
 	
 	////////////////////////////////////////////////////////////////////////////
 	
+	void MiniMap::DestroyStamps()
+	{
+		if (stamps_)
+		{
+			SurfaceMemory::Untrack(stamps_);
+			SDL_FreeSurface(stamps_);
+			stamps_ = 0;
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	int MiniMap::GetCellWallType(int column, int row, int wallMask) const
+	{
+		// count the walls of each type, the types the automap has no color for are drawn as no type
+		int wallsOfType[MINIMAP_WALL_TYPES] = { 0 };
+		
+		for (int facing = 0; facing < 4; facing++)
+		{
+			if (wallMask & (1 << facing))
+			{
+				int wallType = currentMap_->GetWall(column, row, facing);
+				wallsOfType[(wallType > 0 && wallType < MINIMAP_WALL_TYPES) ? wallType : 0]++;
+			}
+		}
+		
+		// the most common, the lowest id of those that are as common
+		int cellWallType = 0;
+		for (int wallType = 1; wallType < MINIMAP_WALL_TYPES; wallType++)
+		{
+			if (wallsOfType[wallType] > wallsOfType[cellWallType])
+			{
+				cellWallType = wallType;
+			}
+		}
+		
+		return cellWallType;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	bool MiniMap::EvictForSurfaceBudget(void* userData)
+	{
+		return static_cast<MiniMap*>(userData)->EvictFarthestChunk();
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
 	void MiniMap::DestroyMiniMapSurface()
 	{
 		Engine::UnloadImageResource(miniMapSurface_);
@@ -0,0 +1,316 @@
+
+// CODESTYLE: v2.0
+
+// PixelCache.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: keeps images already converted to the display format on disk between runs
+
+/**
+ * @file PixelCache.cpp
+ * @brief Display Format Pixel Cache - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+#if defined(_WIN32)
+	#include <direct.h>
+#else
+	#include <sys/stat.h>
+	#include <sys/types.h>
+#endif
+
+// the 64-bit FNV-1a hash constants
+#define PIXELCACHE_FNV_OFFSET 0xcbf29ce484222325ULL
+#define PIXELCACHE_FNV_PRIME 0x100000001b3ULL
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	/// the header at the start of every cache file, written in the machine's own byte order
+	struct PixelCacheHeader
+	{
+		char magic_[4];
+		Uint32 version_;
+		Uint32 width_;
+		Uint32 height_;
+		Uint32 bitsPerPixel_;
+		Uint32 redMask_;
+		Uint32 greenMask_;
+		Uint32 blueMask_;
+		Uint32 alphaMask_;
+		Uint32 flags_;
+		Uint32 colorKey_;
+	};
+
+	static std::string cacheDirectory;
+	static volatile unsigned long cacheHits = 0;
+	static volatile unsigned long cacheMisses = 0;
+
+	/// continues a 64-bit FNV-1a @a hash over @a size bytes
+	static unsigned long long HashBytes(unsigned long long hash, const unsigned char* bytes, unsigned long size)
+	{
+		for (unsigned long index = 0; index < size; index++)
+		{
+			hash = (hash ^ bytes[index]) * PIXELCACHE_FNV_PRIME;
+		}
+		return hash;
+	}
+
+	/// hashes the bytes of the source file @a filePath, from the asset archive if it has it
+	static bool HashSourceFile(const char* filePath, unsigned long long* hash)
+	{
+		AssetArchiveEntry entry;
+		if (AssetArchive::Find(filePath, &entry))
+		{
+			*hash = HashBytes(PIXELCACHE_FNV_OFFSET, AssetArchive::GetData(entry), entry.dataSize_);
+			return true;
+		}
+
+		FILE* fp = fopen(filePath, "rb");
+		if (!fp)
+		{
+			return false;
+		}
+
+		*hash = PIXELCACHE_FNV_OFFSET;
+
+		unsigned char buffer[0x1000];
+		size_t bytesRead;
+		while ((bytesRead = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+		{
+			*hash = HashBytes(*hash, buffer, static_cast<unsigned long>(bytesRead));
+		}
+
+		bool succeeded = !ferror(fp);
+		fclose(fp);
+
+		return succeeded;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void PixelCache::SetDirectory(const char* directoryPath)
+	{
+		cacheDirectory = (directoryPath) ? directoryPath : "";
+
+		if (!cacheDirectory.empty())
+		{
+			// it is fine if it already exists
+			#if defined(_WIN32)
+			_mkdir(cacheDirectory.c_str());
+			#else
+			mkdir(cacheDirectory.c_str(), 0755);
+			#endif
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool PixelCache::IsEnabled()
+	{
+		return !cacheDirectory.empty();
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* PixelCache::Load(const char* filePath)
+	{
+		SDL_Surface* screen = SDL_GetVideoSurface();
+		if (!PixelCache::IsEnabled() || !screen)
+		{
+			return 0;
+		}
+
+		const SDL_PixelFormat* format = screen->format;
+
+		char cacheFilePath[0x200];
+		FILE* fp = 0;
+
+		if (PixelCache::GetCacheFilePath(filePath, format, cacheFilePath, sizeof(cacheFilePath)))
+		{
+			fp = fopen(cacheFilePath, "rb");
+		}
+
+		if (!fp)
+		{
+			__sync_fetch_and_add(&cacheMisses, 1);
+			return 0;
+		}
+
+		// the file name already matches the source and the format, the header guards against a damaged file
+		PixelCacheHeader header;
+		SDL_Surface* surface = 0;
+
+		if (1 == fread(&header, sizeof(header), 1, fp) &&
+			0 == memcmp(header.magic_, "LWPC", 4) &&
+			PIXELCACHE_VERSION == header.version_ &&
+			format->BitsPerPixel == header.bitsPerPixel_ &&
+			format->Rmask == header.redMask_ &&
+			format->Gmask == header.greenMask_ &&
+			format->Bmask == header.blueMask_ &&
+			format->Amask == header.alphaMask_)
+		{
+			surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+				static_cast<int>(header.width_), static_cast<int>(header.height_), static_cast<int>(header.bitsPerPixel_),
+				header.redMask_, header.greenMask_, header.blueMask_, header.alphaMask_);
+		}
+
+		if (surface)
+		{
+			unsigned int rowBytes = surface->w * surface->format->BytesPerPixel;
+
+			for (int row = 0; row < surface->h; row++)
+			{
+				if (1 != fread(static_cast<unsigned char*>(surface->pixels) + row * surface->pitch, rowBytes, 1, fp))
+				{
+					// truncated, so treat it as a miss
+					SDL_FreeSurface(surface);
+					surface = 0;
+					break;
+				}
+			}
+		}
+
+		fclose(fp);
+
+		if (!surface)
+		{
+			__sync_fetch_and_add(&cacheMisses, 1);
+			return 0;
+		}
+
+		// the color key is set the same way the decoder sets it
+		if (header.flags_ & SDL_SRCCOLORKEY)
+		{
+			SDL_SetColorKey(surface, (SDL_SRCCOLORKEY | SDL_RLEACCEL), header.colorKey_);
+		}
+
+		__sync_fetch_and_add(&cacheHits, 1);
+
+		return surface;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool PixelCache::Store(const char* filePath, SDL_Surface* converted)
+	{
+		if (!PixelCache::IsEnabled() || !converted)
+		{
+			return false;
+		}
+
+		char cacheFilePath[0x200];
+		if (!PixelCache::GetCacheFilePath(filePath, converted->format, cacheFilePath, sizeof(cacheFilePath)))
+		{
+			return false;
+		}
+
+		PixelCacheHeader header;
+		memcpy(header.magic_, "LWPC", 4);
+		header.version_ 		= PIXELCACHE_VERSION;
+		header.width_ 			= converted->w;
+		header.height_ 			= converted->h;
+		header.bitsPerPixel_ 	= converted->format->BitsPerPixel;
+		header.redMask_ 		= converted->format->Rmask;
+		header.greenMask_ 		= converted->format->Gmask;
+		header.blueMask_ 		= converted->format->Bmask;
+		header.alphaMask_ 		= converted->format->Amask;
+		header.flags_ 			= converted->flags & SDL_SRCCOLORKEY;
+		header.colorKey_ 		= converted->format->colorkey;
+
+		// write a temporary file and rename it into place, so a reader never sees half a file
+		char temporaryFilePath[0x210];
+		sprintf(temporaryFilePath, "%s.%u.tmp", cacheFilePath, static_cast<unsigned int>(SDL_ThreadID()));
+
+		FILE* fp = fopen(temporaryFilePath, "wb");
+		if (!fp)
+		{
+			return false;
+		}
+
+		bool succeeded = (1 == fwrite(&header, sizeof(header), 1, fp));
+
+		if (SDL_MUSTLOCK(converted))
+		{
+			SDL_LockSurface(converted);
+		}
+
+		unsigned int rowBytes = converted->w * converted->format->BytesPerPixel;
+
+		for (int row = 0; succeeded && row < converted->h; row++)
+		{
+			succeeded = (1 == fwrite(static_cast<unsigned char*>(converted->pixels) + row * converted->pitch, rowBytes, 1, fp));
+		}
+
+		if (SDL_MUSTLOCK(converted))
+		{
+			SDL_UnlockSurface(converted);
+		}
+
+		succeeded = (0 == fclose(fp)) && succeeded;
+
+		if (succeeded)
+		{
+			#if defined(_WIN32)
+			remove(cacheFilePath);
+			#endif
+			succeeded = (0 == rename(temporaryFilePath, cacheFilePath));
+		}
+
+		if (!succeeded)
+		{
+			remove(temporaryFilePath);
+		}
+
+		return succeeded;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned long PixelCache::GetHitCount()
+	{
+		return cacheHits;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned long PixelCache::GetMissCount()
+	{
+		return cacheMisses;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool PixelCache::GetCacheFilePath(const char* filePath, const SDL_PixelFormat* format, char* cacheFilePath, unsigned int size)
+	{
+		unsigned long long sourceHash;
+		if (!HashSourceFile(filePath, &sourceHash))
+		{
+			return false;
+		}
+
+		Uint32 formatFields[5] =
+		{
+			format->BitsPerPixel,
+			format->Rmask,
+			format->Gmask,
+			format->Bmask,
+			format->Amask
+		};
+
+		unsigned long long formatHash = HashBytes(PIXELCACHE_FNV_OFFSET,
+			reinterpret_cast<const unsigned char*>(formatFields), sizeof(formatFields));
+
+		int length = snprintf(cacheFilePath, size, "%s/%016llx-%08x.px",
+			cacheDirectory.c_str(),
+			sourceHash,
+			static_cast<unsigned int>(formatHash ^ (formatHash >> 32)));
+
+		return length > 0 && static_cast<unsigned int>(length) < size;
+	}
+
+} // end namespace
+
@@ -0,0 +1,309 @@
+
+// CODESTYLE: v2.0
+
+// Presenter.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: presents finished frames from a pool of back buffers, optionally on a thread of its own
+
+/**
+ * @file Presenter.cpp
+ * @brief Frame Presenter - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	Presenter::Presenter(SDL_Surface* display, bool flip, bool threaded) :
+		display_(display),
+		flip_(flip),
+		drawingBuffer_(-1),
+		waitingBuffer_(-1),
+		presentingBuffer_(-1),
+		framesPresented_(0),
+		framesDropped_(0),
+		totalLatency_(0),
+		maxLatency_(0),
+		thread_(0),
+		stopping_(false)
+	{
+		lock_ 			= SDL_CreateMutex();
+		frameWaiting_ 	= SDL_CreateCond();
+		framePresented_ = SDL_CreateCond();
+
+		for (int index = 0; index < PRESENTER_BACK_BUFFERS; index++)
+		{
+			buffers_[index] = 0;
+			submitTimes_[index] = 0;
+		}
+
+		// without the thread the frames are drawn straight onto the display, so only the thread needs back buffers
+		if (threaded && this->CreateBackBuffers())
+		{
+			thread_ = SDL_CreateThread(Presenter::PresentThread, this);
+			if (!thread_)
+			{
+				// log the error, the frames are still presented by Submit()
+				WriteLog(stderr, "Unable to create the presentation thread!\n\tSDL Error: %s\n", SDL_GetError());
+			}
+		}
+
+		if (!thread_)
+		{
+			this->FreeBackBuffers();
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	Presenter::~Presenter()
+	{
+		if (thread_)
+		{
+			// the thread presents the frame that is waiting before it stops
+			SDL_LockMutex(lock_);
+			stopping_ = true;
+			SDL_CondSignal(frameWaiting_);
+			SDL_UnlockMutex(lock_);
+
+			SDL_WaitThread(thread_, 0);
+			thread_ = 0;
+		}
+
+		this->FreeBackBuffers();
+
+		SDL_DestroyCond(framePresented_);
+		SDL_DestroyCond(frameWaiting_);
+		SDL_DestroyMutex(lock_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* Presenter::GetBackBuffer()
+	{
+		if (!thread_)
+		{
+			return display_;
+		}
+
+		if (-1 == drawingBuffer_)
+		{
+			// with three buffers there is always one that is neither waiting nor being presented
+			SDL_LockMutex(lock_);
+			for (int index = 0; index < PRESENTER_BACK_BUFFERS; index++)
+			{
+				if (index != waitingBuffer_ && index != presentingBuffer_)
+				{
+					drawingBuffer_ = index;
+					break;
+				}
+			}
+			SDL_UnlockMutex(lock_);
+		}
+
+		return buffers_[drawingBuffer_];
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Presenter::Submit()
+	{
+		// without the thread the frame was drawn on the display itself, and only has to be flipped
+		if (!thread_)
+		{
+			Microseconds submitTime = Clock::GetMicroseconds();
+
+			if (flip_)
+			{
+				PROFILE_SCOPE(PROFILE_ZONE_FLIPSCREEN);
+				SDL_Flip(display_);
+			}
+
+			SDL_LockMutex(lock_);
+			this->RecordLatency(submitTime);
+			SDL_UnlockMutex(lock_);
+			return;
+		}
+
+		if (-1 == drawingBuffer_)
+		{
+			return;
+		}
+
+		int buffer = drawingBuffer_;
+		drawingBuffer_ = -1;
+
+		submitTimes_[buffer] = Clock::GetMicroseconds();
+
+		SDL_LockMutex(lock_);
+
+		// a frame still waiting is out of date now
+		if (-1 != waitingBuffer_)
+		{
+			framesDropped_++;
+		}
+
+		waitingBuffer_ = buffer;
+		SDL_CondSignal(frameWaiting_);
+		SDL_UnlockMutex(lock_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Presenter::Flush()
+	{
+		if (!thread_)
+		{
+			return;
+		}
+
+		SDL_LockMutex(lock_);
+		while (-1 != waitingBuffer_ || -1 != presentingBuffer_)
+		{
+			SDL_CondWait(framePresented_, lock_);
+		}
+		SDL_UnlockMutex(lock_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool Presenter::IsThreaded() const
+	{
+		return (0 != thread_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Presenter::WriteReport(FILE* fp) const
+	{
+		SDL_LockMutex(lock_);
+
+		double meanLatency = (framesPresented_) ? static_cast<double>(totalLatency_) / framesPresented_ : 0.0;
+
+		WriteLog(fp, "Presenter: %u frames presented, %u dropped, %.2f ms mean and %.2f ms longest present latency (%s)\n",
+			framesPresented_, framesDropped_,
+			meanLatency / 1000.0, static_cast<double>(maxLatency_) / 1000.0,
+			(thread_) ? "presentation thread" : "main thread");
+
+		SDL_UnlockMutex(lock_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	int Presenter::PresentThread(void* userData)
+	{
+		Presenter* presenter = static_cast<Presenter*>(userData);
+
+		SDL_LockMutex(presenter->lock_);
+
+		for (;;)
+		{
+			while (-1 == presenter->waitingBuffer_ && !presenter->stopping_)
+			{
+				SDL_CondWait(presenter->frameWaiting_, presenter->lock_);
+			}
+
+			if (-1 == presenter->waitingBuffer_)
+			{
+				// stopping and nothing left to present
+				break;
+			}
+
+			presenter->presentingBuffer_ = presenter->waitingBuffer_;
+			presenter->waitingBuffer_ = -1;
+
+			// present without holding the lock, so the next frame can be submitted meanwhile
+			SDL_UnlockMutex(presenter->lock_);
+			presenter->Present(presenter->presentingBuffer_);
+			SDL_LockMutex(presenter->lock_);
+
+			presenter->RecordLatency(presenter->submitTimes_[presenter->presentingBuffer_]);
+			presenter->presentingBuffer_ = -1;
+			SDL_CondBroadcast(presenter->framePresented_);
+		}
+
+		SDL_UnlockMutex(presenter->lock_);
+
+		return 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Presenter::Present(int buffer)
+	{
+		PROFILE_SCOPE(PROFILE_ZONE_FLIPSCREEN);
+
+		SDL_BlitSurface(buffers_[buffer], 0, display_, 0);
+
+		if (flip_)
+		{
+			SDL_Flip(display_);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool Presenter::CreateBackBuffers()
+	{
+		const SDL_PixelFormat* format = display_->format;
+
+		for (int index = 0; index < PRESENTER_BACK_BUFFERS; index++)
+		{
+			// in the display's own format, so presenting is a straight copy
+			buffers_[index] = SDL_CreateRGBSurface(
+				SDL_SWSURFACE,
+				display_->w, display_->h,
+				format->BitsPerPixel,
+				format->Rmask, format->Gmask, format->Bmask, format->Amask);
+
+			if (!buffers_[index])
+			{
+				// log the error, the frames are drawn straight onto the display instead
+				WriteLog(stderr, "Unable to create back buffer %d!\n\tSDL Error: %s\n", index, SDL_GetError());
+
+				// return failure
+				return false;
+			}
+
+			SurfaceMemory::Track(buffers_[index], SURFACE_CATEGORY_SCREENS);
+
+			// whatever a frame does not draw over stays black, as the display starts out
+			SDL_FillRect(buffers_[index], 0, SDL_MapRGB(buffers_[index]->format, 0, 0, 0));
+		}
+
+		// return success
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Presenter::FreeBackBuffers()
+	{
+		for (int index = 0; index < PRESENTER_BACK_BUFFERS; index++)
+		{
+			if (buffers_[index])
+			{
+				SurfaceMemory::Untrack(buffers_[index]);
+				SDL_FreeSurface(buffers_[index]);
+				buffers_[index] = 0;
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Presenter::RecordLatency(Microseconds submitTime)
+	{
+		Microseconds latency = Clock::GetMicroseconds() - submitTime;
+
+		framesPresented_++;
+		totalLatency_ += latency;
+		maxLatency_ = std::max(maxLatency_, latency);
+	}
+
+} // end namespace
+
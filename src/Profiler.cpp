@@ -0,0 +1,297 @@
+
+// CODESTYLE: v2.0
+
+// Profiler.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: lightweight scoped timers for the engine's hot paths, with an on-screen overlay
+
+/**
+ * @file Profiler.cpp
+ * @brief Hot Path Profiler - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+	#define PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+	#define PROFILER_THREAD_LOCAL __thread
+#endif
+
+#if defined(_MSC_VER) || defined(__i386__) || defined(__x86_64__)
+	#define PROFILER_HAS_RDTSC
+#endif
+
+// how much of each new frame goes into the smoothed figures
+#define PROFILER_SMOOTHING 0.1
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	/// the running totals of one thread; only the owning thread writes ticks_ and calls_
+	struct ProfileThreadBuffer
+	{
+		volatile ProfileTicks ticks_[PROFILE_ZONE_COUNT];
+		volatile unsigned int calls_[PROFILE_ZONE_COUNT];
+
+		// the totals as of the last EndFrame(), only touched by the thread that calls EndFrame()
+		ProfileTicks lastTicks_[PROFILE_ZONE_COUNT];
+		unsigned int lastCalls_[PROFILE_ZONE_COUNT];
+
+		ProfileThreadBuffer* next_;
+	};
+
+	static bool profilerEnabled = false;
+	static bool profilerOverlay = false;
+	static bool profilerTracing = false;
+
+	// the timestamp and the monotonic clock read at the same moment, and the rate between them
+	static ProfileTicks calibrationTicks = 0;
+	static Microseconds calibrationClock = 0;
+	static double ticksPerMicrosecond = 0.0;
+
+	// every thread's buffer, newest first; buffers are only ever added, never removed
+	static ProfileThreadBuffer* volatile allThreadBuffers = 0;
+	static PROFILER_THREAD_LOCAL ProfileThreadBuffer* threadBuffer = 0;
+
+	// set while a thread draws the overlay, so its own text is not timed; the other threads keep recording
+	static PROFILER_THREAD_LOCAL bool threadSuppressed = false;
+
+	static double frameMicroseconds[PROFILE_ZONE_COUNT];
+	static double averageMicroseconds[PROFILE_ZONE_COUNT];
+	static unsigned int frameCalls[PROFILE_ZONE_COUNT];
+
+	static const char* zoneNames[PROFILE_ZONE_COUNT] =
+	{
+		"Frame",
+		"Input",
+		"Simulation",
+		"RenderMap",
+		"Font",
+		"MiniMap",
+		"Overlays",
+		"Flip",
+		"Loading",
+		"LoadArt",
+		"Decode",
+		"Convert"
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Profiler::SetEnabled(bool enabled)
+	{
+		if (enabled && ticksPerMicrosecond <= 0.0)
+		{
+			Profiler::Calibrate();
+		}
+
+		profilerOverlay = enabled;
+		profilerEnabled = profilerOverlay || profilerTracing;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Profiler::SetTracing(bool tracing)
+	{
+		if (tracing && ticksPerMicrosecond <= 0.0)
+		{
+			Profiler::Calibrate();
+		}
+
+		profilerTracing = tracing;
+		profilerEnabled = profilerOverlay || profilerTracing;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool Profiler::IsEnabled()
+	{
+		return profilerEnabled;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	ProfileTicks Profiler::ReadTimestamp()
+	{
+		#if defined(_MSC_VER)
+		return __rdtsc();
+		#elif defined(PROFILER_HAS_RDTSC)
+		unsigned int low, high;
+		__asm__ __volatile__("rdtsc" : "=a" (low), "=d" (high));
+		return (static_cast<ProfileTicks>(high) << 32) | low;
+		#else
+		return static_cast<ProfileTicks>(Clock::GetMicroseconds());
+		#endif
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Profiler::Record(ProfileZone zone, ProfileTicks start, ProfileTicks end)
+	{
+		if (threadSuppressed)
+		{
+			return;
+		}
+
+		if (profilerTracing)
+		{
+			Microseconds startTime = Profiler::ToMicroseconds(start);
+			TraceRecorder::Record(zoneNames[zone], startTime, Profiler::ToMicroseconds(end) - startTime);
+		}
+
+		if (!threadBuffer)
+		{
+			// first timing on this thread, so give it a buffer and publish it to EndFrame()
+			ProfileThreadBuffer* buffer = new ProfileThreadBuffer;
+			memset(buffer, 0, sizeof(ProfileThreadBuffer));
+
+			do
+			{
+				buffer->next_ = allThreadBuffers;
+			} while (!__sync_bool_compare_and_swap(&allThreadBuffers, buffer->next_, buffer));
+
+			threadBuffer = buffer;
+		}
+
+		threadBuffer->ticks_[zone] += end - start;
+		threadBuffer->calls_[zone]++;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Profiler::EndFrame()
+	{
+		ProfileTicks ticks[PROFILE_ZONE_COUNT];
+		unsigned int calls[PROFILE_ZONE_COUNT];
+
+		for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+		{
+			ticks[zone] = 0;
+			calls[zone] = 0;
+		}
+
+		// whatever was added to each thread's totals since last time happened this frame
+		for (ProfileThreadBuffer* buffer = allThreadBuffers; buffer; buffer = buffer->next_)
+		{
+			for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+			{
+				ProfileTicks totalTicks = buffer->ticks_[zone];
+				unsigned int totalCalls = buffer->calls_[zone];
+
+				ticks[zone] += totalTicks - buffer->lastTicks_[zone];
+				calls[zone] += totalCalls - buffer->lastCalls_[zone];
+
+				buffer->lastTicks_[zone] = totalTicks;
+				buffer->lastCalls_[zone] = totalCalls;
+			}
+		}
+
+		double microsecondsPerTick = (ticksPerMicrosecond > 0.0) ? (1.0 / ticksPerMicrosecond) : 0.0;
+
+		for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+		{
+			frameMicroseconds[zone] = static_cast<double>(ticks[zone]) * microsecondsPerTick;
+			frameCalls[zone] = calls[zone];
+
+			averageMicroseconds[zone] +=
+				(frameMicroseconds[zone] - averageMicroseconds[zone]) * PROFILER_SMOOTHING;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	double Profiler::GetFrameMicroseconds(ProfileZone zone)
+	{
+		return frameMicroseconds[zone];
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	double Profiler::GetAverageMicroseconds(ProfileZone zone)
+	{
+		return averageMicroseconds[zone];
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned int Profiler::GetFrameCalls(ProfileZone zone)
+	{
+		return frameCalls[zone];
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	const char* Profiler::GetZoneName(ProfileZone zone)
+	{
+		return zoneNames[zone];
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Profiler::DrawOverlay(BitmapFont* font, SDL_Surface* target, int x, int y)
+	{
+		if (!font || !target)
+		{
+			return;
+		}
+
+		// don't time the overlay's own text into the font zone
+		threadSuppressed = true;
+
+		int lineHeight = font->GetLetterHeight() + font->GetLetterSpacing();
+
+		SDL_Rect background;
+		background.x = x - 4;
+		background.y = y - 4;
+		background.w = 21 * (font->GetLetterWidth() + font->GetLetterSpacing()) + 8;
+		background.h = PROFILE_ZONE_LOADING * lineHeight + 8;
+		Engine::FillRect(target, &background, SDL_MapRGB(target->format, 0, 0, 0));
+
+		for (int zone = 0; zone < PROFILE_ZONE_LOADING; zone++)
+		{
+			font->Print(target, x, y + zone * lineHeight, "%-9s%6dus %3u",
+				zoneNames[zone],
+				static_cast<int>(averageMicroseconds[zone]),
+				frameCalls[zone]);
+		}
+
+		threadSuppressed = false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void Profiler::Calibrate()
+	{
+		#if defined(PROFILER_HAS_RDTSC)
+		// count the ticks over a short stretch of the monotonic clock
+		Microseconds clockStart = Clock::GetMicroseconds();
+		ProfileTicks ticksStart = Profiler::ReadTimestamp();
+
+		Clock::SleepUntil(clockStart + 20000);
+
+		Microseconds clockElapsed = Clock::GetMicroseconds() - clockStart;
+		ProfileTicks ticksElapsed = Profiler::ReadTimestamp() - ticksStart;
+
+		ticksPerMicrosecond = static_cast<double>(ticksElapsed) / static_cast<double>(clockElapsed);
+		calibrationTicks = ticksStart;
+		calibrationClock = clockStart;
+		#else
+		ticksPerMicrosecond = 1.0;
+		#endif
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	Microseconds Profiler::ToMicroseconds(ProfileTicks timestamp)
+	{
+		return calibrationClock + static_cast<Microseconds>(
+			static_cast<double>(static_cast<long long>(timestamp - calibrationTicks)) / ticksPerMicrosecond);
+	}
+
+} // end namespace
+
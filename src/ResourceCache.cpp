@@ -0,0 +1,328 @@
+
+// CODESTYLE: v2.0
+
+// ResourceCache.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: shares loaded image resources by path and frees them when the last user lets go
+
+/**
+ * @file ResourceCache.cpp
+ * @brief Resource Cache - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	/// a cached image
+	struct CachedImage
+	{
+		SDL_Surface* surface_;
+		int references_;
+	};
+
+	typedef std::map<std::string, CachedImage> CachedImageMap;
+
+	// the images by path, and the same images by surface so a release can find its entry
+	static CachedImageMap cachedImages;
+	static std::map<SDL_Surface*, CachedImageMap::iterator> cachedSurfaces;
+
+	static unsigned long cacheHits = 0;
+	static unsigned long cacheMisses = 0;
+	static unsigned long detachedImages = 0;
+
+	/// gets the number of bytes of pixel data in @a surface
+	static unsigned long GetSurfaceBytes(SDL_Surface* surface)
+	{
+		return static_cast<unsigned long>(surface->pitch) * static_cast<unsigned long>(surface->h);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* ResourceCache::Acquire(const char* filePath, ImageDecoder decoder, const void* decoderData)
+	{
+		SDL_Surface* surface = ResourceCache::AcquireCached(filePath);
+
+		if (!surface && decoder)
+		{
+			surface = ResourceCache::Insert(filePath, Engine::ConvertImageResource(decoder(filePath, decoderData)));
+		}
+		else if (!surface)
+		{
+			// skip the decoding and conversion when the pixel cache has the image from a previous run
+			surface = PixelCache::Load(filePath);
+
+			if (!surface)
+			{
+				surface = Engine::ConvertImageResource(Engine::DecodeImageResource(filePath));
+				PixelCache::Store(filePath, surface);
+			}
+
+			if (surface)
+			{
+				surface = ResourceCache::Insert(filePath, surface);
+			}
+		}
+
+		return surface;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* ResourceCache::AcquireCached(const char* filePath)
+	{
+		CachedImageMap::iterator iter = cachedImages.find(filePath);
+
+		if (iter == cachedImages.end())
+		{
+			return 0;
+		}
+
+		cacheHits++;
+		iter->second.references_++;
+
+		return iter->second.surface_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* ResourceCache::Insert(const char* filePath, SDL_Surface* surface)
+	{
+		if (!surface)
+		{
+			return 0;
+		}
+
+		CachedImageMap::iterator iter = cachedImages.find(filePath);
+
+		if (iter != cachedImages.end())
+		{
+			// somebody loaded the same file first, so share theirs
+			SDL_FreeSurface(surface);
+
+			cacheHits++;
+			iter->second.references_++;
+
+			return iter->second.surface_;
+		}
+
+		cacheMisses++;
+
+		CachedImage image;
+		image.surface_ 		= surface;
+		image.references_ 	= 1;
+
+		iter = cachedImages.insert(CachedImageMap::value_type(filePath, image)).first;
+		cachedSurfaces[surface] = iter;
+
+		SurfaceMemory::Track(surface, SURFACE_CATEGORY_IMAGES);
+
+		return surface;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void ResourceCache::AddReference(SDL_Surface* surface)
+	{
+		std::map<SDL_Surface*, CachedImageMap::iterator>::iterator iter = cachedSurfaces.find(surface);
+
+		if (iter != cachedSurfaces.end())
+		{
+			iter->second->second.references_++;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool ResourceCache::Release(SDL_Surface* surface)
+	{
+		std::map<SDL_Surface*, CachedImageMap::iterator>::iterator iter = cachedSurfaces.find(surface);
+
+		if (iter == cachedSurfaces.end())
+		{
+			return false;
+		}
+
+		CachedImageMap::iterator image = iter->second;
+
+		if (--image->second.references_ <= 0)
+		{
+			SurfaceMemory::Untrack(surface);
+			SDL_FreeSurface(surface);
+
+			cachedSurfaces.erase(iter);
+			cachedImages.erase(image);
+		}
+
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned int ResourceCache::Detach(const char* filePath)
+	{
+		std::string path(filePath);
+		
+		// the image itself, then the pieces cut from it, which are exactly the keys from "path#" up to "path$"
+		std::vector<CachedImageMap::iterator> images;
+		
+		CachedImageMap::iterator iter = cachedImages.find(path);
+		if (iter != cachedImages.end())
+		{
+			images.push_back(iter);
+		}
+		
+		CachedImageMap::iterator piecesEnd = cachedImages.lower_bound(path + "$");
+		for (iter = cachedImages.lower_bound(path + "#"); iter != piecesEnd; ++iter)
+		{
+			images.push_back(iter);
+		}
+		
+		// renamed only once they are all found; a name that starts "(detached" never sorts into another path's range
+		for (unsigned int index = 0; index < images.size(); index++)
+		{
+			// keep it under a name nothing will ask for, so its users can still release it
+			char detachedPath[0x220];
+			snprintf(detachedPath, sizeof(detachedPath), "(detached %lu) %s", ++detachedImages, images[index]->first.c_str());
+			
+			CachedImageMap::iterator renamed = cachedImages.insert(CachedImageMap::value_type(detachedPath, images[index]->second)).first;
+			cachedSurfaces[renamed->second.surface_] = renamed;
+			
+			cachedImages.erase(images[index]);
+		}
+		
+		return static_cast<unsigned int>(images.size());
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned int ResourceCache::GetImageCount()
+	{
+		return static_cast<unsigned int>(cachedImages.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned long ResourceCache::GetResidentBytes()
+	{
+		unsigned long bytes = 0;
+
+		for (CachedImageMap::iterator iter = cachedImages.begin(); iter != cachedImages.end(); iter++)
+		{
+			bytes += GetSurfaceBytes(iter->second.surface_);
+		}
+
+		return bytes;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void ResourceCache::WriteReport(FILE* fp, bool listImages)
+	{
+		WriteLog(fp, "ResourceCache: %u images, %lu bytes resident, %lu hits, %lu misses\n",
+			ResourceCache::GetImageCount(),
+			ResourceCache::GetResidentBytes(),
+			cacheHits,
+			cacheMisses);
+
+		for (CachedImageMap::iterator iter = cachedImages.begin(); listImages && iter != cachedImages.end(); iter++)
+		{
+			WriteLog(fp, "\t%-40s %3d refs %8lu bytes\n",
+				iter->first.c_str(),
+				iter->second.references_,
+				GetSurfaceBytes(iter->second.surface_));
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void ResourceCache::ReleaseAll()
+	{
+		for (CachedImageMap::iterator iter = cachedImages.begin(); iter != cachedImages.end(); iter++)
+		{
+			// log the leak
+			WriteLog(stderr, "ResourceCache: \"%s\" still had %d references at shutdown!\n",
+				iter->first.c_str(),
+				iter->second.references_);
+
+			SurfaceMemory::Untrack(iter->second.surface_);
+			SDL_FreeSurface(iter->second.surface_);
+		}
+
+		cachedSurfaces.clear();
+		cachedImages.clear();
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////
+
+	ImageHandle::ImageHandle() :
+		surface_(0)
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	ImageHandle::ImageHandle(const char* filePath) :
+		surface_(ResourceCache::Acquire(filePath))
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	ImageHandle::ImageHandle(const ImageHandle& rhs) :
+		surface_(rhs.surface_)
+	{
+		ResourceCache::AddReference(surface_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	ImageHandle& ImageHandle::operator=(const ImageHandle& rhs)
+	{
+		// take the new reference first so self-assignment is harmless
+		ResourceCache::AddReference(rhs.surface_);
+		this->Reset(rhs.surface_);
+
+		return *this;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	ImageHandle::~ImageHandle()
+	{
+		this->Reset();
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void ImageHandle::Reset(SDL_Surface* surface)
+	{
+		if (surface_)
+		{
+			Engine::UnloadImageResource(surface_);
+		}
+
+		surface_ = surface;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* ImageHandle::Get() const
+	{
+		return surface_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	ImageHandle::operator SDL_Surface*() const
+	{
+		return surface_;
+	}
+
+} // end namespace
+
@@ -0,0 +1,238 @@
+
+// CODESTYLE: v2.0
+
+// SurfaceMemory.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: accounts for the memory held by every surface the engine creates
+
+/**
+ * @file SurfaceMemory.cpp
+ * @brief Surface Memory Accounting - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	/// a tracked surface
+	struct TrackedSurface
+	{
+		SurfaceCategory category_;
+		unsigned long bytes_;
+	};
+
+	/// a registered evictor
+	struct RegisteredEvictor
+	{
+		SurfaceEvictor evictor_;
+		void* userData_;
+	};
+
+	static std::map<SDL_Surface*, TrackedSurface> trackedSurfaces;
+	static std::vector<RegisteredEvictor> evictors;
+
+	static unsigned long categoryBytes[SURFACE_CATEGORY_COUNT] = { 0 };
+	static unsigned long categoryHighWater[SURFACE_CATEGORY_COUNT] = { 0 };
+	static unsigned long totalBytes = 0;
+	static unsigned long totalHighWater = 0;
+	static unsigned long memoryBudget = 0;
+
+	// so a budget that cannot be met is only logged once until it is met again
+	static bool budgetWarningLogged = false;
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void SurfaceMemory::Track(SDL_Surface* surface, SurfaceCategory category)
+	{
+		if (!surface || category < 0 || category >= SURFACE_CATEGORY_COUNT)
+		{
+			return;
+		}
+
+		// tracking a surface twice just moves it to the new category
+		SurfaceMemory::Untrack(surface);
+
+		TrackedSurface tracked;
+		tracked.category_ 	= category;
+		tracked.bytes_ 		= static_cast<unsigned long>(surface->pitch) * static_cast<unsigned long>(surface->h);
+
+		trackedSurfaces[surface] = tracked;
+
+		categoryBytes[category] += tracked.bytes_;
+		totalBytes += tracked.bytes_;
+
+		if (categoryBytes[category] > categoryHighWater[category])
+		{
+			categoryHighWater[category] = categoryBytes[category];
+		}
+
+		if (totalBytes > totalHighWater)
+		{
+			totalHighWater = totalBytes;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void SurfaceMemory::Untrack(SDL_Surface* surface)
+	{
+		std::map<SDL_Surface*, TrackedSurface>::iterator iter = trackedSurfaces.find(surface);
+
+		if (iter == trackedSurfaces.end())
+		{
+			return;
+		}
+
+		categoryBytes[iter->second.category_] -= iter->second.bytes_;
+		totalBytes -= iter->second.bytes_;
+
+		trackedSurfaces.erase(iter);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned long SurfaceMemory::GetBytes(SurfaceCategory category)
+	{
+		return (category >= 0 && category < SURFACE_CATEGORY_COUNT) ? categoryBytes[category] : 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned long SurfaceMemory::GetHighWaterBytes(SurfaceCategory category)
+	{
+		return (category >= 0 && category < SURFACE_CATEGORY_COUNT) ? categoryHighWater[category] : 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned long SurfaceMemory::GetTotalBytes()
+	{
+		return totalBytes;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned long SurfaceMemory::GetTotalHighWaterBytes()
+	{
+		return totalHighWater;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void SurfaceMemory::SetBudget(unsigned long bytes)
+	{
+		memoryBudget = bytes;
+		budgetWarningLogged = false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned long SurfaceMemory::GetBudget()
+	{
+		return memoryBudget;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void SurfaceMemory::AddEvictor(SurfaceEvictor evictor, void* userData)
+	{
+		RegisteredEvictor registered;
+		registered.evictor_ 	= evictor;
+		registered.userData_ 	= userData;
+
+		evictors.push_back(registered);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void SurfaceMemory::RemoveEvictor(SurfaceEvictor evictor, void* userData)
+	{
+		for (unsigned int index = 0; index < evictors.size(); index++)
+		{
+			if (evictors[index].evictor_ == evictor && evictors[index].userData_ == userData)
+			{
+				evictors.erase(evictors.begin() + index);
+				return;
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool SurfaceMemory::EnforceBudget()
+	{
+		if (!memoryBudget || totalBytes <= memoryBudget)
+		{
+			budgetWarningLogged = false;
+			return true;
+		}
+
+		// keep asking the first evictor that still has something to give, until it fits or nobody does
+		bool evicted = true;
+		while (totalBytes > memoryBudget && evicted)
+		{
+			evicted = false;
+			for (unsigned int index = 0; index < evictors.size() && !evicted; index++)
+			{
+				evicted = evictors[index].evictor_(evictors[index].userData_);
+			}
+		}
+
+		if (totalBytes > memoryBudget && !budgetWarningLogged)
+		{
+			// log the warning
+			WriteLog(stderr, "SurfaceMemory: %lu bytes in use is over the budget of %lu bytes and nothing more can be evicted!\n",
+				totalBytes, memoryBudget);
+			budgetWarningLogged = true;
+		}
+
+		return totalBytes <= memoryBudget;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void SurfaceMemory::WriteReport(FILE* fp)
+	{
+		WriteLog(fp, "SurfaceMemory: %lu bytes in %u surfaces, %lu bytes at most",
+			totalBytes,
+			static_cast<unsigned int>(trackedSurfaces.size()),
+			totalHighWater);
+
+		if (memoryBudget)
+		{
+			WriteLog(fp, ", budget %lu bytes", memoryBudget);
+		}
+
+		WriteLog(fp, "\n");
+
+		for (int category = 0; category < SURFACE_CATEGORY_COUNT; category++)
+		{
+			WriteLog(fp, "\t%-8s %10lu bytes %10lu bytes at most\n",
+				SurfaceMemory::GetCategoryName(static_cast<SurfaceCategory>(category)),
+				categoryBytes[category],
+				categoryHighWater[category]);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	const char* SurfaceMemory::GetCategoryName(SurfaceCategory category)
+	{
+		switch (category)
+		{
+			case SURFACE_CATEGORY_IMAGES: 	return "images";
+			case SURFACE_CATEGORY_FONTS: 	return "fonts";
+			case SURFACE_CATEGORY_MINIMAP: 	return "minimap";
+			case SURFACE_CATEGORY_SCREENS: 	return "screens";
+			case SURFACE_CATEGORY_TEXT: 	return "text";
+			default: break;
+		}
+		return "unknown";
+	}
+
+} // end namespace
+
@@ -0,0 +1,248 @@
+
+// CODESTYLE: v2.0
+
+// TextCache.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: keeps rendered runs of text so unchanged lines are drawn with one blit
+
+/**
+ * @file TextCache.cpp
+ * @brief Text Run Cache - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	bool TextCache::TextRunKey::operator<(const TextRunKey& rhs) const
+	{
+		if (fontGeneration_ != rhs.fontGeneration_)
+		{
+			return fontGeneration_ < rhs.fontGeneration_;
+		}
+
+		if (hash_ != rhs.hash_)
+		{
+			return hash_ < rhs.hash_;
+		}
+
+		return length_ < rhs.length_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	TextCache::TextCache(unsigned int capacity) :
+		capacity_((capacity) ? capacity : 1),
+		hits_(0),
+		misses_(0)
+	{
+		SurfaceMemory::AddEvictor(TextCache::EvictForSurfaceBudget, this);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	TextCache::~TextCache()
+	{
+		SurfaceMemory::RemoveEvictor(TextCache::EvictForSurfaceBudget, this);
+
+		this->Clear();
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TextCache::Print(BitmapFont* font, SDL_Surface* destination, int x, int y, const char* text)
+	{
+		if (text)
+		{
+			this->Print(font, destination, x, y, text, strlen(text));
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TextCache::Print(BitmapFont* font, SDL_Surface* destination, int x, int y, const char* text, unsigned int length)
+	{
+		if (!font || !font->GetFontImage() || !destination || !text || !length)
+		{
+			return;
+		}
+
+		TextRunKey key;
+		key.fontGeneration_ 	= font->GetGeneration();
+		key.hash_ 				= TextCache::HashText(text, length);
+		key.length_ 			= length;
+
+		std::map<TextRunKey, TextRunList::iterator>::iterator found = runsByKey_.find(key);
+
+		if (found != runsByKey_.end())
+		{
+			TextRun& run = *found->second;
+
+			if (0 == run.text_.compare(0, std::string::npos, text, length))
+			{
+				hits_++;
+			}
+			else
+			{
+				// two strings with the same hash; the newer one takes the run over
+				misses_++;
+
+				if (run.surface_)
+				{
+					SurfaceMemory::Untrack(run.surface_);
+					SDL_FreeSurface(run.surface_);
+				}
+
+				run.text_.assign(text, length);
+				run.surface_ = TextCache::RenderRun(font, destination, text, length);
+			}
+
+			// move it to the front of the list
+			runs_.splice(runs_.begin(), runs_, found->second);
+		}
+		else
+		{
+			misses_++;
+
+			TextRun run;
+			run.key_ 		= key;
+			run.surface_ 	= 0;
+
+			runs_.push_front(run);
+			runs_.front().text_.assign(text, length);
+			runs_.front().surface_ = TextCache::RenderRun(font, destination, text, length);
+			runsByKey_[key] = runs_.begin();
+
+			while (runs_.size() > capacity_)
+			{
+				this->EvictOldestRun();
+			}
+		}
+
+		// a run with nothing visible in it has no surface, and nothing to draw
+		if (runs_.front().surface_)
+		{
+			Engine::BlitSprite(runs_.front().surface_, destination, x, y);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TextCache::Clear()
+	{
+		while (this->EvictOldestRun())
+		{
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned int TextCache::GetRunCount() const
+	{
+		return static_cast<unsigned int>(runs_.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TextCache::WriteReport(FILE* fp) const
+	{
+		WriteLog(fp, "TextCache: %u runs of text, %u hits, %u misses\n",
+			static_cast<unsigned int>(runs_.size()), hits_, misses_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* TextCache::RenderRun(BitmapFont* font, SDL_Surface* destination, const char* text, unsigned int length)
+	{
+		int width = 0;
+		int height = 0;
+		font->MeasureText(text, length, &width, &height);
+
+		if (width <= 0 || height <= 0)
+		{
+			return 0;
+		}
+
+		const SDL_PixelFormat* format = destination->format;
+
+		SDL_Surface* surface = SDL_CreateRGBSurface(
+			SDL_SWSURFACE,
+			width, height,
+			format->BitsPerPixel,
+			format->Rmask, format->Gmask, format->Bmask, format->Amask);
+
+		if (!surface)
+		{
+			// log the error
+			WriteLog(stderr, "Unable to create a surface for the text \"%.*s\"!\n\tSDL Error: %s\n",
+				static_cast<int>(length), text, SDL_GetError());
+
+			// return failure
+			return 0;
+		}
+
+		SurfaceMemory::Track(surface, SURFACE_CATEGORY_TEXT);
+
+		// the same transparent color the fonts use
+		Uint32 colorKey = SDL_MapRGB(surface->format, 255, 0, 255);
+		SDL_FillRect(surface, 0, colorKey);
+
+		font->PrintText(surface, 0, 0, text, length);
+
+		SDL_SetColorKey(surface, (SDL_SRCCOLORKEY|SDL_RLEACCEL), colorKey);
+
+		return surface;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned int TextCache::HashText(const char* text, unsigned int length)
+	{
+		// FNV-1a
+		unsigned int hash = 2166136261u;
+
+		for (unsigned int index = 0; index < length; index++)
+		{
+			hash ^= static_cast<unsigned char>(text[index]);
+			hash *= 16777619u;
+		}
+
+		return hash;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool TextCache::EvictOldestRun()
+	{
+		if (runs_.empty())
+		{
+			return false;
+		}
+
+		TextRun& oldest = runs_.back();
+
+		if (oldest.surface_)
+		{
+			SurfaceMemory::Untrack(oldest.surface_);
+			SDL_FreeSurface(oldest.surface_);
+		}
+
+		runsByKey_.erase(oldest.key_);
+		runs_.pop_back();
+
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool TextCache::EvictForSurfaceBudget(void* userData)
+	{
+		return static_cast<TextCache*>(userData)->EvictOldestRun();
+	}
+
+} // end namespace
+
@@ -0,0 +1,161 @@
+
+// CODESTYLE: v2.0
+
+// TextFormatter.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: builds short lines of text in a fixed buffer without a format string
+
+/**
+ * @file TextFormatter.cpp
+ * @brief Text Formatter - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	TextFormatter::TextFormatter() :
+		length_(0)
+	{
+		text_[0] = 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	TextFormatter& TextFormatter::Clear()
+	{
+		length_ = 0;
+		text_[0] = 0;
+		return *this;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	TextFormatter& TextFormatter::operator<<(const char* text)
+	{
+		if (text)
+		{
+			while (*text && length_ < TEXTFORMATTER_CAPACITY - 1)
+			{
+				text_[length_++] = *text++;
+			}
+			text_[length_] = 0;
+		}
+		return *this;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	TextFormatter& TextFormatter::operator<<(char letter)
+	{
+		if (length_ < TEXTFORMATTER_CAPACITY - 1)
+		{
+			text_[length_++] = letter;
+			text_[length_] = 0;
+		}
+		return *this;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	TextFormatter& TextFormatter::operator<<(int value)
+	{
+		return *this << Padded(value, 0);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	TextFormatter& TextFormatter::operator<<(unsigned int value)
+	{
+		this->AppendNumber(value, false, 0);
+		return *this;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	TextFormatter& TextFormatter::operator<<(const PaddedNumber& number)
+	{
+		// negated as unsigned so the most negative int has a magnitude too
+		bool negative = number.value_ < 0;
+		unsigned int magnitude = static_cast<unsigned int>(number.value_);
+		if (negative)
+		{
+			magnitude = 0u - magnitude;
+		}
+
+		this->AppendNumber(magnitude, negative, number.width_);
+		return *this;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	TextFormatter& TextFormatter::operator<<(const DirectionName& direction)
+	{
+		return *this << TextFormatter::GetDirectionName(direction.facing_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	const char* TextFormatter::GetText() const
+	{
+		return text_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned int TextFormatter::GetLength() const
+	{
+		return length_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	const char* TextFormatter::GetDirectionName(int facing)
+	{
+		switch(facing)
+		{
+			case 0x0: return "North";
+			case 0x1: return "East";
+			case 0x2: return "South";
+			case 0x3: return "West";
+			default: break;
+		}
+		return "<Invalid Direction>";
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TextFormatter::AppendNumber(unsigned int magnitude, bool negative, int width)
+	{
+		// the digits come out backwards, so they are gathered first; 10 digits and a sign at most
+		char digits[0x10];
+		int digitCount = 0;
+
+		do
+		{
+			digits[digitCount++] = static_cast<char>('0' + (magnitude % 10));
+			magnitude /= 10;
+		} while (magnitude);
+
+		if (negative)
+		{
+			digits[digitCount++] = '-';
+		}
+
+		for (int padding = width - digitCount; padding > 0; padding--)
+		{
+			*this << ' ';
+		}
+
+		while (digitCount)
+		{
+			*this << digits[--digitCount];
+		}
+	}
+
+} // end namespace
+
@@ -0,0 +1,243 @@
+
+// CODESTYLE: v2.0
+
+// TextLayout.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: measures, wraps and aligns text once so it can be drawn again cheaply
+
+/**
+ * @file TextLayout.cpp
+ * @brief Text Layout - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	TextLayout::TextLayout() :
+		font_(0),
+		width_(0),
+		height_(0)
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TextLayout::Layout(BitmapFont* font, const char* text, int wrapWidth, TextAlignment alignment)
+	{
+		font_ = font;
+		text_ = (text) ? text : "";
+		lines_.clear();
+		width_ = 0;
+		height_ = 0;
+
+		if (!font_ || text_.empty())
+		{
+			return;
+		}
+
+		int letterWidth = font_->GetLetterWidth();
+		int advance = letterWidth + font_->GetLetterSpacing();
+		int tabWidth = font_->GetTabWidth();
+
+		unsigned int textLength = text_.size();
+		unsigned int index = 0;
+
+		do
+		{
+			// each paragraph ends at a new line or the end of the text
+			std::string::size_type newLine = text_.find('\n', index);
+			unsigned int paragraphEnd = (std::string::npos == newLine) ? textLength : static_cast<unsigned int>(newLine);
+
+			if (index == paragraphEnd)
+			{
+				this->AddLine(index, index, 0);
+			}
+
+			while (index < paragraphEnd)
+			{
+				unsigned int lineStart = index;
+				unsigned int scan = index;
+				int cursorX = 0;
+				int lineWidth = 0;
+
+				// the last space the line could be broken at, and the width of the line before it
+				bool canBreak = false;
+				unsigned int breakAt = 0;
+				int widthAtBreak = 0;
+
+				for (; scan < paragraphEnd; scan++)
+				{
+					if ('\t' == text_[scan])
+					{
+						cursorX += tabWidth;
+						continue;
+					}
+
+					int right = cursorX + letterWidth;
+					if (wrapWidth > 0 && right > wrapWidth && scan > lineStart)
+					{
+						break;
+					}
+
+					// a run of spaces is broken at its first, so the line does not end in spaces
+					if (' ' == text_[scan] && (scan == lineStart || ' ' != text_[scan - 1]))
+					{
+						canBreak = true;
+						breakAt = scan;
+						widthAtBreak = lineWidth;
+					}
+
+					lineWidth = right;
+					cursorX += advance;
+				}
+
+				if (scan < paragraphEnd && canBreak && breakAt > lineStart)
+				{
+					this->AddLine(lineStart, breakAt, widthAtBreak);
+					index = breakAt;
+				}
+				else
+				{
+					this->AddLine(lineStart, scan, lineWidth);
+					index = scan;
+				}
+
+				// the spaces a line was broken at are not carried onto the next
+				while (index < paragraphEnd && ' ' == text_[index])
+				{
+					index++;
+				}
+			}
+
+			// step over the new line
+			index = paragraphEnd + 1;
+		} while (index <= textLength);
+
+		// now the widest line is known, the lines can be placed
+		int boxWidth = (wrapWidth > 0) ? wrapWidth : width_;
+		int lineHeight = font_->GetLetterHeight() + font_->GetLetterSpacing();
+
+		for (unsigned int line = 0; line < lines_.size(); line++)
+		{
+			TextLine& textLine = lines_[line];
+
+			textLine.y_ = line * lineHeight;
+			textLine.x_ =
+				(TEXT_ALIGN_CENTER == alignment) ? (boxWidth - textLine.width_) / 2 :
+				(TEXT_ALIGN_RIGHT == alignment) ? boxWidth - textLine.width_ : 0;
+		}
+
+		height_ = (static_cast<int>(lines_.size()) * lineHeight) - font_->GetLetterSpacing();
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TextLayout::Draw(SDL_Surface* destination, int x, int y, TextCache* textCache, const SDL_Rect* clip) const
+	{
+		if (!font_ || !destination)
+		{
+			return;
+		}
+
+		// narrow the clip rect for the drawing, and put it back after
+		SDL_Rect previousClip;
+		SDL_GetClipRect(destination, &previousClip);
+
+		if (clip)
+		{
+			int left 	= std::max<int>(previousClip.x, clip->x);
+			int top 	= std::max<int>(previousClip.y, clip->y);
+			int right 	= std::min<int>(previousClip.x + previousClip.w, clip->x + clip->w);
+			int bottom 	= std::min<int>(previousClip.y + previousClip.h, clip->y + clip->h);
+
+			if (right <= left || bottom <= top)
+			{
+				return;
+			}
+
+			SDL_Rect drawClip;
+			drawClip.x = left;
+			drawClip.y = top;
+			drawClip.w = right - left;
+			drawClip.h = bottom - top;
+			SDL_SetClipRect(destination, &drawClip);
+		}
+
+		for (unsigned int line = 0; line < lines_.size(); line++)
+		{
+			const TextLine& textLine = lines_[line];
+
+			if (!textLine.length_)
+			{
+				continue;
+			}
+
+			const char* lineText = text_.c_str() + textLine.start_;
+
+			if (textCache)
+			{
+				textCache->Print(font_, destination, x + textLine.x_, y + textLine.y_, lineText, textLine.length_);
+			}
+			else
+			{
+				font_->PrintText(destination, x + textLine.x_, y + textLine.y_, lineText, textLine.length_);
+			}
+		}
+
+		if (clip)
+		{
+			SDL_SetClipRect(destination, &previousClip);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	int TextLayout::GetWidth() const
+	{
+		return width_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	int TextLayout::GetHeight() const
+	{
+		return height_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned int TextLayout::GetLineCount() const
+	{
+		return static_cast<unsigned int>(lines_.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	const char* TextLayout::GetText() const
+	{
+		return text_.c_str();
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TextLayout::AddLine(unsigned int start, unsigned int end, int width)
+	{
+		TextLine line;
+		line.start_ 	= start;
+		line.length_ 	= end - start;
+		line.x_ 		= 0;
+		line.y_ 		= 0;
+		line.width_ 	= width;
+
+		lines_.push_back(line);
+
+		width_ = std::max(width_, width);
+	}
+
+} // end namespace
+
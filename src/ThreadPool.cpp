@@ -0,0 +1,210 @@
+
+// CODESTYLE: v2.0
+
+// ThreadPool.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: a fixed set of worker threads that run queued jobs
+
+/**
+ * @file ThreadPool.cpp
+ * @brief Thread Pool - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <unistd.h>
+#endif
+
+// the most workers a pool starts when asked to size itself
+#define THREADPOOL_MAX_AUTO_THREADS 8
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	ThreadPool::ThreadPool(int threadCount) :
+		pendingJobs_(0),
+		stopping_(false)
+	{
+		lock_ 			= SDL_CreateMutex();
+		jobAvailable_ 	= SDL_CreateCond();
+		allJobsDone_ 	= SDL_CreateCond();
+		jobDone_ 		= SDL_CreateCond();
+
+		if (threadCount < 0)
+		{
+			// leave a processor for the main thread
+			threadCount = ThreadPool::GetProcessorCount() - 1;
+
+			if (threadCount < 1)
+			{
+				threadCount = 1;
+			}
+			else if (threadCount > THREADPOOL_MAX_AUTO_THREADS)
+			{
+				threadCount = THREADPOOL_MAX_AUTO_THREADS;
+			}
+		}
+
+		for (int index = 0; index < threadCount; index++)
+		{
+			SDL_Thread* worker = SDL_CreateThread(ThreadPool::WorkerThread, this);
+			if (!worker)
+			{
+				// log the error, the pool still works with however many workers it has
+				WriteLog(stderr, "Unable to create a thread pool worker!\n\tSDL Error: %s\n", SDL_GetError());
+				break;
+			}
+			workers_.push_back(worker);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	ThreadPool::~ThreadPool()
+	{
+		this->WaitAll();
+
+		SDL_LockMutex(lock_);
+		stopping_ = true;
+		SDL_CondBroadcast(jobAvailable_);
+		SDL_UnlockMutex(lock_);
+
+		for (unsigned int index = 0; index < workers_.size(); index++)
+		{
+			SDL_WaitThread(workers_[index], 0);
+		}
+		workers_.clear();
+
+		SDL_DestroyCond(jobDone_);
+		SDL_DestroyCond(allJobsDone_);
+		SDL_DestroyCond(jobAvailable_);
+		SDL_DestroyMutex(lock_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void ThreadPool::Submit(ThreadPoolJob job, void* userData)
+	{
+		if (!job)
+		{
+			return;
+		}
+
+		// with no workers the job runs right here
+		if (workers_.empty())
+		{
+			job(userData);
+			return;
+		}
+
+		Job queued;
+		queued.job_ 		= job;
+		queued.userData_ 	= userData;
+
+		SDL_LockMutex(lock_);
+		jobs_.push_back(queued);
+		pendingJobs_++;
+		SDL_CondSignal(jobAvailable_);
+		SDL_UnlockMutex(lock_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void ThreadPool::WaitAll()
+	{
+		SDL_LockMutex(lock_);
+		while (pendingJobs_ > 0)
+		{
+			SDL_CondWait(allJobsDone_, lock_);
+		}
+		SDL_UnlockMutex(lock_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void ThreadPool::WaitFor(volatile int* pendingCount)
+	{
+		// the count is dropped before the worker takes the lock to signal, so a wake up can't be missed
+		SDL_LockMutex(lock_);
+		while (*pendingCount > 0)
+		{
+			SDL_CondWait(jobDone_, lock_);
+		}
+		SDL_UnlockMutex(lock_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	int ThreadPool::GetThreadCount() const
+	{
+		return static_cast<int>(workers_.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	int ThreadPool::GetProcessorCount()
+	{
+		#if defined(_WIN32)
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+		int processors = static_cast<int>(systemInfo.dwNumberOfProcessors);
+		#elif defined(_SC_NPROCESSORS_ONLN)
+		int processors = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+		#else
+		int processors = 1;
+		#endif
+
+		return (processors > 0) ? processors : 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	int ThreadPool::WorkerThread(void* userData)
+	{
+		ThreadPool* pool = static_cast<ThreadPool*>(userData);
+
+		SDL_LockMutex(pool->lock_);
+
+		for (;;)
+		{
+			while (pool->jobs_.empty() && !pool->stopping_)
+			{
+				SDL_CondWait(pool->jobAvailable_, pool->lock_);
+			}
+
+			if (pool->jobs_.empty())
+			{
+				// stopping and nothing left to do
+				break;
+			}
+
+			Job job = pool->jobs_.front();
+			pool->jobs_.pop_front();
+
+			// run the job without holding the lock
+			SDL_UnlockMutex(pool->lock_);
+			job.job_(job.userData_);
+			SDL_LockMutex(pool->lock_);
+
+			pool->pendingJobs_--;
+			SDL_CondBroadcast(pool->jobDone_);
+
+			if (0 == pool->pendingJobs_)
+			{
+				SDL_CondBroadcast(pool->allJobsDone_);
+			}
+		}
+
+		SDL_UnlockMutex(pool->lock_);
+
+		return 0;
+	}
+
+} // end namespace
+
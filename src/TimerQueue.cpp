@@ -0,0 +1,117 @@
+
+// CODESTYLE: v2.0
+
+// TimerQueue.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: schedules delayed actions against the engine's simulation clock
+
+/**
+ * @file TimerQueue.cpp
+ * @brief Timer Queue - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	TimerQueue::TimerQueue() :
+		now_(0),
+		nextID_(1)
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	TimerQueue::~TimerQueue()
+	{
+		this->Clear();
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	TimerID TimerQueue::Schedule(Microseconds delay, TimerCallback callback, void* userData)
+	{
+		if (!callback)
+		{
+			return 0;
+		}
+
+		Timer timer;
+		timer.due_ 		= now_ + ((delay < 0) ? 0 : delay);
+		timer.id_ 		= nextID_++;
+		timer.callback_ = callback;
+		timer.userData_ = userData;
+
+		// skip the invalid id when the counter wraps around
+		if (0 == nextID_)
+		{
+			nextID_ = 1;
+		}
+
+		timers_.push_back(timer);
+		std::push_heap(timers_.begin(), timers_.end(), TimerQueue::FiresLater);
+
+		return timer.id_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool TimerQueue::Cancel(TimerID timerID)
+	{
+		for (unsigned int index = 0; index < timers_.size(); index++)
+		{
+			if (timerID == timers_[index].id_)
+			{
+				timers_.erase(timers_.begin() + index);
+				std::make_heap(timers_.begin(), timers_.end(), TimerQueue::FiresLater);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TimerQueue::Advance(Microseconds elapsed)
+	{
+		now_ += elapsed;
+
+		while (!timers_.empty() && timers_.front().due_ <= now_)
+		{
+			// take the timer off the heap before firing it, so the callback is free to schedule more
+			Timer timer = timers_.front();
+			std::pop_heap(timers_.begin(), timers_.end(), TimerQueue::FiresLater);
+			timers_.pop_back();
+
+			timer.callback_(timer.userData_);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TimerQueue::Clear()
+	{
+		timers_.clear();
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	Microseconds TimerQueue::GetTime() const
+	{
+		return now_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool TimerQueue::FiresLater(const Timer& lhs, const Timer& rhs)
+	{
+		return (lhs.due_ != rhs.due_) ? (lhs.due_ > rhs.due_) : (lhs.id_ > rhs.id_);
+	}
+
+} // end namespace
+
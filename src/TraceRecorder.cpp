@@ -0,0 +1,234 @@
+
+// CODESTYLE: v2.0
+
+// TraceRecorder.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: records the profiler's timed scopes to a Chrome trace_event JSON file
+
+/**
+ * @file TraceRecorder.cpp
+ * @brief Trace Recorder - Implementation
+ * @author Richard Marks <ccpsceo@gmail.com>
+ */
+
+#include "lwc.h"
+
+// how often the writer thread wakes up to drain the ring (milliseconds)
+#define TRACE_FLUSH_INTERVAL 50
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace LOFI
+{
+	/// one slot of the ring buffer; sequence_ is index + 1 once the slot for that index is filled in
+	struct TraceEvent
+	{
+		const char* name_;
+		Microseconds start_;
+		Microseconds duration_;
+		Uint32 threadID_;
+		volatile unsigned long sequence_;
+	};
+
+	// the ring is allocated on the first Start() and kept, so a late Record() never touches freed memory
+	static TraceEvent* traceRing = 0;
+	static volatile unsigned long traceWriteIndex = 0;
+	static volatile unsigned long traceReadIndex = 0;
+	static volatile unsigned long traceDroppedEvents = 0;
+
+	static volatile bool traceRecording = false;
+	static volatile bool traceWriterRunning = false;
+	static SDL_Thread* traceWriter = 0;
+	static FILE* traceFile = 0;
+	static bool traceFirstEvent = true;
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool TraceRecorder::Start(const char* filePath)
+	{
+		if (traceRecording)
+		{
+			TraceRecorder::Stop();
+		}
+
+		traceFile = fopen(filePath, "w");
+		if (!traceFile)
+		{
+			// log the error
+			WriteLog(stderr, "Unable to open trace file \"%s\" for writing!\n", filePath);
+
+			// return failure
+			return false;
+		}
+
+		if (!traceRing)
+		{
+			traceRing = new TraceEvent [TRACE_RING_CAPACITY];
+		}
+
+		// start every slot out as not-ready for the indices we are about to hand out
+		for (unsigned int index = 0; index < TRACE_RING_CAPACITY; index++)
+		{
+			traceRing[index].sequence_ = 0;
+		}
+
+		traceWriteIndex 	= 0;
+		traceReadIndex 		= 0;
+		traceDroppedEvents 	= 0;
+		traceFirstEvent 	= true;
+
+		fprintf(traceFile, "{\"traceEvents\":[\n");
+
+		traceWriterRunning = true;
+		traceWriter = SDL_CreateThread(TraceRecorder::WriterThread, 0);
+		if (!traceWriter)
+		{
+			// log the error
+			WriteLog(stderr, "Unable to create the trace writer thread!\n\tSDL Error: %s\n", SDL_GetError());
+
+			traceWriterRunning = false;
+			fclose(traceFile);
+			traceFile = 0;
+
+			// return failure
+			return false;
+		}
+
+		traceRecording = true;
+		Profiler::SetTracing(true);
+
+		WriteLog(stderr, "Recording trace to \"%s\".\n", filePath);
+
+		// return success
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TraceRecorder::Stop()
+	{
+		if (!traceRecording)
+		{
+			return;
+		}
+
+		Profiler::SetTracing(false);
+		traceRecording = false;
+
+		// let the writer finish up, then pick up anything that was pushed after its last pass
+		traceWriterRunning = false;
+		SDL_WaitThread(traceWriter, 0);
+		traceWriter = 0;
+
+		TraceRecorder::Drain();
+
+		fprintf(traceFile, "\n],\n\"displayTimeUnit\":\"ms\",\n\"otherData\":{\"droppedEvents\":%lu}}\n", traceDroppedEvents);
+		fclose(traceFile);
+		traceFile = 0;
+
+		if (traceDroppedEvents)
+		{
+			WriteLog(stderr, "The trace dropped %lu events because the writer fell behind!\n", traceDroppedEvents);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	bool TraceRecorder::IsRecording()
+	{
+		return traceRecording;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TraceRecorder::Record(const char* name, Microseconds start, Microseconds duration)
+	{
+		if (!traceRecording)
+		{
+			return;
+		}
+
+		// claim the next index, unless the writer is a whole ring behind
+		unsigned long index;
+		do
+		{
+			index = traceWriteIndex;
+
+			if (index - traceReadIndex >= TRACE_RING_CAPACITY)
+			{
+				__sync_fetch_and_add(&traceDroppedEvents, 1);
+				return;
+			}
+		} while (!__sync_bool_compare_and_swap(&traceWriteIndex, index, index + 1));
+
+		TraceEvent& event = traceRing[index % TRACE_RING_CAPACITY];
+		event.name_ 	= name;
+		event.start_ 	= start;
+		event.duration_ = duration;
+		event.threadID_ = SDL_ThreadID();
+
+		// publish the slot only once everything else in it is visible
+		__sync_synchronize();
+		event.sequence_ = index + 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned long TraceRecorder::GetDroppedEventCount()
+	{
+		return traceDroppedEvents;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	int TraceRecorder::WriterThread(void* userData)
+	{
+		while (traceWriterRunning)
+		{
+			TraceRecorder::Drain();
+			SDL_Delay(TRACE_FLUSH_INTERVAL);
+		}
+
+		return 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+
+	void TraceRecorder::Drain()
+	{
+		unsigned long index = traceReadIndex;
+
+		for (;;)
+		{
+			TraceEvent& slot = traceRing[index % TRACE_RING_CAPACITY];
+
+			// stop at the first slot that has not been filled in yet
+			if (slot.sequence_ != index + 1)
+			{
+				break;
+			}
+
+			__sync_synchronize();
+			TraceEvent event = slot;
+
+			// hand the slot back to the producers before doing the slow part
+			index++;
+			__sync_synchronize();
+			traceReadIndex = index;
+
+			fprintf(traceFile, "%s{\"name\":\"%s\",\"cat\":\"engine\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%u}",
+				(traceFirstEvent) ? "" : ",\n",
+				event.name_,
+				static_cast<long long>(event.start_),
+				static_cast<long long>(event.duration_),
+				static_cast<unsigned int>(event.threadID_));
+
+			traceFirstEvent = false;
+		}
+
+		fflush(traceFile);
+	}
+
+} // end namespace
+
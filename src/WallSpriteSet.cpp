@@ -18,43 +18,153 @@
 
 namespace LOFI
 {
-	WallSpriteSet::WallSpriteSet(const char* rootPath)
+	/// the pixel value of a sheet pixel the wall does not cover; black is the transparent color key
+	static const Uint32 GENERATED_TRANSPARENT = 0x000000;
+	
+	/// what an opaque black texel is drawn as, so it does not turn transparent
+	static const Uint32 GENERATED_NEAR_BLACK = 0x080808;
+	
+	/// reads the texel at @a u, @a v (0 to 1) of the locked @a texture as a 0xRRGGBB sheet pixel
+	static Uint32 SampleTexture(SDL_Surface* texture, float u, float v)
+	{
+		int x = static_cast<int>(u * static_cast<float>(texture->w));
+		int y = static_cast<int>(v * static_cast<float>(texture->h));
+		x = (x < 0) ? 0 : (x >= texture->w) ? texture->w - 1 : x;
+		y = (y < 0) ? 0 : (y >= texture->h) ? texture->h - 1 : y;
+		
+		const SDL_PixelFormat* format = texture->format;
+		const Uint8* texel = static_cast<const Uint8*>(texture->pixels) + y * texture->pitch + x * format->BytesPerPixel;
+		
+		Uint32 pixel = 0;
+		switch (format->BytesPerPixel)
+		{
+			case 1: pixel = *texel; break;
+			case 2: pixel = *reinterpret_cast<const Uint16*>(texel); break;
+			case 3:
+				#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+				pixel = (texel[0] << 16) | (texel[1] << 8) | texel[2];
+				#else
+				pixel = texel[0] | (texel[1] << 8) | (texel[2] << 16);
+				#endif
+				break;
+			default: pixel = *reinterpret_cast<const Uint32*>(texel); break;
+		}
+		
+		Uint8 red, green, blue, alpha;
+		SDL_GetRGBA(pixel, const_cast<SDL_PixelFormat*>(format), &red, &green, &blue, &alpha);
+		
+		// the decoder keys black out, and anything mostly see-through goes the same way
+		if (alpha < 0x80 || (0 == red && 0 == green && 0 == blue))
+		{
+			return GENERATED_TRANSPARENT;
+		}
+		
+		Uint32 color = (red << 16) | (green << 8) | blue;
+		return (color < GENERATED_NEAR_BLACK) ? GENERATED_NEAR_BLACK : color;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	/// scales the whole locked @a texture into @a rect of the 32 bit @a sheet, for a wall seen face on
+	static void WarpFrontImage(SDL_Surface* sheet, SDL_Surface* texture, const WallImageRect& rect)
 	{
-		visibleDepth_ 	= 0x3;
-		frontImages_ 	= new SDL_Surface* [visibleDepth_];
-		leftImages_ 	= new SDL_Surface* [visibleDepth_];
-		rightImages_ 	= new SDL_Surface* [visibleDepth_];
+		for (int row = 0; row < rect.h_; row++)
+		{
+			Uint32* pixels = reinterpret_cast<Uint32*>(static_cast<Uint8*>(sheet->pixels) + (rect.y_ + row) * sheet->pitch) + rect.x_;
+			float v = (static_cast<float>(row) + 0.5f) / static_cast<float>(rect.h_);
+			
+			for (int column = 0; column < rect.w_; column++)
+			{
+				float u = (static_cast<float>(column) + 0.5f) / static_cast<float>(rect.w_);
+				pixels[column] = SampleTexture(texture, u, v);
+			}
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * @brief warps the whole locked @a texture into @a rect of the 32 bit @a sheet, for a wall running away from the viewer
+	 * @note the near edge spans the rect's full height, the far edge spans @a farHeight, and both are centred
+	 */
+	static void WarpSideImage(SDL_Surface* sheet, SDL_Surface* texture, const WallImageRect& rect, int farHeight, bool nearEdgeOnLeft)
+	{
+		float nearHeight = static_cast<float>(rect.h_);
+		float farEdgeHeight = static_cast<float>(farHeight);
 		
+		for (int column = 0; column < rect.w_; column++)
+		{
+			// how far along the wall this column is on screen, from the near edge
+			float t = (static_cast<float>((nearEdgeOnLeft) ? column : rect.w_ - 1 - column) + 0.5f) / static_cast<float>(rect.w_);
+			
+			// the wall's height on screen is inversely proportional to its depth, and the texture is spread evenly in depth
+			float columnHeight = nearHeight + (farEdgeHeight - nearHeight) * t;
+			float u = (t * farEdgeHeight) / ((1.0f - t) * nearHeight + t * farEdgeHeight);
+			
+			float top = 0.5f * (nearHeight - columnHeight);
+			
+			for (int row = 0; row < rect.h_; row++)
+			{
+				Uint32* pixel = reinterpret_cast<Uint32*>(static_cast<Uint8*>(sheet->pixels) + (rect.y_ + row) * sheet->pitch) + rect.x_ + column;
+				float v = (static_cast<float>(row) + 0.5f - top) / columnHeight;
+				
+				*pixel = (v < 0.0f || v >= 1.0f) ? GENERATED_TRANSPARENT : SampleTexture(texture, u, v);
+			}
+		}
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	
+	WallSpriteSet::WallSpriteSet(const WallSetDefinition& definition, AssetLoader* assetLoader) :
+		definition_(definition)
+	{
+		visibleDepth_ 	= definition.visibleDepth_;
+		frontImages_ 	= new ImageHandle [visibleDepth_];
+		leftImages_ 	= new ImageHandle [visibleDepth_];
+		rightImages_ 	= new ImageHandle [visibleDepth_];
+		
+		if (definition_.IsAtlas() || definition_.IsGenerated())
+		{
+			// the images can only be cut once the sheet is converted
+			std::string sheetPath = definition_.GetSheetPath();
+			ImageDecoder decoder = (definition_.IsGenerated()) ? WallSpriteSet::GenerateSheet : 0;
+			
+			if (assetLoader)
+			{
+				assetLoader->Request(sheetPath.c_str(), &sheet_, decoder, &definition_);
+			}
+			else
+			{
+				sheet_.Reset(ResourceCache::Acquire(sheetPath.c_str(), decoder, &definition_));
+				this->FinishLoading();
+			}
+			return;
+		}
+		
+		const char* rootPath = definition.rootPath_.c_str();
+		
+		#define _TMP_LOADIMG(image) if (assetLoader) { assetLoader->Request(buffer, &image); } else { image.Reset(Engine::LoadImageResource(buffer)); }
 		for (int index = 0; index < visibleDepth_; index++)
 		{
 			char buffer[0x100];
 			
 			sprintf(buffer, "%sf%d.png", rootPath, index);
-			frontImages_[index] = Engine::LoadImageResource(buffer);
+			_TMP_LOADIMG(frontImages_[index])
 			
 			sprintf(buffer, "%sl%d.png", rootPath, index);
-			leftImages_[index] = Engine::LoadImageResource(buffer);
+			_TMP_LOADIMG(leftImages_[index])
 			
 			sprintf(buffer, "%sr%d.png", rootPath, index);
-			rightImages_[index] = Engine::LoadImageResource(buffer);
+			_TMP_LOADIMG(rightImages_[index])
 		}
+		#undef _TMP_LOADIMG
 	}
 	
 	////////////////////////////////////////////////////////////////////////////
 
 	WallSpriteSet::~WallSpriteSet()
 	{
-		// free images
-		#define _TMP_DELOBJ(object) if (object[index]) { Engine::UnloadImageResource(object[index]); }
-		for (int index = 0; index < visibleDepth_; index++)
-		{
-			_TMP_DELOBJ(frontImages_)
-			_TMP_DELOBJ(leftImages_)
-			_TMP_DELOBJ(rightImages_)
-		}
-		#undef _TMP_DELOBJ
-		
-		// free allocated arrays
+		// free allocated arrays, the handles let go of their images
 		#define _TMP_DELOBJ(object) if (object) { delete [] object; object = 0; }
 		
 		_TMP_DELOBJ(frontImages_)
@@ -66,23 +176,186 @@ namespace LOFI
 	
 	////////////////////////////////////////////////////////////////////////////
 
+	void WallSpriteSet::FinishLoading()
+	{
+		SDL_Surface* sheet = sheet_.Get();
+		if (!sheet)
+		{
+			return;
+		}
+		
+		std::string sheetPath = definition_.GetSheetPath();
+		
+		for (int index = 0; index < visibleDepth_; index++)
+		{
+			frontImages_[index].Reset(WallSpriteSet::CutImage(sheet, sheetPath, definition_.frontRects_[index]));
+			leftImages_[index].Reset(WallSpriteSet::CutImage(sheet, sheetPath, definition_.leftRects_[index]));
+			rightImages_[index].Reset(WallSpriteSet::CutImage(sheet, sheetPath, definition_.rightRects_[index]));
+		}
+		
+		// the images hold their own pixels, so the sheet can go
+		sheet_.Reset();
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* WallSpriteSet::GenerateSheet(const char* sheetPath, const void* userData)
+	{
+		const WallSetDefinition* definition = static_cast<const WallSetDefinition*>(userData);
+		
+		SDL_Surface* texture = Engine::DecodeImageResource(definition->texturePath_.c_str());
+		if (!texture)
+		{
+			return 0;
+		}
+		
+		// the sheet is as big as the rectangles laid out on it
+		int sheetWidth = 1;
+		int sheetHeight = 1;
+		for (int index = 0; index < definition->visibleDepth_; index++)
+		{
+			const WallImageRect* rects[3] = { &definition->frontRects_[index], &definition->leftRects_[index], &definition->rightRects_[index] };
+			for (int piece = 0; piece < 3; piece++)
+			{
+				sheetWidth = std::max(sheetWidth, rects[piece]->x_ + rects[piece]->w_);
+				sheetHeight = std::max(sheetHeight, rects[piece]->y_ + rects[piece]->h_);
+			}
+		}
+		
+		SDL_Surface* sheet = SDL_CreateRGBSurface(SDL_SWSURFACE, sheetWidth, sheetHeight, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+		if (!sheet)
+		{
+			SDL_FreeSurface(texture);
+			return 0;
+		}
+		
+		SDL_FillRect(sheet, 0, GENERATED_TRANSPARENT);
+		
+		if (SDL_MUSTLOCK(texture))
+		{
+			SDL_LockSurface(texture);
+		}
+		
+		for (int index = 0; index < definition->visibleDepth_; index++)
+		{
+			const WallImageRect& front = definition->frontRects_[index];
+			
+			WarpFrontImage(sheet, texture, front);
+			WarpSideImage(sheet, texture, definition->leftRects_[index], front.h_, true);
+			WarpSideImage(sheet, texture, definition->rightRects_[index], front.h_, false);
+		}
+		
+		if (SDL_MUSTLOCK(texture))
+		{
+			SDL_UnlockSurface(texture);
+		}
+		
+		SDL_FreeSurface(texture);
+		
+		// keyed the same way the decoder keys a PNG
+		SDL_SetColorKey(sheet, (SDL_SRCCOLORKEY | SDL_RLEACCEL), GENERATED_TRANSPARENT);
+		
+		return sheet;
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	SDL_Surface* WallSpriteSet::CutImage(SDL_Surface* sheet, const std::string& sheetPath, const WallImageRect& rect)
+	{
+		if (rect.w_ <= 0 || rect.h_ <= 0 || rect.x_ < 0 || rect.y_ < 0 ||
+			rect.x_ + rect.w_ > sheet->w || rect.y_ + rect.h_ > sheet->h)
+		{
+			// log the error
+			WriteLog(stderr, "The rectangle %d,%d %dx%d is not on the sheet \"%s\"!\n", rect.x_, rect.y_, rect.w_, rect.h_, sheetPath.c_str());
+			return 0;
+		}
+		
+		// each piece is cached under the sheet's path and its rectangle, so sets sharing a sheet share the pieces too
+		char cachePath[0x200];
+		snprintf(cachePath, sizeof(cachePath), "%s#%d,%d,%d,%d", sheetPath.c_str(), rect.x_, rect.y_, rect.w_, rect.h_);
+		
+		SDL_Surface* image = ResourceCache::AcquireCached(cachePath);
+		if (image)
+		{
+			return image;
+		}
+		
+		const SDL_PixelFormat* format = sheet->format;
+		
+		image = SDL_CreateRGBSurface(SDL_SWSURFACE, rect.w_, rect.h_, format->BitsPerPixel,
+			format->Rmask, format->Gmask, format->Bmask, format->Amask);
+		
+		if (!image)
+		{
+			return 0;
+		}
+		
+		// a copy of the raw pixels, so the transparent ones stay transparent
+		if (SDL_MUSTLOCK(sheet))
+		{
+			SDL_LockSurface(sheet);
+		}
+		
+		unsigned int rowBytes = rect.w_ * format->BytesPerPixel;
+		
+		for (int row = 0; row < rect.h_; row++)
+		{
+			memcpy(
+				static_cast<unsigned char*>(image->pixels) + row * image->pitch,
+				static_cast<unsigned char*>(sheet->pixels) + (rect.y_ + row) * sheet->pitch + rect.x_ * format->BytesPerPixel,
+				rowBytes);
+		}
+		
+		if (SDL_MUSTLOCK(sheet))
+		{
+			SDL_UnlockSurface(sheet);
+		}
+		
+		if (sheet->flags & SDL_SRCCOLORKEY)
+		{
+			SDL_SetColorKey(image, (SDL_SRCCOLORKEY | SDL_RLEACCEL), format->colorkey);
+		}
+		
+		return ResourceCache::Insert(cachePath, image);
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
 	SDL_Surface* WallSpriteSet::GetFrontImage(int range)
 	{
-		return (range > visibleDepth_) ? 0 : frontImages_[range];
+		return (range < 0 || range >= visibleDepth_) ? 0 : frontImages_[range].Get();
 	}
 	
 	////////////////////////////////////////////////////////////////////////////
 
 	SDL_Surface* WallSpriteSet::GetLeftImage(int range)
 	{
-		return (range > visibleDepth_) ? 0 : leftImages_[range];
+		return (range < 0 || range >= visibleDepth_) ? 0 : leftImages_[range].Get();
 	}
 	
 	////////////////////////////////////////////////////////////////////////////
 
 	SDL_Surface* WallSpriteSet::GetRightImage(int range)
 	{
-		return (range > visibleDepth_) ? 0 : rightImages_[range];
+		return (range < 0 || range >= visibleDepth_) ? 0 : rightImages_[range].Get();
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+
+	unsigned long WallSpriteSet::GetMemoryBytes() const
+	{
+		unsigned long bytes = 0;
+		
+		#define _TMP_ADDBYTES(image) if (image.Get()) { bytes += static_cast<unsigned long>(image.Get()->pitch) * image.Get()->h; }
+		for (int index = 0; index < visibleDepth_; index++)
+		{
+			_TMP_ADDBYTES(frontImages_[index])
+			_TMP_ADDBYTES(leftImages_[index])
+			_TMP_ADDBYTES(rightImages_[index])
+		}
+		#undef _TMP_ADDBYTES
+		
+		return bytes;
 	}
 } // end namespace
 
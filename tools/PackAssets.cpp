@@ -0,0 +1,352 @@
+
+// CODESTYLE: v2.0
+
+// PackAssets.cpp
+// Project: C++ SDL Port of Scrim's LoFiWanderings Game Project (LOFI)
+// Author: Richard Marks
+// Purpose: Asset Packer Program Entry Point
+
+/**
+ * @file PackAssets.cpp
+ * @brief Asset Packer Program Entry Point
+ * @author Richard Marks <ccpsceo@gmail.com>
+ *
+ * Packs every file under a directory into one asset archive that the engine maps
+ * into memory at start-up. With --pixels, PNG images are decoded here and stored
+ * as raw pixels, trading a bigger archive for no PNG decoding at start-up.
+ *
+ * Usage: PackAssets [--pixels] <directory> <archive>
+ */
+
+#include "lwc.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <dirent.h>
+	#include <sys/stat.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+// a file to be packed
+struct PackedFile
+{
+	std::string path_;
+	std::vector<unsigned char> data_;
+	LOFI::AssetArchiveEntry entry_;
+};
+
+bool ListFiles(const std::string& directory, std::vector<std::string>* filePaths);
+bool ReadWholeFile(const std::string& filePath, std::vector<unsigned char>* data);
+bool DecodePixels(PackedFile* file);
+bool WriteArchive(const char* archivePath, std::vector<PackedFile>& files);
+void WriteUint32(std::vector<unsigned char>* output, unsigned int value);
+bool IsImagePath(const std::string& filePath);
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+	bool storePixels = false;
+	int argument = 1;
+
+	if (argument < argc && 0 == strcmp(argv[argument], "--pixels"))
+	{
+		storePixels = true;
+		argument++;
+	}
+
+	if (argc - argument != 2)
+	{
+		WriteLog(stderr, "Usage: %s [--pixels] <directory> <archive>\n", argv[0]);
+		return 1;
+	}
+
+	// keep the directory as given, since that is the prefix the engine asks for files by
+	std::string directory(argv[argument]);
+	while (directory.size() > 1 && '/' == directory[directory.size() - 1])
+	{
+		directory.erase(directory.size() - 1);
+	}
+
+	std::vector<std::string> filePaths;
+	if (!ListFiles(directory, &filePaths))
+	{
+		WriteLog(stderr, "Unable to read the directory \"%s\"!\n", directory.c_str());
+		return 1;
+	}
+
+	// the index has to be sorted for the engine's binary search
+	std::sort(filePaths.begin(), filePaths.end());
+
+	std::vector<PackedFile> files(filePaths.size());
+
+	for (unsigned int index = 0; index < filePaths.size(); index++)
+	{
+		PackedFile& file = files[index];
+		file.path_ = filePaths[index];
+		memset(&file.entry_, 0, sizeof(file.entry_));
+		file.entry_.encoding_ = LOFI::ASSETARCHIVE_ENCODING_FILE;
+
+		if (!ReadWholeFile(file.path_, &file.data_))
+		{
+			WriteLog(stderr, "Unable to read \"%s\"!\n", file.path_.c_str());
+			return 1;
+		}
+
+		if (storePixels && IsImagePath(file.path_) && !DecodePixels(&file))
+		{
+			WriteLog(stderr, "Unable to decode \"%s\"!\n\tSDL_image Error: %s\n", file.path_.c_str(), IMG_GetError());
+			return 1;
+		}
+	}
+
+	if (!WriteArchive(argv[argument + 1], files))
+	{
+		WriteLog(stderr, "Unable to write \"%s\"!\n", argv[argument + 1]);
+		return 1;
+	}
+
+	WriteLog(stdout, "Packed %u files into \"%s\".\n", static_cast<unsigned int>(files.size()), argv[argument + 1]);
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ListFiles(const std::string& directory, std::vector<std::string>* filePaths)
+{
+	#if defined(_WIN32)
+
+	WIN32_FIND_DATAA found;
+	HANDLE search = FindFirstFileA((directory + "/*").c_str(), &found);
+	if (INVALID_HANDLE_VALUE == search)
+	{
+		return false;
+	}
+
+	bool succeeded = true;
+	do
+	{
+		std::string name(found.cFileName);
+		if ("." == name || ".." == name)
+		{
+			continue;
+		}
+
+		std::string path = directory + "/" + name;
+		if (found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			succeeded = ListFiles(path, filePaths) && succeeded;
+		}
+		else
+		{
+			filePaths->push_back(path);
+		}
+	} while (FindNextFileA(search, &found));
+
+	FindClose(search);
+	return succeeded;
+
+	#else
+
+	DIR* dir = opendir(directory.c_str());
+	if (!dir)
+	{
+		return false;
+	}
+
+	bool succeeded = true;
+	for (struct dirent* found = readdir(dir); found; found = readdir(dir))
+	{
+		std::string name(found->d_name);
+		if ("." == name || ".." == name)
+		{
+			continue;
+		}
+
+		std::string path = directory + "/" + name;
+
+		struct stat fileInfo;
+		if (0 != stat(path.c_str(), &fileInfo))
+		{
+			succeeded = false;
+		}
+		else if (S_ISDIR(fileInfo.st_mode))
+		{
+			succeeded = ListFiles(path, filePaths) && succeeded;
+		}
+		else if (S_ISREG(fileInfo.st_mode))
+		{
+			filePaths->push_back(path);
+		}
+	}
+
+	closedir(dir);
+	return succeeded;
+
+	#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ReadWholeFile(const std::string& filePath, std::vector<unsigned char>* data)
+{
+	FILE* fp = fopen(filePath.c_str(), "rb");
+	if (!fp)
+	{
+		return false;
+	}
+
+	unsigned char buffer[0x1000];
+	size_t bytesRead;
+	while ((bytesRead = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+	{
+		data->insert(data->end(), buffer, buffer + bytesRead);
+	}
+
+	bool succeeded = !ferror(fp);
+	fclose(fp);
+
+	return succeeded;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool DecodePixels(PackedFile* file)
+{
+	if (file->data_.empty())
+	{
+		return false;
+	}
+
+	SDL_Surface* image = IMG_Load_RW(SDL_RWFromConstMem(&file->data_[0], static_cast<int>(file->data_.size())), 1);
+	if (!image)
+	{
+		return false;
+	}
+
+	// the archive has no room for a palette, so paletted images stay as PNG files
+	if (image->format->palette)
+	{
+		SDL_FreeSurface(image);
+		return true;
+	}
+
+	// keep the decoder's own pixel format so the engine converts it exactly as it would the PNG
+	unsigned int rowBytes = image->w * image->format->BytesPerPixel;
+
+	file->data_.resize(rowBytes * image->h);
+
+	if (SDL_MUSTLOCK(image))
+	{
+		SDL_LockSurface(image);
+	}
+
+	for (int row = 0; row < image->h; row++)
+	{
+		memcpy(&file->data_[row * rowBytes], static_cast<unsigned char*>(image->pixels) + row * image->pitch, rowBytes);
+	}
+
+	if (SDL_MUSTLOCK(image))
+	{
+		SDL_UnlockSurface(image);
+	}
+
+	file->entry_.encoding_ 		= LOFI::ASSETARCHIVE_ENCODING_PIXELS;
+	file->entry_.width_ 		= image->w;
+	file->entry_.height_ 		= image->h;
+	file->entry_.bitsPerPixel_ 	= image->format->BitsPerPixel;
+	file->entry_.redMask_ 		= image->format->Rmask;
+	file->entry_.greenMask_ 	= image->format->Gmask;
+	file->entry_.blueMask_ 		= image->format->Bmask;
+	file->entry_.alphaMask_ 	= image->format->Amask;
+
+	SDL_FreeSurface(image);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool WriteArchive(const char* archivePath, std::vector<PackedFile>& files)
+{
+	// the layout is: header, paths, blobs (each aligned), index
+	std::vector<unsigned char> output;
+	output.resize(LOFI::ASSETARCHIVE_HEADER_SIZE);
+
+	for (unsigned int index = 0; index < files.size(); index++)
+	{
+		files[index].entry_.pathOffset_ = static_cast<unsigned int>(output.size());
+		files[index].entry_.pathLength_ = static_cast<unsigned int>(files[index].path_.size());
+		output.insert(output.end(), files[index].path_.begin(), files[index].path_.end());
+	}
+
+	for (unsigned int index = 0; index < files.size(); index++)
+	{
+		output.resize((output.size() + LOFI::ASSETARCHIVE_ALIGNMENT - 1) & ~(LOFI::ASSETARCHIVE_ALIGNMENT - 1));
+
+		files[index].entry_.dataOffset_ = static_cast<unsigned int>(output.size());
+		files[index].entry_.dataSize_ = static_cast<unsigned int>(files[index].data_.size());
+		output.insert(output.end(), files[index].data_.begin(), files[index].data_.end());
+	}
+
+	output.resize((output.size() + LOFI::ASSETARCHIVE_ALIGNMENT - 1) & ~(LOFI::ASSETARCHIVE_ALIGNMENT - 1));
+	unsigned int indexOffset = static_cast<unsigned int>(output.size());
+
+	for (unsigned int index = 0; index < files.size(); index++)
+	{
+		const LOFI::AssetArchiveEntry& entry = files[index].entry_;
+
+		WriteUint32(&output, entry.pathOffset_);
+		WriteUint32(&output, entry.pathLength_);
+		WriteUint32(&output, entry.dataOffset_);
+		WriteUint32(&output, entry.dataSize_);
+		WriteUint32(&output, entry.encoding_);
+		WriteUint32(&output, entry.width_);
+		WriteUint32(&output, entry.height_);
+		WriteUint32(&output, entry.bitsPerPixel_);
+		WriteUint32(&output, entry.redMask_);
+		WriteUint32(&output, entry.greenMask_);
+		WriteUint32(&output, entry.blueMask_);
+		WriteUint32(&output, entry.alphaMask_);
+	}
+
+	// now that everything is placed, fill in the header
+	std::vector<unsigned char> header;
+	header.insert(header.end(), ASSETARCHIVE_MAGIC, ASSETARCHIVE_MAGIC + 4);
+	WriteUint32(&header, LOFI::ASSETARCHIVE_VERSION);
+	WriteUint32(&header, static_cast<unsigned int>(files.size()));
+	WriteUint32(&header, indexOffset);
+	std::copy(header.begin(), header.end(), output.begin());
+
+	FILE* fp = fopen(archivePath, "wb");
+	if (!fp)
+	{
+		return false;
+	}
+
+	bool succeeded = (output.size() == fwrite(&output[0], 1, output.size(), fp));
+	succeeded = (0 == fclose(fp)) && succeeded;
+
+	return succeeded;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WriteUint32(std::vector<unsigned char>* output, unsigned int value)
+{
+	output->push_back(static_cast<unsigned char>(value));
+	output->push_back(static_cast<unsigned char>(value >> 8));
+	output->push_back(static_cast<unsigned char>(value >> 16));
+	output->push_back(static_cast<unsigned char>(value >> 24));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool IsImagePath(const std::string& filePath)
+{
+	return filePath.size() > 4 && 0 == strcmp(filePath.c_str() + filePath.size() - 4, ".png");
+}
+